@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t PORT = 12000;
+constexpr int PACKETS = 200000;
+constexpr size_t PAYLOAD = 128;
+
+void put16(std::vector<uint8_t>& out, uint16_t v) { out.insert(out.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 2); }
+void put32(std::vector<uint8_t>& out, uint32_t v) { out.insert(out.end(), reinterpret_cast<uint8_t*>(&v), reinterpret_cast<uint8_t*>(&v) + 4); }
+
+// Frame layouts of the flow benchmark
+enum Shape { IPV4, IPV4_GROUPS, IPV6_GROUPS, QINQ_GROUPS };
+constexpr int GROUPS = 4;
+
+// Ethernet/UDP frame of PAYLOAD bytes to PORT; the *_GROUPS shapes send to
+// one of GROUPS multicast groups (239.0.0.g or ff15::g)
+std::vector<uint8_t> makeFrame(Shape shape, int group) {
+    std::vector<uint8_t> frame(12, 0);
+    if (shape == QINQ_GROUPS) {
+        const uint8_t tags[8] = {0x88, 0xa8, 0x00, 0x0a, 0x81, 0x00, 0x00, 0x0b};
+        frame.insert(frame.end(), tags, tags + 8);
+    }
+    const bool v6 = shape == IPV6_GROUPS;
+    frame.push_back(v6 ? 0x86 : 0x08);
+    frame.push_back(v6 ? 0xdd : 0x00);
+
+    const size_t ip = frame.size();
+    const size_t udp = ip + (v6 ? 40 : 20);
+    frame.resize(udp + 8 + PAYLOAD, 0);
+    if (v6) {
+        frame[ip] = 0x60;
+        const uint16_t plen = htons(static_cast<uint16_t>(8 + PAYLOAD));
+        std::memcpy(&frame[ip + 4], &plen, 2);
+        frame[ip + 6] = 17;
+        frame[ip + 7] = 64;
+        frame[ip + 24] = 0xff;
+        frame[ip + 25] = 0x15;
+        frame[ip + 39] = static_cast<uint8_t>(group);
+    } else {
+        frame[ip] = 0x45;
+        const uint16_t ipLen = htons(static_cast<uint16_t>(28 + PAYLOAD));
+        std::memcpy(&frame[ip + 2], &ipLen, 2);
+        frame[ip + 8] = 64;
+        frame[ip + 9] = 17;
+        frame[ip + 16] = 239;
+        frame[ip + 19] = static_cast<uint8_t>(group);
+    }
+    const uint16_t dport = htons(PORT);
+    const uint16_t udpLen = htons(static_cast<uint16_t>(8 + PAYLOAD));
+    std::memcpy(&frame[udp + 2], &dport, 2);
+    std::memcpy(&frame[udp + 4], &udpLen, 2);
+    return frame;
+}
+
+// Capture of PACKETS datagrams to PORT, 10us apart, cycling over the groups
+std::string captureFile(bool pcapng, Shape shape = IPV4) {
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp ? tmp : "/tmp") + (pcapng ? "/atu_bench.pcapng" : "/atu_bench.pcap");
+
+    std::vector<uint8_t> frames[GROUPS];
+    for (int g = 0; g < GROUPS; ++g) {
+        frames[g] = makeFrame(shape, shape == IPV4 ? 0 : g);
+    }
+
+    std::vector<uint8_t> out;
+    if (pcapng) {
+        put32(out, MAGIC_PCAPNG_SHB); put32(out, 28); put32(out, PCAPNG_BOM);
+        put16(out, 1); put16(out, 0); put32(out, 0xFFFFFFFF); put32(out, 0xFFFFFFFF); put32(out, 28);
+        put32(out, PCAPNG_IDB); put32(out, 20); put16(out, 1); put16(out, 0); put32(out, 65535); put32(out, 20);
+    } else {
+        put32(out, MAGIC_MICRO_BE); put16(out, 2); put16(out, 4);
+        put32(out, 0); put32(out, 0); put32(out, 65535); put32(out, 1);
+    }
+
+    for (int i = 0; i < PACKETS; ++i) {
+        const std::vector<uint8_t>& frame = frames[i % GROUPS];
+        const auto caplen = static_cast<uint32_t>(frame.size());
+        const uint32_t padded = (caplen + 3) & ~3u;
+        const uint64_t usec = 1000000ULL + static_cast<uint64_t>(i) * 10;
+        if (pcapng) {
+            put32(out, PCAPNG_EPB); put32(out, 32 + padded);
+            put32(out, 0); put32(out, static_cast<uint32_t>(usec >> 32)); put32(out, static_cast<uint32_t>(usec));
+            put32(out, caplen); put32(out, caplen);
+            out.insert(out.end(), frame.begin(), frame.end());
+            out.resize(out.size() + (padded - caplen), 0);
+            put32(out, 32 + padded);
+        } else {
+            put32(out, static_cast<uint32_t>(usec / 1000000)); put32(out, static_cast<uint32_t>(usec % 1000000));
+            put32(out, caplen); put32(out, caplen);
+            out.insert(out.end(), frame.begin(), frame.end());
+        }
+    }
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return {};
+    const bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok ? path : std::string();
+}
+
+struct Sink {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    std::chrono::steady_clock::time_point first;
+
+    static void onBatch(void* context, int count, const PacketMetadata* packets, const uint8_t*, size_t) {
+        auto* self = static_cast<Sink*>(context);
+        if (self->packets == 0) self->first = std::chrono::steady_clock::now();
+        self->packets += static_cast<uint64_t>(count);
+        for (int i = 0; i < count; ++i) {
+            self->bytes += packets[i].len;
+        }
+    }
+};
+
+// FLOOD replay of the whole capture, timed from the first delivered batch
+// (start() schedules the first batch on the next timer tick)
+void BM_PcapFlood(benchmark::State& state) {
+    const bool pcapng = state.range(0) != 0;
+    const std::string path = captureFile(pcapng);
+    if (path.empty()) {
+        state.SkipWithError("cannot write capture");
+        return;
+    }
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::FLOOD;
+    PcapReceiver reader(loop, config);
+    Sink sink;
+    if (!reader.open(path) || !reader.subscribeBatch(PORT, &sink, &Sink::onBatch)) {
+        state.SkipWithError("cannot open capture");
+        std::remove(path.c_str());
+        return;
+    }
+
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        sink.packets = 0;
+        sink.bytes = 0;
+        reader.rewind();
+        reader.start();
+        while (!reader.isFinished()) {
+            (void)loop.runOnce(0);
+        }
+        state.SetIterationTime(std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - sink.first).count());
+        packets += sink.packets;
+        bytes += sink.bytes;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(packets));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_PcapFlood)
+    ->ArgName("pcapng")->Arg(0)->Arg(1)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Same FLOOD replay with one flow subscription per multicast group, against
+// the port-wide baseline (shape IPV4): address matching, IPv6 and QinQ framing
+void BM_PcapFloodFlows(benchmark::State& state) {
+    const auto shape = static_cast<Shape>(state.range(0));
+    const std::string path = captureFile(false, shape);
+    if (path.empty()) {
+        state.SkipWithError("cannot write capture");
+        return;
+    }
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::FLOOD;
+    PcapReceiver reader(loop, config);
+    Sink sinks[GROUPS];
+    bool ok = reader.open(path).has_value();
+    for (int g = 0; ok && g < GROUPS; ++g) {
+        if (shape == IPV4) {
+            ok = g > 0 || reader.subscribeBatch(PORT, &sinks[0], &Sink::onBatch).has_value();
+            continue;
+        }
+        const std::string group = shape == IPV6_GROUPS
+            ? "ff15::" + std::to_string(g)
+            : "239.0.0." + std::to_string(g);
+        ok = reader.subscribeFlowBatch({PORT, group, ""}, &sinks[g], &Sink::onBatch).has_value();
+    }
+    if (!ok) {
+        state.SkipWithError("cannot open capture");
+        std::remove(path.c_str());
+        return;
+    }
+
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    for (auto _ : state) {
+        for (auto& sink : sinks) sink = Sink{};
+        reader.rewind();
+        reader.start();
+        while (!reader.isFinished()) {
+            (void)loop.runOnce(0);
+        }
+        state.SetIterationTime(std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - sinks[0].first).count());
+        for (const auto& sink : sinks) {
+            packets += sink.packets;
+            bytes += sink.bytes;
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(packets));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_PcapFloodFlows)
+    ->ArgName("shape")->Arg(IPV4)->Arg(IPV4_GROUPS)->Arg(IPV6_GROUPS)->Arg(QINQ_GROUPS)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/StaticUDPReceiver.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr size_t PAYLOAD = 256;     // Market-data sized datagrams
+
+struct Counter {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+
+    static void onBatch(void* context, int count, const PacketMetadata* packets, const uint8_t*, size_t) {
+        auto* self = static_cast<Counter*>(context);
+        self->packets += static_cast<uint64_t>(count);
+        for (int i = 0; i < count; ++i) {
+            self->bytes += packets[i].len;
+        }
+    }
+};
+
+// Connected sender bursting count datagrams per sendmmsg
+class LoopbackSender {
+    public:
+        LoopbackSender(int port, size_t count) : m_payload(PAYLOAD, 0x5A), m_iov(count), m_msgs(count) {
+            m_sock = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+            struct sockaddr_in dest{};
+            dest.sin_family = AF_INET;
+            dest.sin_port = htons(static_cast<uint16_t>(port));
+            inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+            m_ok = m_sock >= 0 && ::connect(m_sock, reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) == 0;
+
+            for (size_t i = 0; i < count; ++i) {
+                m_iov[i] = {m_payload.data(), m_payload.size()};
+                m_msgs[i] = {};
+                m_msgs[i].msg_hdr.msg_iov = &m_iov[i];
+                m_msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+        }
+        ~LoopbackSender() { if (m_sock >= 0) ::close(m_sock); }
+
+        bool ok() const { return m_ok; }
+
+        uint64_t burst() {
+            int n = ::sendmmsg(m_sock, m_msgs.data(), static_cast<unsigned>(m_msgs.size()), 0);
+            return n > 0 ? static_cast<uint64_t>(n) : 0;
+        }
+
+    private:
+        int m_sock = -1;
+        bool m_ok = false;
+        std::vector<uint8_t> m_payload;
+        std::vector<struct iovec> m_iov;
+        std::vector<struct mmsghdr> m_msgs;
+};
+
+// One sendmmsg burst of batch packets per iteration, drained with runOnce(0)
+template <typename Counted>
+void runLoopback(benchmark::State& state, EventLoop& loop, LoopbackSender& sender, const Counted& counter) {
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        sent += sender.burst();
+        for (int spin = 0; spin < 1000 && counter.packets < sent; ++spin) {
+            (void)loop.runOnce(0);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(counter.packets));
+    state.SetBytesProcessed(static_cast<int64_t>(counter.bytes));
+    state.counters["dropped"] = static_cast<double>(sent - counter.packets);
+}
+
+// Loopback datagrams through UDPReceiver::handleReadBatch
+void BM_RecvmmsgLoopback(benchmark::State& state) {
+    ReceiverConfig config;
+    config.batchSize = static_cast<int>(state.range(0));
+    config.bufferSize = static_cast<int>(state.range(1));
+
+    EventLoop loop;
+    UDPReceiver receiver(loop, config);
+    Counter counter;
+    SubscribeOptions options;
+    options.rcvbuf = 8 * 1024 * 1024;
+    auto port = receiver.subscribeBatch(0, options, &counter, &Counter::onBatch);
+    if (!port) {
+        state.SkipWithError("subscribe failed");
+        return;
+    }
+
+    LoopbackSender sender(port.value(), static_cast<size_t>(config.batchSize));
+    if (!sender.ok()) {
+        state.SkipWithError("loopback socket failed");
+        return;
+    }
+    runLoopback(state, loop, sender, counter);
+}
+BENCHMARK(BM_RecvmmsgLoopback)
+    ->ArgNames({"batch", "buffer"})
+    ->ArgsProduct({{8, 64, 256}, {512, 2048, 9216}});
+
+// The same traffic through StaticUDPReceiver: read loop and handler inlined
+struct StaticCounter {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+};
+
+struct CountPacket {
+    StaticCounter* counter;
+    void operator()(const PacketMetadata& pkt) const {
+        counter->packets++;
+        counter->bytes += pkt.len;
+    }
+};
+
+template <int BatchSize, int BufferSize>
+void BM_StaticRecvmmsgLoopback(benchmark::State& state) {
+    EventLoop loop;
+    StaticCounter counter;
+    StaticUDPReceiver<CountPacket, StaticReceiverConfig<BatchSize, BufferSize>> receiver(loop, CountPacket{&counter});
+    SubscribeOptions options;
+    options.rcvbuf = 8 * 1024 * 1024;
+    auto port = receiver.subscribe(0, options);
+    if (!port) {
+        state.SkipWithError("subscribe failed");
+        return;
+    }
+
+    LoopbackSender sender(port.value(), BatchSize);
+    if (!sender.ok()) {
+        state.SkipWithError("loopback socket failed");
+        return;
+    }
+    runLoopback(state, loop, sender, counter);
+}
+BENCHMARK_TEMPLATE(BM_StaticRecvmmsgLoopback, 8, 512);
+BENCHMARK_TEMPLATE(BM_StaticRecvmmsgLoopback, 64, 2048);
+BENCHMARK_TEMPLATE(BM_StaticRecvmmsgLoopback, 256, 9216);
+
+// Random cache-line reads over a packet buffer: the TLB cost MAP_HUGETLB removes
+void BM_BufferPages(benchmark::State& state) {
+    const bool huge = state.range(0) != 0;
+    const size_t size = static_cast<size_t>(state.range(1)) << 20;
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (huge) flags |= MAP_HUGETLB;
+    void* mem = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (mem == MAP_FAILED) {
+        state.SkipWithError(huge ? "no hugepages reserved (vm.nr_hugepages)" : "mmap failed");
+        return;
+    }
+    auto* buf = static_cast<uint8_t*>(mem);
+    std::memset(buf, 1, size);
+
+    constexpr int ACCESSES = 4096;
+    const uint64_t lines = size / 64;
+    uint64_t x = 88172645463325252ULL;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < ACCESSES; ++i) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            sum += buf[(x % lines) * 64];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * ACCESSES);
+    ::munmap(mem, size);
+}
+BENCHMARK(BM_BufferPages)
+    ->ArgNames({"huge", "MB"})
+    ->ArgsProduct({{0, 1}, {4, 64, 512}});
+
+} // namespace
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
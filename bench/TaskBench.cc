@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atu_reactor/EventLoop.h>
+#include <cstdint>
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr int TASKS = 1024;
+
+void bump(void* context) {
+    ++*static_cast<uint64_t*>(context);
+}
+
+// Inline-stored lambdas, drained by one runOnce
+void BM_RunInLoopLambda(benchmark::State& state) {
+    EventLoop loop;
+    uint64_t count = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TASKS; ++i) {
+            loop.runInLoop([&count]() { ++count; });
+        }
+        (void)loop.runOnce(0);
+    }
+
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * TASKS);
+}
+BENCHMARK(BM_RunInLoopLambda);
+
+// The void(*)(void*) + context form
+void BM_RunInLoopFunction(benchmark::State& state) {
+    EventLoop loop;
+    uint64_t count = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TASKS; ++i) {
+            loop.runInLoop(&bump, &count);
+        }
+        (void)loop.runOnce(0);
+    }
+
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * TASKS);
+}
+BENCHMARK(BM_RunInLoopFunction);
+
+// Same-thread post: the MPSC queue plus the coalesced eventfd wakeup
+void BM_Post(benchmark::State& state) {
+    EventLoop loop;
+    uint64_t count = 0;
+
+    for (auto _ : state) {
+        for (int i = 0; i < TASKS; ++i) {
+            loop.post(&bump, &count);
+        }
+        (void)loop.runOnce(0);
+    }
+
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * TASKS);
+}
+BENCHMARK(BM_Post);
+
+} // namespace
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
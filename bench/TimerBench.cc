@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atu_reactor/EventLoop.h>
+#include <chrono>
+#include <vector>
+
+using namespace atu_reactor;
+
+namespace {
+
+// n timers spread over the wheel levels, then all cancelled
+void BM_TimerInsertCancel(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    EventLoop loop;
+    std::vector<TimerId> ids;
+    ids.reserve(n);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; ++i) {
+            auto id = loop.runAfter(Duration(1 + static_cast<int64_t>(i % 100000)), []() {});
+            ids.push_back(id.value());
+        }
+        for (TimerId id : ids) {
+            (void)loop.cancelTimer(id);
+        }
+        ids.clear();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * 2));
+}
+BENCHMARK(BM_TimerInsertCancel)
+    ->RangeMultiplier(10)->Range(10000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// n timers due on the same tick: dispatch cost, timed from the first callback
+void BM_TimerExpire(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    EventLoop loop;
+    size_t fired = 0;
+    std::chrono::steady_clock::time_point first;
+
+    for (auto _ : state) {
+        fired = 0;
+        for (size_t i = 0; i < n; ++i) {
+            (void)loop.runAfter(Duration(1), [&fired, &first]() {
+                if (fired++ == 0) first = std::chrono::steady_clock::now();
+            });
+        }
+        while (fired < n) {
+            (void)loop.runOnce(10);
+        }
+        state.SetIterationTime(std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - first).count());
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_TimerExpire)
+    ->RangeMultiplier(10)->Range(10000, 1000000)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -20,6 +20,7 @@
 #include <iostream>
 #include <unistd.h>
 #include <iomanip>
+#include <cmath>
 
 using namespace atu_reactor;
 
@@ -42,15 +43,23 @@ int main(int argc, char** argv) {
     bool floodMode = false;
     int iterations = 1;
     uint16_t targetPort = 5001; // Default port
+    double seekTo = -1.0;
+    unsigned workers = 0;
     ReplayContext replayCtx;
     int opt;
 
-    // Parse options: -f for flood, -n for number of iterations, -p for port, -q for quiet
-    while ((opt = getopt(argc, argv, "fn:p:q")) != -1) {
+    // Parse options: -f for flood, -n for number of iterations, -p for port, -q for quiet,
+    // -s to start at a capture time (epoch seconds) through the timestamp index,
+    // -j to FLOOD on N threads (order is then kept per port only)
+    while ((opt = getopt(argc, argv, "fj:n:p:qs:")) != -1) {
         switch (opt) {
             case 'f':
                 floodMode = true;
                 break;
+            case 'j':
+                workers = static_cast<unsigned>(std::atoi(optarg));
+                floodMode = true;
+                break;
             case 'n':
                 iterations = std::atoi(optarg);
                 break;
@@ -60,8 +69,11 @@ int main(int argc, char** argv) {
             case 'q':
                 replayCtx.quiet = true;
                 break;
+            case 's':
+                seekTo = std::atof(optarg);
+                break;
             default:
-                std::cerr << "Usage: " << argv[0] << " [-f] [-n iterations] [-p port] <file.pcap>" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [-f] [-j workers] [-n iterations] [-p port] [-s epoch] <file.pcap>" << std::endl;
                 return 1;
         }
     }
@@ -96,8 +108,33 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    if (seekTo >= 0) {
+        if (auto idx = player.loadIndex(); !idx) {
+            std::cerr << "Failed to load index: " << idx.error().message() << std::endl;
+            return 1;
+        }
+    }
+
     for (int i = 0; i < iterations; ++i) {
-        player.rewind();
+        if (workers > 0) {
+            if (auto n = player.floodParallel(workers); !n) {
+                std::cerr << "Parallel replay failed: " << n.error().message() << std::endl;
+                return 1;
+            }
+            continue;
+        }
+
+        if (seekTo >= 0) {
+            double whole;
+            const double frac = std::modf(seekTo, &whole);
+            struct timespec ts = {static_cast<time_t>(whole), static_cast<long>(frac * 1e9)};
+            if (auto pos = player.seek(ts); !pos) {
+                std::cerr << "Nothing to replay after " << seekTo << std::endl;
+                return 1;
+            }
+        } else {
+            player.rewind();
+        }
         player.start();
 
         // Run loop
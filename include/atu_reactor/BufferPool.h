@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/Export.h>
+
+namespace atu_reactor {
+
+class BufferPool;
+
+/**
+ * @class PacketLease
+ * @brief Move-only reference to a payload held in a BufferPool slot.
+ * The slot is not reused by the receiver while any lease on it is alive.
+ * A lease may be moved to and released on any thread, but the pool must
+ * outlive it.
+ */
+class PacketLease {
+    public:
+        PacketLease() = default;
+
+        PacketLease(PacketLease&& other) noexcept
+            : m_pool(other.m_pool), m_slot(other.m_slot), m_data(other.m_data), m_len(other.m_len)
+        {
+            other.m_pool = nullptr;
+        }
+
+        PacketLease& operator=(PacketLease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_pool = other.m_pool;
+                m_slot = other.m_slot;
+                m_data = other.m_data;
+                m_len = other.m_len;
+                other.m_pool = nullptr;
+            }
+            return *this;
+        }
+
+        PacketLease(const PacketLease&) = delete;
+        PacketLease& operator=(const PacketLease&) = delete;
+
+        ~PacketLease() { reset(); }
+
+        /**
+         * @brief Another lease on the same payload (one atomic increment).
+         */
+        inline PacketLease share() const;
+
+        // Drops the reference; the last one returns the slot to the pool
+        inline void reset();
+
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_len; }
+        explicit operator bool() const { return m_pool != nullptr; }
+
+    private:
+        friend class BufferPool;
+
+        PacketLease(BufferPool* pool, uint32_t slot, const uint8_t* data, size_t len)
+            : m_pool(pool), m_slot(slot), m_data(data), m_len(len) {}
+
+        BufferPool* m_pool = nullptr;
+        uint32_t m_slot = 0;
+        const uint8_t* m_data = nullptr;
+        size_t m_len = 0;
+};
+
+/**
+ * @class BufferPool
+ * @brief Fixed set of 64-byte aligned packet slots in one hugepage-backed mapping.
+ * Every slot carries a reference count. acquire() runs on the owner thread
+ * (the reactor); release() may run on any thread and is lock-free: the last
+ * reference pushes the slot onto an atomic return stack that the owner
+ * splices into its private free list once that runs dry.
+ */
+class ATU_API BufferPool {
+    public:
+        static constexpr uint32_t NO_SLOT = ~0u;
+
+        /**
+         * @brief Maps slots * slotSize bytes (slotSize rounded up to 64),
+         * preferring numaNode (-1 = first touch), written up front with prefault.
+         * @throws std::runtime_error if the mapping fails.
+         */
+        BufferPool(size_t slots, size_t slotSize, int numaNode = -1, bool prefault = false);
+        ~BufferPool();
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+         * @brief Takes a free slot with a reference count of one (owner thread only).
+         * @return The slot, or NO_SLOT when every slot is referenced.
+         */
+        uint32_t acquire();
+
+        void addRef(uint32_t slot) { m_refs[slot].fetch_add(1, std::memory_order_relaxed); }
+
+        // Any thread; the last reference hands the slot back
+        void release(uint32_t slot) {
+            if (m_refs[slot].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                pushReturned(slot);
+            }
+        }
+
+        uint32_t refCount(uint32_t slot) const { return m_refs[slot].load(std::memory_order_acquire); }
+
+        uint8_t* slotData(uint32_t slot) const { return m_base + slot * m_slotSize; }
+
+        bool contains(const uint8_t* p) const { return p >= m_base && p < m_base + m_slots * m_slotSize; }
+
+        uint32_t slotOf(const uint8_t* p) const {
+            return static_cast<uint32_t>(static_cast<size_t>(p - m_base) / m_slotSize);
+        }
+
+        /**
+         * @brief Retains a payload handed to a packet handler, without copying it.
+         * Call it while the payload pointer is valid, i.e. inside the handler.
+         * @return An empty lease if data does not point into this pool.
+         */
+        PacketLease lease(const uint8_t* data, size_t len) {
+            if (!contains(data)) [[unlikely]] return {};
+            uint32_t slot = slotOf(data);
+            addRef(slot);
+            return PacketLease(this, slot, data, len);
+        }
+
+        size_t capacity() const { return m_slots; }
+        size_t slotSize() const { return m_slotSize; }
+
+    private:
+        void pushReturned(uint32_t slot) {
+            uint32_t head = m_returned.load(std::memory_order_relaxed);
+            do {
+                m_next[slot] = head;
+            } while (!m_returned.compare_exchange_weak(head, slot,
+                        std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        size_t m_slots;
+        size_t m_slotSize;
+        uint8_t* m_base = nullptr;
+        size_t m_mappedSize = 0;
+
+        std::unique_ptr<std::atomic<uint32_t>[]> m_refs;
+        std::unique_ptr<uint32_t[]> m_next;     // Return stack links
+
+        // Owner thread only
+        std::vector<uint32_t> m_free;
+
+        // Head of the slots released since the last acquire() refill
+        alignas(64) std::atomic<uint32_t> m_returned{NO_SLOT};
+};
+
+inline PacketLease PacketLease::share() const {
+    if (m_pool == nullptr) return {};
+    m_pool->addRef(m_slot);
+    return PacketLease(m_pool, m_slot, m_data, m_len);
+}
+
+inline void PacketLease::reset() {
+    if (m_pool != nullptr) {
+        m_pool->release(m_slot);
+        m_pool = nullptr;
+    }
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -18,11 +18,12 @@
 #pragma once
 
 // System headers
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
-#include <set>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -31,6 +32,8 @@
 #include <atu_reactor/Export.h>
 #include <atu_reactor/Result.h>
 #include <atu_reactor/ScopedFd.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/TaskQueue.h>
 #include <atu_reactor/Types.h>
 
 namespace atu_reactor {
@@ -38,29 +41,105 @@ namespace atu_reactor {
 // Forward declaration
 class EventLoop;
 class UDPReceiver;
+class XDPReceiver;
+class IoUringUDPReceiver;
+class UDPSender;
+
+namespace detail { class TimerWheel; class PreciseTimers; }
+
+using EventCallbackFn = void(*)(void* context, uint32_t events);
 
 // Define the tags.
 // We use pointers here because they are "Incomplete Types"
 // which std::variant handles fine as long as they are pointers.
 struct TimerTag { EventLoop* loop; };
+struct WakeupTag { EventLoop* loop; };
 struct UDPReceiverTag {
     UDPReceiver* receiver;
     int fd;
     void* userContext;
     PacketHandlerFn handler;
+    PortStats* stats;       // nullptr unless ReceiverConfig::enableStats
+    uint16_t weight;        // SubscribeOptions::weight
+};
+struct UDPBatchReceiverTag {
+    UDPReceiver* receiver;
+    int fd;
+    uint16_t port;
+    void* userContext;
+    PacketBatchHandlerFn handler;
+    PortStats* stats;
+    uint16_t weight;
+};
+struct XDPReceiverTag {
+    XDPReceiver* receiver;
+    int fd;
+};
+struct IoUringReceiverTag {
+    IoUringUDPReceiver* receiver;
+    int fd;
+};
+struct UDPSenderTag {
+    UDPSender* sender;
+    int fd;
+};
+struct CallbackTag {
+    EventCallbackFn fn;     // A direct call, e.g. into a StaticUDPReceiver instantiation
+    void* context;
 };
 
 // The dispatch variant
-using InternalHandler = std::variant<std::monostate, TimerTag, UDPReceiverTag>;
+using InternalHandler = std::variant<std::monostate, TimerTag, UDPReceiverTag, UDPBatchReceiverTag,
+      XDPReceiverTag, IoUringReceiverTag, UDPSenderTag, WakeupTag, CallbackTag>;
 
 using Clock = std::chrono::steady_clock;
 using Timestamp = std::chrono::time_point<Clock>;
 using Duration = std::chrono::milliseconds;
+using PreciseDuration = std::chrono::nanoseconds;
 
 // ID to track and cancel timers
 using TimerId = uint64_t;
 
-using EventCallbackFn = void(*)(void* context, uint32_t events);
+// Called around every runOnce iteration (e.g. to flush queued output)
+using FlushHookFn = void(*)(void* context);
+
+/**
+ * @brief How runOnce waits for events.
+ */
+enum class PollMode : uint8_t {
+    BLOCK,      // epoll_wait with the caller's timeout (default)
+    SPIN,       // Non-blocking epoll_wait in a loop until events or timeout
+    HYBRID      // Spin for spinBudget, then block for the rest of the timeout
+};
+
+struct PollPolicy {
+    PollMode mode = PollMode::BLOCK;
+    std::chrono::microseconds spinBudget{50};   // HYBRID only
+
+    // Kernel busy polling of the epoll instance (EPIOCSPARAMS, Linux 6.9+).
+    // Pair with ReceiverConfig::busyPollUs on the sockets.
+    uint32_t epollBusyPollUs = 0;
+    uint16_t epollBusyPollBudget = 0;
+    bool epollPreferBusyPoll = false;
+};
+
+/**
+ * @brief Loop accounting, readable from any thread.
+ * Times are only measured in SPIN and HYBRID modes.
+ */
+struct LoopStats {
+    RelaxedCounter iterations;
+    RelaxedCounter events;          // Sources dispatched
+    RelaxedCounter emptyPolls;      // Non-blocking polls that found nothing
+    RelaxedCounter blockingWaits;   // HYBRID spins that ran out of budget
+    RelaxedCounter spinNs;          // Time spent polling
+    RelaxedCounter busyNs;          // Time spent dispatching, running tasks and hooks
+
+    // Indexed by Priority; only kept once a source or task uses a class
+    // other than NORMAL. classDelay is epoll_wait return to dispatch start.
+    std::array<RelaxedCounter, PRIORITY_CLASSES> classEvents{};
+    std::array<LatencyHistogram, PRIORITY_CLASSES> classDelay{};
+};
 
 /**
  * @class EventLoop
@@ -89,7 +168,29 @@ class ATU_API EventLoop {
          * @param cb The function to execute when the event triggers.
          * @throws std::runtime_error if the OS fails to add the source.
          */
-        Result<void> addSource(int fd, uint32_t eventMask, InternalHandler handler);
+        Result<void> addSource(int fd, uint32_t eventMask, InternalHandler handler,
+                Priority priority = Priority::NORMAL);
+
+        /**
+         * @brief Registers a user descriptor (TCP socket, eventfd, pipe...) calling
+         * fn(context, events) when it is ready; eventMask may include EPOLLET.
+         */
+        Result<void> addSource(int fd, uint32_t eventMask, EventCallbackFn fn, void* context,
+                Priority priority = Priority::NORMAL) {
+            if (fn == nullptr) return std::error_code(EINVAL, std::system_category());
+            return addSource(fd, eventMask, CallbackTag{fn, context}, priority);
+        }
+
+        /**
+         * @brief Moves a registered fd to another dispatch class.
+         * @return ENOENT if fd is not a source of this loop.
+         */
+        Result<void> setSourcePriority(int fd, Priority priority);
+
+        /**
+         * @brief Dispatch class of the timerfd, shared by every timer of the loop.
+         */
+        void setTimerPriority(Priority priority) { (void)setSourcePriority(m_timer_fd, priority); }
 
         /**
          * @brief Removes a file descriptor and its callback from the loop.
@@ -97,8 +198,39 @@ class ATU_API EventLoop {
          */
         Result<void> removeSource(int fd);
 
+        /**
+         * @brief Changes the epoll events watched for an already registered fd.
+         */
+        Result<void> modifySource(int fd, uint32_t eventMask);
+
+        /**
+         * @brief Registers a hook run before waiting and after dispatching in runOnce.
+         * Hooks must be cheap when they have nothing to do.
+         */
+        void addFlushHook(void* context, FlushHookFn hook);
+
+        /**
+         * @brief Removes every hook registered with this context.
+         */
+        void removeFlushHook(void* context);
+
+        /**
+         * @brief Selects how runOnce waits and applies the epoll busy-poll parameters.
+         * @return The ioctl error if the kernel rejects the busy-poll parameters
+         *         (ENOTTY before Linux 6.9, EPERM for a budget above the default
+         *         without CAP_NET_ADMIN); the mode is applied regardless.
+         */
+        Result<void> setPollPolicy(const PollPolicy& policy);
+
+        const PollPolicy& pollPolicy() const { return m_pollPolicy; }
+
+        const LoopStats& stats() const { return m_stats; }
+        // Owner thread only
+        void resetStats() { m_stats = LoopStats{}; }
+
         /**
          * @brief Waits for and dispatches pending events.
+         * In SPIN and HYBRID modes timeoutMs still bounds the call.
          * @param timeoutMs Max time to wait. -1 = infinite, 0 = non-blocking poll.
          */
         Result<void> runOnce(int timeoutMs);
@@ -106,8 +238,47 @@ class ATU_API EventLoop {
         /**
          * @brief Schedules a function to be executed in the next iteration of the loop.
          * Use this instead of runAfter(0, ...) to avoid system call overhead.
+         * Callables up to InlineTask::CAPACITY bytes are stored inline, so
+         * steady-state rescheduling never allocates.
+         */
+        template <typename F>
+        void runInLoop(F&& cb) { m_pendingTasks.push(std::forward<F>(cb)); }
+
+        /**
+         * @brief Same as above for a plain function and its context.
+         */
+        void runInLoop(void (*fn)(void*), void* context) { m_pendingTasks.push(fn, context); }
+
+        /**
+         * @brief runInLoop with a class: HIGH tasks run right after epoll_wait,
+         * before any source is dispatched, LOW tasks after the NORMAL ones.
          */
-        void runInLoop(std::function<void()> cb);
+        template <typename F>
+        void runInLoop(Priority priority, F&& cb) {
+            usePriority(priority);
+            taskQueue(priority).push(std::forward<F>(cb));
+        }
+
+        void runInLoop(Priority priority, void (*fn)(void*), void* context) {
+            usePriority(priority);
+            taskQueue(priority).push(fn, context);
+        }
+
+        /**
+         * @brief Queues a callable to run on the loop thread. Safe from any thread.
+         * Wakes the loop out of epoll_wait; a burst of posts made before the
+         * loop gets to run costs a single eventfd write.
+         */
+        template <typename F>
+        void post(F&& cb) {
+            m_posted.push(std::forward<F>(cb));
+            signalWakeup();
+        }
+
+        void post(void (*fn)(void*), void* context) {
+            m_posted.push(fn, context);
+            signalWakeup();
+        }
 
         /**
          * @brief Run a callback once after a delay.
@@ -121,6 +292,27 @@ class ATU_API EventLoop {
          */
         Result<TimerId> runEvery(Duration interval, TimerCallback cb);
 
+        /**
+         * @brief Run a callback once at a nanosecond-precision deadline.
+         * The timerfd is armed for deadline - spin; the loop then busy-waits
+         * on steady_clock for the remaining spin time, which removes the
+         * kernel wakeup latency from the result. Spin 0 relies on the timerfd alone.
+         * @return Unique ID to allow cancellation.
+         */
+        Result<TimerId> runAt(Timestamp deadline, TimerCallback cb, PreciseDuration spin = PreciseDuration(0));
+
+        /**
+         * @brief runAfter with nanosecond resolution (see runAt for spin).
+         */
+        Result<TimerId> runAfterPrecise(PreciseDuration delay, TimerCallback cb,
+                PreciseDuration spin = PreciseDuration(0));
+
+        /**
+         * @brief runEvery with nanosecond resolution, rescheduled without drift.
+         */
+        Result<TimerId> runEveryPrecise(PreciseDuration interval, TimerCallback cb,
+                PreciseDuration spin = PreciseDuration(0));
+
         /**
          * @brief Cancel a specific timer if it hasn't run yet.
          */
@@ -131,54 +323,85 @@ class ATU_API EventLoop {
         EventLoop& operator=(const EventLoop&) = delete;
 
     private:
-        // Internal struct to manage a scheduled task
-        struct Timer {
-            Timestamp expiration;
-            Duration interval; // Zero if one-shot
-            TimerCallback callback;
-            TimerId id;
-            bool repeat;
-
-            // Sorting for std::set (earliest time first)
-            bool operator<(const Timer& other) const {
-                if (expiration != other.expiration)
-                    return expiration < other.expiration;
-                return id < other.id;
-            }
-        };
-
+        int waitForEvents(int timeoutMs);
         void handleTimerRead();
-        void resetTimerFd();
-        void insertTimer(Timer t);
+        void handleWakeup();
+        void drainPosted();
+        static void redrainPosted(void* self);
+
+        void signalWakeup() {
+            // Only the first post since the last wakeup pays for the write
+            if (!m_wakeupPending.exchange(true, std::memory_order_seq_cst)) {
+                writeWakeup();
+            }
+        }
+        void writeWakeup();
+        void runFlushHooks();
+        void armTimerFd();
+
+        void usePriority(Priority priority) { m_prioritized |= priority != Priority::NORMAL; }
+        TaskQueue& taskQueue(Priority priority) {
+            if (priority == Priority::HIGH) return m_urgentTasks;
+            return priority == Priority::LOW ? m_lowTasks : m_pendingTasks;
+        }
+        bool tasksPending() const {
+            return !m_pendingTasks.empty() || !m_urgentTasks.empty() || !m_lowTasks.empty();
+        }
+        Result<TimerId> insertTimer(Duration delay, Duration interval, TimerCallback cb);
 
         static constexpr int MAX_EVENTS = 128; // Buffer size for events returned per wait
 
         // RAII wrapper for the epoll instance file descriptor
         ScopedFd m_epoll_fd;
         ScopedFd m_timer_fd;
+        ScopedFd m_wakeup_fd;
 
         struct EpollInternal;
         std::unique_ptr<EpollInternal> m_impl;
 
         struct Source {
             InternalHandler handler;
+            Priority priority = Priority::NORMAL;
         };
+        Source* findSource(int fd);
+        void dispatch(Source& source, uint32_t events);
+
+        // Queues for deferred execution, one per class
+        TaskQueue m_pendingTasks;
+        TaskQueue m_urgentTasks;
+        TaskQueue m_lowTasks;
 
-        // Queue for deferred execution
-        std::vector<std::function<void()>> m_pendingTasks;
+        // Set by the first non-NORMAL source or task: enables class ordering
+        bool m_prioritized = false;
+
+        PollPolicy m_pollPolicy;
+        LoopStats m_stats;
+
+        // Cross-thread tasks, drained when m_wakeup_fd fires
+        MpscTaskQueue m_posted;
+        std::atomic<bool> m_wakeupPending{false};
+
+        struct FlushHook {
+            void* context;
+            FlushHookFn fn;
+        };
+        std::vector<FlushHook> m_flushHooks;
 
         // Hybrid storage to prevent massive allocations on high FD numbers
         static constexpr int MAX_FAST_FDS = 1024; // Limit for direct indexing
         Source m_fastSources[MAX_FAST_FDS];
         std::unordered_map<int, Source> m_slowSources;
 
-        // Ordered queue of pending timers
-        std::set<Timer> m_timers;
+        // Hierarchical wheel holding every pending millisecond timer
+        std::unique_ptr<detail::TimerWheel> m_timers;
 
-        // Map ID -> Iterator (for fast cancellation O(log N))
-        std::unordered_map<TimerId, std::set<Timer>::iterator> m_activeTimers;
+        // Heap of nanosecond timers, sharing the timerfd with the wheel
+        std::unique_ptr<detail::PreciseTimers> m_preciseTimers;
 
-        uint64_t m_nextTimerId = 1;
+        // Deadline the timerfd is currently armed for
+        Timestamp m_armedAt;
+        bool m_armed = false;
+        bool m_firingTimers = false;
 };
 
 } // namespace atu_reactor
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/Export.h>
+#include <atu_reactor/PacketMetadata.h>
+#include <atu_reactor/PacketReceiver.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Reads the sequence number of one datagram.
+ * @return false if the datagram carries none (heartbeat, admin message):
+ * such datagrams are forwarded from every line as they come.
+ */
+using SequenceFn = bool (*)(void* context, const uint8_t* data, size_t len, uint64_t& seq);
+
+/**
+ * @brief Called with each run of sequence numbers no line delivered.
+ * Runs are reported in increasing order as they leave the window; a long run
+ * may be reported in several consecutive pieces.
+ */
+using GapHandlerFn = void (*)(void* context, uint64_t first, uint64_t count);
+
+/**
+ * @brief SequenceFn for an unsigned field of type T at a fixed payload offset,
+ * in network byte order unless BigEndian is false.
+ */
+template <typename T, size_t Offset, bool BigEndian = true>
+bool sequenceAt(void*, const uint8_t* data, size_t len, uint64_t& seq) {
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= sizeof(uint64_t), "unsigned field of up to 64 bits");
+    if (len < Offset + sizeof(T)) {
+        return false;
+    }
+
+    T value;
+    std::memcpy(&value, data + Offset, sizeof(T));
+    if constexpr (sizeof(T) > 1 && BigEndian == (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)) {
+        if constexpr (sizeof(T) == 2) value = __builtin_bswap16(value);
+        if constexpr (sizeof(T) == 4) value = __builtin_bswap32(value);
+        if constexpr (sizeof(T) == 8) value = __builtin_bswap64(value);
+    }
+    seq = value;
+    return true;
+}
+
+struct ArbiterConfig {
+    SequenceFn sequence = nullptr;
+    void* sequenceContext = nullptr;
+
+    // Sequence numbers remembered behind the newest one (power of two, at least 64).
+    // A copy older than that is dropped as stale, and a number leaving the window
+    // unseen on every line is reported as missing: the window bounds both how late
+    // a slow line may still fill a hole and how soon a gap is reported.
+    uint32_t window = 4096;
+};
+
+/**
+ * @brief Counters of one line, readable from any thread.
+ */
+struct LineStats {
+    RelaxedCounter packets;     // Datagrams received
+    RelaxedCounter wins;        // First copies, forwarded from this line
+    RelaxedCounter duplicates;  // Already forwarded from another line (or repeated on this one)
+    RelaxedCounter stale;       // Older than the window: dropped
+};
+
+/**
+ * @brief Arbitration counters, readable from any thread.
+ */
+struct ArbiterStats {
+    static constexpr int MAX_LINES = 4;
+
+    std::array<LineStats, MAX_LINES> lines;
+    RelaxedCounter forwarded;   // Handed to the handler, unsequenced datagrams included
+    RelaxedCounter unsequenced; // No sequence number (SequenceFn returned false)
+    RelaxedCounter missing;     // Sequence numbers that left the window unseen on every line
+    RelaxedCounter gaps;        // Missing runs reported to the gap handler
+
+    // Share of the first copies won by a line (0.0 - 1.0)
+    double winRate(int line) const {
+        uint64_t total = 0;
+        for (const auto& l : lines) {
+            total += l.wins.load();
+        }
+        return (total == 0 || line < 0 || line >= MAX_LINES)
+            ? 0.0 : static_cast<double>(lines[line].wins.load()) / static_cast<double>(total);
+    }
+};
+
+/**
+ * @class FeedArbiter
+ * @brief First-arrival-wins arbitration of a feed published on redundant lines (A/B).
+ * Every line is a batch subscription: the arbiter reads the sequence number
+ * of each datagram, forwards the first copy to the handler and drops the
+ * others. Seen numbers live in a ring bitmap of ArbiterConfig::window bits,
+ * so dedupe and gap detection are O(1) per packet, without hashing or
+ * allocation once constructed.
+ *
+ * First copies are forwarded as runs of the receiver's own PacketMetadata
+ * array: a batch without duplicates reaches a batch handler in one call,
+ * without a copy.
+ *
+ * @note Thread-hostile: every line must be dispatched by the same thread
+ * (one EventLoop), and the receivers must outlive the arbiter.
+ */
+class ATU_API FeedArbiter {
+    public:
+        static constexpr int MAX_LINES = ArbiterStats::MAX_LINES;
+
+        /**
+         * @brief Constructor
+         * @throws std::invalid_argument without a SequenceFn, or if the window is not a power of two of at least 64.
+         */
+        explicit FeedArbiter(ArbiterConfig config);
+
+        // Unsubscribes the lines from their receivers
+        ~FeedArbiter();
+
+        /**
+         * @brief Subscribes localPort on receiver as the next line.
+         * @return The line index (0 for the first line, 1 for the second...),
+         * ENOSPC past MAX_LINES or the receiver's error.
+         */
+        [[nodiscard]] Result<int> addLine(PacketReceiver& receiver, uint16_t localPort);
+
+        /**
+         * @brief Adds a line fed by the caller: pass lineContext(line) and
+         * FeedArbiter::onBatch wherever a PacketBatchHandlerFn is taken.
+         * @return The line index, or ENOSPC past MAX_LINES.
+         */
+        [[nodiscard]] Result<int> addLine();
+        void* lineContext(int line) { return &m_lines[line]; }
+
+        static void onBatch(void* context, int n, const PacketMetadata* meta,
+                const uint8_t* base, size_t stride);
+
+        // Where first copies go: the last of the two calls wins
+        void setHandler(void* context, PacketHandlerFn handler);
+        void setBatchHandler(void* context, PacketBatchHandlerFn handler);
+
+        void setGapHandler(void* context, GapHandlerFn handler);
+
+        // Forgets every sequence number seen, e.g. when the feed restarts its numbering.
+        // Counters are kept.
+        void reset();
+
+        const ArbiterStats& stats() const { return m_stats; }
+
+        // Disable copy/move: lines hand out pointers to the arbiter
+        FeedArbiter(const FeedArbiter&) = delete;
+        FeedArbiter& operator=(const FeedArbiter&) = delete;
+        FeedArbiter(FeedArbiter&&) = delete;
+        FeedArbiter& operator=(FeedArbiter&&) = delete;
+
+    private:
+        // Context of one line subscription
+        struct Line {
+            FeedArbiter* owner;
+            PacketReceiver* receiver;   // nullptr if fed by the caller
+            uint16_t port;
+            int index;
+        };
+
+        enum class Verdict { FIRST, DUPLICATE, STALE };
+
+        void arbitrate(const Line& line, int n, const PacketMetadata* meta, const uint8_t* base, size_t stride);
+        Verdict admit(uint64_t seq) noexcept;
+        void advance(uint64_t seq) noexcept;
+        void reportMissing(uint64_t first, uint64_t count);
+        void forward(int n, const PacketMetadata* meta, const uint8_t* base, size_t stride);
+
+        ArbiterConfig m_config;
+        uint64_t m_mask;
+        std::vector<uint64_t> m_seen;   // Ring bitmap: bit (seq & m_mask) set once seq was forwarded
+
+        bool m_started = false;
+        uint64_t m_first = 0;           // First sequence number since reset: nothing before is missing
+        uint64_t m_newest = 0;
+
+        std::array<Line, MAX_LINES> m_lines{};
+        int m_lineCount = 0;
+
+        void* m_handlerContext = nullptr;
+        PacketHandlerFn m_handler = nullptr;
+        PacketBatchHandlerFn m_batchHandler = nullptr;
+        void* m_gapContext = nullptr;
+        GapHandlerFn m_gapHandler = nullptr;
+
+        ArbiterStats m_stats;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Inherits from
+#include <atu_reactor/PacketReceiver.h>
+
+// System headers
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/Export.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Configuration for the io_uring backend.
+ * batchSize caps the completions handled per wakeup and bufferSize is the
+ * payload room of each provided buffer.
+ */
+struct IoUringConfig : public ReceiverConfig {
+    uint32_t bufferCount = 4096;    // Provided buffers (power of two, <= 32768)
+    uint32_t sqEntries = 64;        // Submission queue size
+    uint32_t cqEntries = 8192;      // Completion queue size
+};
+
+/**
+ * @class IoUringUDPReceiver
+ * @brief UDP receiver driven by one io_uring instead of one recvmmsg per socket.
+ * Every subscribed socket has a multishot IORING_OP_RECVMSG armed against a
+ * provided-buffer ring carved out of the PacketReceiver hugepage buffer. The
+ * ring fd is the only descriptor registered with the EventLoop, so datagrams
+ * from all ports are harvested from a single completion queue.
+ *
+ * @note Requires Linux 6.0+ (multishot recvmsg and buffer rings).
+ * This class is THREAD-HOSTILE, like UDPReceiver.
+ */
+class ATU_API IoUringUDPReceiver : public PacketReceiver {
+    // Grant EventLoop access to private members like handleRead
+    friend class EventLoop;
+
+    public:
+        /**
+         * @brief Constructor
+         * @throws std::runtime_error if the ring cannot be set up.
+         */
+        explicit IoUringUDPReceiver(EventLoop& loop, IoUringConfig config = {});
+
+        // Destructor cancels every request and tears the ring down
+        ~IoUringUDPReceiver() override;
+
+        /**
+         * @brief Creates a UDP socket bound to localPort and arms a multishot receive on it.
+         * @return The bound port (resolves port 0).
+         */
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler) override;
+
+        [[nodiscard]] Result<void> unsubscribe(uint16_t port) override;
+
+        // Disable copy/move to strictly manage resource identity
+        IoUringUDPReceiver(const IoUringUDPReceiver&) = delete;
+        IoUringUDPReceiver& operator=(const IoUringUDPReceiver&) = delete;
+        IoUringUDPReceiver(IoUringUDPReceiver&&) = delete;
+        IoUringUDPReceiver& operator=(IoUringUDPReceiver&&) = delete;
+
+    protected:
+        /**
+         * @brief Internal callback triggered by EventLoop when completions are ready.
+         */
+        void handleRead(int fd, void* context, PacketHandlerFn handler) override;
+
+    private:
+        struct Slot {
+            int fd = -1;
+            void* context = nullptr;
+            PacketHandlerFn handler = nullptr;
+            uint32_t generation = 0;
+            bool active = false;
+        };
+
+        // Provided buffer layout: recvmsg_out | name | control | payload
+        static constexpr size_t NAME_SPACE = sizeof(struct sockaddr_in6);
+        static constexpr size_t CONTROL_SPACE = CMSG_SPACE(sizeof(struct timespec));
+        static constexpr size_t HEADER_SPACE = sizeof(struct io_uring_recvmsg_out) + NAME_SPACE + CONTROL_SPACE;
+
+        static ReceiverConfig bufferLayout(const IoUringConfig& config);
+
+        struct io_uring_sqe* getSqe();
+        void armReceive(uint32_t slot);
+        void submit();
+        void recycleBuffer(uint16_t bid);
+
+        // Closes the ring and unmaps whatever the constructor mapped so far
+        void releaseRing();
+
+        IoUringConfig m_uringConfig;
+
+        ScopedFd m_ringFd;
+
+        // Submission queue
+        void* m_sqMap = nullptr;
+        size_t m_sqMapSize = 0;
+        uint32_t* m_sqHead = nullptr;
+        uint32_t* m_sqTail = nullptr;
+        uint32_t* m_sqArray = nullptr;
+        uint32_t m_sqMask = 0;
+        uint32_t m_sqEntries = 0;
+        struct io_uring_sqe* m_sqes = nullptr;
+        size_t m_sqesSize = 0;
+        uint32_t m_sqLocalTail = 0;     // SQEs filled but not yet published
+
+        // Completion queue
+        void* m_cqMap = nullptr;
+        size_t m_cqMapSize = 0;
+        uint32_t* m_cqHead = nullptr;
+        uint32_t* m_cqTail = nullptr;
+        uint32_t m_cqMask = 0;
+        struct io_uring_cqe* m_cqes = nullptr;
+
+        // Provided buffer ring
+        struct io_uring_buf_ring* m_bufRing = nullptr;
+        size_t m_bufRingSize = 0;
+        uint16_t m_bufTail = 0;
+
+        // Template handed to every multishot recvmsg (only the lengths matter)
+        struct msghdr m_msgTemplate{};
+
+        // Subscriptions, indexed by the slot encoded in user_data
+        std::vector<Slot> m_slots;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <memory>
+#include <string>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/PcapReceiver.h>
+
+namespace atu_reactor {
+
+/**
+ * @class MultiPcapReceiver
+ * @brief Replays several captures (legacy and pcapng mixed) as one stream.
+ * Files are merged by timestamp with a min-heap keyed on the next record of
+ * each file; equal stamps keep the order the files were given in. One port
+ * table, hot-port cache and pending batch serve every file, so batches for
+ * a port span records coming from different files.
+ */
+class ATU_API MultiPcapReceiver : public PacketReceiver {
+    public:
+        /**
+         * @brief Constructor
+         * @param loop Reference to the external event loop.
+         * @param config Replay mode and tuning, applied to every file.
+         */
+        explicit MultiPcapReceiver(EventLoop& loop, PcapConfig config = {});
+
+        /**
+         * @brief Opens the captures to merge, replacing any opened before.
+         * @return The error of the first file that fails to open.
+         */
+        [[nodiscard]] Result<void> open(const std::vector<std::string>& paths);
+
+        /**
+         * @brief Loads (or builds) the timestamp index of every file.
+         * @see PcapReceiver::loadIndex
+         */
+        [[nodiscard]] Result<void> loadIndex(uint32_t every = 1024);
+
+        /**
+         * @brief Positions every file on its first packet at or after ts.
+         * @return ENOENT if no file has a packet that late.
+         */
+        [[nodiscard]] Result<void> seek(const struct timespec& ts);
+
+        void rewind();
+
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler) override;
+
+        /**
+         * @brief Batch flavour of subscribe, see PcapReceiver::subscribeBatch.
+         */
+        [[nodiscard]] Result<int> subscribeBatch(uint16_t localPort, void* context, PacketBatchHandlerFn handler) override;
+
+        [[nodiscard]] Result<void> unsubscribe(uint16_t port) override;
+
+        /**
+         * @brief Address-restricted subscriptions, see PcapReceiver::subscribeFlow.
+         */
+        [[nodiscard]] Result<int> subscribeFlow(const FlowMatch& match, void* context, PacketHandlerFn handler);
+        [[nodiscard]] Result<int> subscribeFlowBatch(const FlowMatch& match, void* context,
+                PacketBatchHandlerFn handler);
+        [[nodiscard]] Result<void> unsubscribeFlow(const FlowMatch& match);
+
+        /**
+         * @brief Starts the replay loop (for TIMED and FLOOD modes).
+         */
+        void start();
+
+        /**
+         * @brief Dispatches the earliest pending packet across all files.
+         * @return true if a packet was processed, false if EOF or waiting (TIMED).
+         */
+        bool step();
+
+        bool isFinished() const { return m_finished; }
+
+        size_t fileCount() const { return m_sources.size(); }
+
+    protected:
+        void handleRead(int, void*, PacketHandlerFn) override {}
+
+    private:
+        struct Source {
+            std::unique_ptr<PcapReceiver> reader;
+            PcapReceiver::Record next;      // Decoded head of the file
+        };
+
+        // Min-heap entry: the next record of m_sources[source]
+        struct Head {
+            int64_t ns;
+            uint32_t source;
+        };
+
+        static bool earlier(const Head& a, const Head& b) noexcept {
+            return a.ns < b.ns || (a.ns == b.ns && a.source < b.source);
+        }
+
+        void processBatch();
+        static void deferredBatch(void* self);
+        inline bool internalStep() noexcept;
+
+        // Re-reads the head of every file, after open, rewind or seek
+        void rebuildHeap() noexcept;
+        void siftDown(size_t i) noexcept;
+
+        PcapConfig m_pcapConfig;
+
+        // Opens no file: owns the shared port table, hot cache, batch and pacing
+        PcapReceiver m_dispatcher;
+
+        std::vector<Source> m_sources;
+        std::vector<Head> m_heap;
+        bool m_finished = true;
+
+        // Bumped by open, seek and rewind: a handler calling them replaces the heap
+        uint64_t m_generation = 0;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -20,6 +20,8 @@
 // System headers
 #include <cstdint>
 #include <cstddef>
+#include <ctime>
+#include <sys/socket.h>
 
 namespace atu_reactor {
 
@@ -28,9 +30,13 @@ namespace atu_reactor {
  * This is the 'bridge' between the raw recvmmsg and your business logic.
  */
 struct PacketMetadata {
-    struct timespec ts;    // Kernel (Live) or File (PCAP) timestamp
+    struct timespec ts;    // Kernel software (Live) or File (PCAP) timestamp
     size_t len;            // Actual bytes received
     uint16_t destPort;     // The port identifying the subscriber
+    uint32_t status;       // PacketStatus bitmask
+    const struct sockaddr_storage* sender; // Source address (nullptr for PCAP)
+    const uint8_t* data;   // Start of the payload
+    struct timespec hwTs;  // NIC raw hardware timestamp, valid with PacketStatus::HW_TIMESTAMP
 };
 
 } // namespace atu_reactor
@@ -20,6 +20,7 @@
 // System headers
 #include <cassert>
 #include <map>
+#include <string>
 #include <sys/socket.h>
 #include <thread>
 #include <vector>
@@ -33,6 +34,15 @@
 
 namespace atu_reactor {
 
+/**
+ * @brief Which receive timestamps the kernel attaches to each datagram.
+ */
+enum class TimestampSource : uint8_t {
+    NONE,       // No timestamps, the control message walk is skipped
+    SOFTWARE,   // SO_TIMESTAMPNS (default)
+    HARDWARE    // SO_TIMESTAMPING: NIC raw hardware stamp plus the software one
+};
+
 /**
  * @brief Configuration for PacketReceiver performance tuning.
  */
@@ -40,6 +50,37 @@ struct ReceiverConfig {
     int maxFds = 128;         // Limit to prevent FD exhaustion
     int batchSize = 64;       // Number of packets to pull via recvmmsg
     int bufferSize = 2048;    // Sufficient for standard MTU + headers
+    // UDP_GRO: slots grow to 64KB, super-datagrams are split back into up to 64
+    // segments per slot (any remainder comes as one entry flagged TRUNCATED)
+    bool enableGro = false;
+
+    // EPOLLET: each wakeup repeats recvmmsg until a short read, up to readBudget
+    // datagrams (0 = no cap); a socket left non-empty is re-armed for the next wait
+    bool edgeTriggered = false;
+    int readBudget = 1024;
+
+    // Kernel busy polling on the sockets UDPReceiver opens (0/false = off)
+    int busyPollUs = 0;           // SO_BUSY_POLL: spin in the driver up to N us per read
+    bool preferBusyPoll = false;  // SO_PREFER_BUSY_POLL: defer NAPI softirq processing
+    int busyPollBudget = 0;       // SO_BUSY_POLL_BUDGET: packets per poll (0 = kernel default)
+
+    // Per-port and per-receiver counters, SO_RXQ_OVFL drops and latency histogram
+    bool enableStats = false;
+
+    // > 0: UDPReceiver reads into a BufferPool of this many slots, so handlers
+    // can keep payloads past the next read with BufferPool::lease()
+    int poolSlots = 0;
+
+    // NUMA node for the packet buffer and recvmmsg arrays (-1 = wherever first
+    // touch puts them). With numaInterface set and numaNode -1, the node of that
+    // NIC is read from /sys/class/net/<if>/device/numa_node.
+    int numaNode = -1;
+    std::string numaInterface;
+    bool pinToNode = false;   // Pin the constructing (owner) thread to the CPUs of the node
+    bool prefault = false;    // Write every buffer page up front: no page faults on the first packets
+
+    TimestampSource timestamps = TimestampSource::SOFTWARE;
+    std::string hwTimestampInterface; // HARDWARE: NIC to switch on with SIOCSHWTSTAMP ("" = leave as is)
 };
 
 /**
@@ -66,12 +107,29 @@ class ATU_API PacketReceiver {
          */
         [[nodiscard]] virtual Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler);
 
+        /**
+         * @brief Subscribes with a handler that receives a whole batch per call.
+         * @return EOPNOTSUPP unless the implementation supports batch delivery.
+         */
+        [[nodiscard]] virtual Result<int> subscribeBatch(uint16_t localPort, void* context, PacketBatchHandlerFn handler);
+
         /**
          * @brief Removes the port from the loop and closes the associated socket.
          * @param Logic is identical for UDP, TCP, or Pcap, so it lives here.
          */
         virtual Result<void> unsubscribe(uint16_t localPort);
 
+        /**
+         * @brief Socket bound to a subscribed port, for extra socket options.
+         * @return The descriptor, or -1 if the port has no socket.
+         */
+        int getFd(uint16_t localPort) const;
+
+        /**
+         * @brief NUMA node the buffers were placed on, -1 if left to first touch.
+         */
+        int numaNode() const { return m_numaNode; }
+
         // Disable copy/move to strictly manage resource identity
         PacketReceiver(const PacketReceiver&) = delete;
         PacketReceiver& operator=(const PacketReceiver&) = delete;
@@ -87,6 +145,11 @@ class ATU_API PacketReceiver {
                     "PacketReceiver accessed from wrong thread!");
         }
 
+        /**
+         * @brief Thread, limit and duplicate checks shared by every subscribe flavour.
+         */
+        [[nodiscard]] Result<void> checkSubscribe(uint16_t localPort) const;
+
         /**
          * @brief Internal callback triggered by EventLoop when a socket has data.
          */
@@ -100,6 +163,7 @@ class ATU_API PacketReceiver {
         EventLoop& m_loop;
         ReceiverConfig m_config;
         std::thread::id m_ownerThreadId; // Added for thread-safety asserts
+        int m_numaNode = -1;             // Resolved ReceiverConfig::numaNode
 
         // Maps port -> ScopedFd. RAII ensures sockets close on removal.
         std::map<uint16_t, ScopedFd> m_port_to_fd_map;
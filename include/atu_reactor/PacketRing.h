@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+// Library headers
+#include <atu_reactor/BufferPool.h>
+#include <atu_reactor/PacketMetadata.h>
+#include <atu_reactor/Ring.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Trivially copyable hand-off record for a received packet.
+ */
+struct PacketDescriptor {
+    const uint8_t* data;
+    size_t len;
+    struct timespec ts;    // Hardware stamp when PacketStatus::HW_TIMESTAMP is set, else software
+    uint16_t port;
+    uint32_t status;
+    uint32_t slot;         // BufferPool slot the consumer must release, or BufferPool::NO_SLOT
+};
+
+/**
+ * @class RingPublisher
+ * @brief Batch handler that publishes every recvmmsg batch to a ring.
+ * Pass the publisher as context and RingPublisher::onBatch to subscribeBatch.
+ * With an SpscRing the whole batch becomes visible with one release store.
+ *
+ * With a pool (a receiver built with ReceiverConfig::poolSlots) each
+ * descriptor holds one slot reference, so the consumer reads the payload
+ * in place and calls pool->release(slot) when done. Without a pool the
+ * payload is only valid until the next read.
+ */
+template <typename Ring>
+struct RingPublisher {
+    Ring* ring = nullptr;
+    BufferPool* pool = nullptr;
+    RelaxedCounter dropped;     // Packets that found the ring full
+
+    static void onBatch(void* context, int count, const PacketMetadata* packets,
+            const uint8_t*, size_t) {
+        auto* self = static_cast<RingPublisher*>(context);
+        BufferPool* pool = self->pool;
+
+        const size_t n = static_cast<size_t>(count);
+        const size_t published = self->ring->produce(n, [packets, pool](PacketDescriptor& d, size_t i) {
+            const PacketMetadata& meta = packets[i];
+            d.data = meta.data;
+            d.len = meta.len;
+            d.ts = (meta.status & PacketStatus::HW_TIMESTAMP) ? meta.hwTs : meta.ts;
+            d.port = meta.destPort;
+            d.status = meta.status;
+            d.slot = BufferPool::NO_SLOT;
+            if (pool != nullptr) {
+                d.slot = pool->slotOf(meta.data);
+                pool->addRef(d.slot);
+            }
+        });
+
+        if (published != n) [[unlikely]] {
+            self->dropped += n - published;
+        }
+    }
+};
+
+} // namespace atu_reactor
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
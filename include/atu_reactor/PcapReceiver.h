@@ -21,8 +21,10 @@
 #include <atu_reactor/PacketReceiver.h>
 
 // System headers
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <sys/types.h>
 
 // Library headers
@@ -30,6 +32,8 @@
 
 namespace atu_reactor {
 
+namespace detail { template <typename Value> class FlowTable; }
+
 enum class ReplayMode {
     TIMED,      // Respect PCAP timestamps relative to wall clock
     FLOOD,      // Replay as fast as CPU allows (in batches)
@@ -39,6 +43,28 @@ enum class ReplayMode {
 struct PcapConfig : public ReceiverConfig {
     ReplayMode mode = ReplayMode::TIMED;
     double speedMultiplier = 1.0; // 1.0 = normal speed, 2.0 = 2x speed
+
+    // TIMED: wake this long before each packet on the timerfd, then spin on
+    // steady_clock up to its exact time (0 = nanosecond timerfd only)
+    PreciseDuration pacingSpin{0};
+
+    // > 0: map the file through a sliding window of this many bytes, read
+    // ahead on a helper thread, instead of mapping (and populating) it whole
+    size_t streamWindow = 0;
+
+    // TIMED: hand packets over up to this long before their time, for sinks
+    // that schedule them themselves (e.g. SO_TXTIME in PcapTransmitter)
+    PreciseDuration dispatchLead{0};
+};
+
+/**
+ * @brief Address-restricted PCAP subscription, for captures where several
+ * multicast groups share a destination port. "" matches any address.
+ */
+struct FlowMatch {
+    uint16_t port = 0;
+    std::string dstAddress;     // IPv4 or IPv6, e.g. the group of one feed
+    std::string srcAddress;     // Optional publisher address
 };
 
 // PCAP File Global Header
@@ -102,6 +128,9 @@ struct PcapNgEPBBody {
  * @class PcapReceiver
  */
 class ATU_API PcapReceiver : public PacketReceiver {
+    // Drives several readers as record sources, dispatching through one of them
+    friend class MultiPcapReceiver;
+
     public:
         /**
          * @brief Constructor
@@ -121,14 +150,57 @@ class ATU_API PcapReceiver : public PacketReceiver {
 
         void rewind();
 
+        /**
+         * @brief Loads the timestamp index of the open file, building it first if needed.
+         * A missing or stale index (file size or mtime changed) is rebuilt with one
+         * pass over the capture and saved; failing to save it is not an error.
+         * @param indexPath Sidecar file, "" for the capture path plus ".idx".
+         * @param every Sample one record offset every N packets.
+         */
+        [[nodiscard]] Result<void> loadIndex(const std::string& indexPath = "", uint32_t every = 1024);
+
+        /**
+         * @brief Repositions the replay on the first packet stamped at or after ts.
+         * Binary-searches the index (see loadIndex) and scans at most a few
+         * records from there; without an index the scan starts at the beginning.
+         * TIMED pacing is re-anchored on the packet found.
+         * @return ENOENT if no packet is that late (the replay is then finished).
+         */
+        [[nodiscard]] Result<void> seek(const struct timespec& ts);
+
         /**
          * @brief "Subscribes" to a specific destination port found in the PCAP.
          * When a packet in the PCAP matches this destination port, the handler is called.
          */
         [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler);
 
+        /**
+         * @brief Batch flavour of subscribe.
+         * Consecutive packets for the port are grouped (up to batchSize) and
+         * delivered in one call. Payloads live in the mapped file, so the
+         * handler gets base == nullptr and must use PacketMetadata::data.
+         */
+        [[nodiscard]] Result<int> subscribeBatch(uint16_t localPort, void* context, PacketBatchHandlerFn handler) override;
+
+        /**
+         * @brief Drops every subscription to the port, address-restricted ones included.
+         */
         [[nodiscard]] Result<void> unsubscribe(uint16_t port) override;
 
+        /**
+         * @brief Subscribes to the packets of one flow.
+         * A packet goes to the most specific matching subscription of its port
+         * (destination and source, then destination, then source, then the
+         * port-wide one from subscribe()).
+         * @return The port; EINVAL for an unparsable address, EADDRINUSE for
+         *         a flow already subscribed.
+         */
+        [[nodiscard]] Result<int> subscribeFlow(const FlowMatch& match, void* context, PacketHandlerFn handler);
+        [[nodiscard]] Result<int> subscribeFlowBatch(const FlowMatch& match, void* context,
+                PacketBatchHandlerFn handler);
+
+        [[nodiscard]] Result<void> unsubscribeFlow(const FlowMatch& match);
+
         /**
          * @brief Starts the replay loop (for TIMED and FLOOD modes).
          */
@@ -142,6 +214,30 @@ class ATU_API PcapReceiver : public PacketReceiver {
 
         bool isFinished() const { return m_finished; }
 
+        ReplayMode mode() const { return m_pcapConfig.mode; }
+
+        /**
+         * @brief Steady-clock time at which TIMED mode plays a packet stamped ts.
+         * Meaningful once the replay is anchored on its first packet.
+         */
+        std::chrono::steady_clock::time_point playTime(const struct timespec& ts) const;
+
+        /**
+         * @brief FLOOD-replays the whole file on several threads, returning when done.
+         * The file is cut into chunks at record boundaries (taken from the index
+         * when one is loaded, else from a header-only pre-scan). Each round the
+         * workers parse one chunk each, then every worker delivers the packets
+         * of its share of the ports (destination port modulo workers), chunk
+         * after chunk: order is kept per port, not across ports. Handlers run on
+         * the worker threads, each port always on the same one; subscriptions
+         * must not change until this returns.
+         * @param workers Threads to use, the calling thread included.
+         * @param contexts If not empty (one per worker), worker i passes
+         *        contexts[i] to the handlers instead of the subscription context.
+         * @return Packets delivered; EOPNOTSUPP with streamWindow set.
+         */
+        [[nodiscard]] Result<uint64_t> floodParallel(unsigned workers, const std::vector<void*>& contexts = {});
+
         // Disable copy/move to strictly manage resource identity
         PcapReceiver(const PcapReceiver&) = delete;
         PcapReceiver& operator=(const PcapReceiver&) = delete;
@@ -157,42 +253,153 @@ class ATU_API PcapReceiver : public PacketReceiver {
     private:
         void processBatch();
         void processBatchFlood();
+
+        // runInLoop trampolines, avoid building a callable per batch
+        static void deferredBatch(void* self);
+        static void deferredBatchFlood(void* self);
         inline bool internalStep() noexcept;
-        inline void parseAndDispatch(
+
+        // Frame parsers, generic over where packets go: the receiver itself
+        // (lookupFlow + deliver) or a parallel chunk collecting them
+        template <typename Sink>
+        static inline void parseAndDispatch(
+                Sink& sink,
                 const struct timespec & header,
                 uint32_t caplen,
                 uint32_t len,
                 const uint8_t* packet,
                 uint32_t linkType);
-        void slowPathParse(const struct timespec& ts, uint32_t caplen, uint32_t len,
+        template <typename Sink>
+        static void slowPathParse(Sink& sink, const struct timespec& ts, uint32_t caplen, uint32_t len,
                 const uint8_t* packet, uint32_t linkType);
+        template <typename Sink>
+        static inline void dispatchIp(Sink& sink, const struct timespec& ts, const uint8_t* ip,
+                uint32_t remaining, uint16_t etherType, uint32_t status);
+
+        // Resolves the subscriber of a packet (ip: its IPv4/IPv6 header) into the hot cache
+        inline bool lookupFlow(uint16_t dstPortNet, const uint8_t* ip, bool v6) noexcept;
+        inline void deliver(uint16_t dstPortNet, const uint8_t* payload, size_t len,
+                uint32_t status, const struct timespec& ts) noexcept;
+        void flushBatch() noexcept;
 
         // Helper to determine when a packet should be played in TIMED mode
         std::chrono::steady_clock::time_point calculateTargetTimeHighRes(const struct timespec& header);
 
-        // Helper to read NG blocks
-        inline bool stepPcapNg() noexcept;
+        // Record readers, specialized by selectSteps() once open() knows the format
+        static constexpr uint32_t ANY_LINK_TYPE = UINT32_MAX;   // Link type read from m_linkType
+        template <bool Swapped, bool Nanosecond, uint32_t LinkType>
+        bool stepLegacy() noexcept;
+        template <bool Swapped>
+        bool stepPcapNg() noexcept;
+
+        using StepFn = bool (PcapReceiver::*)() noexcept;
+
+        // --- Block FLOOD ---
+        // Records decoded into a structure of arrays, classified by a SIMD kernel, then dispatched
+        struct FloodBlock;
+        template <bool Swapped, bool Nanosecond, uint32_t LinkType>
+        int gatherLegacy(FloodBlock& block) noexcept;
+        template <bool Swapped>
+        int gatherPcapNg(FloodBlock& block) noexcept;
+        using GatherFn = int (PcapReceiver::*)(FloodBlock& block) noexcept;
+        void classifyBlock(FloodBlock& block, int count) const noexcept;
+        void dispatchBlock(const FloodBlock& block, int count) noexcept;
+
+        template <StepFn Step, GatherFn Gather>
+        static void floodLoop(PcapReceiver* self);
+        void selectSteps() noexcept;
+
+        // True once the next bytes from m_currentPtr are mapped (slides the window if needed)
+        inline bool ensure(size_t bytes) noexcept;
+        bool slideWindow(size_t bytes) noexcept;
+
+        // Maps the window holding file [offset, offset + bytes) and points m_currentPtr at offset
+        bool mapWindow(uint64_t offset, size_t bytes) noexcept;
+
+        // Helper thread pulling the next window into the page cache
+        struct Prefetcher;
+
+        // --- Timestamp index ---
+        struct IndexEntry {
+            uint64_t offset;        // Record (pcapng: block) to resume from
+            int64_t maxBeforeNs;    // Latest timestamp of every record before it
+        };
+
+        uint64_t currentOffset() const noexcept {
+            return m_windowOffset + static_cast<uint64_t>(m_currentPtr - m_mappedData);
+        }
+        bool moveTo(uint64_t offset) noexcept;
+
+        // A packet record, decoded but not dispatched
+        struct Record {
+            struct timespec ts;
+            const uint8_t* data;    // Link-layer frame, inside the current window
+            uint32_t caplen;
+            uint32_t len;
+            uint32_t linkType;
+            size_t size;            // Bytes from the record start to the next one
+        };
+
+        // Decodes the record at m_currentPtr without moving past it.
+        // pcapng blocks in front of it are consumed (interface blocks parsed).
+        bool peekRecord(Record& rec) noexcept;
+        bool advanceRecord(Record& rec) noexcept {
+            m_currentPtr += rec.size;
+            return peekRecord(rec);
+        }
+        void dispatchRecord(const Record& rec) noexcept;
+
+        // Bytes used by the record or block at p (its header must be mapped)
+        size_t recordSize(const uint8_t* p) const noexcept;
+        // Decodes the record at p, whose recordSize() bytes are mapped.
+        // Returns false, with rec.size set, for pcapng blocks that are not packets.
+        bool decodeAt(const uint8_t* p, Record& rec) const noexcept;
+
+        // --- Parallel FLOOD ---
+        struct ChunkSink;
+        std::vector<uint64_t> chunkBounds(size_t chunks);
+        void parseChunk(ChunkSink& sink, const uint8_t* p, const uint8_t* end) const;
+        void parseInterfaceBlock(uint32_t len) noexcept;
+
+        void buildIndex(uint32_t every);
+        bool readIndex(const std::string& path, uint32_t every);
+        void writeIndex(const std::string& path, uint32_t every) const;
 
         struct InterfaceInfo {
-            uint16_t linkType;
-            uint64_t tsResolutionDivisor;
+            uint16_t linkType = 1;                      // DLT_EN10MB
+            uint64_t tsResolutionDivisor = 1000000;     // Microseconds, the pcapng default
         };
 
         PcapConfig m_pcapConfig;
 
         // --- MMAP State ---
         int m_fd = -1;
-        uint8_t* m_mappedData = nullptr;
+        uint8_t* m_mappedData = nullptr;  // Window base (the whole file unless streaming)
         size_t m_fileSize = 0;
+        uint64_t m_windowOffset = 0;      // File offset of m_mappedData
+        size_t m_windowSize = 0;          // Bytes mapped at m_mappedData
+        const uint8_t* m_windowEnd = nullptr;
         const uint8_t* m_currentPtr = nullptr;
         uint32_t m_linkType = 0;
+        std::unique_ptr<Prefetcher> m_prefetcher;
+
+        // Receiver whose pending batch may point into this file's window
+        // (itself, or the dispatcher of a MultiPcapReceiver)
+        PcapReceiver* m_batchOwner = this;
+
+        std::string m_path;
+        int64_t m_fileMtimeNs = 0;
+        std::vector<IndexEntry> m_index;
 
-        // Subscriptions: Map Port -> Handler info
+        // Subscriptions: (port, addresses) -> Handler info
         struct Subscription {
             void* context = nullptr;
             PacketHandlerFn handler = nullptr;
+            PacketBatchHandlerFn batchHandler = nullptr;
         };
-        std::unique_ptr<Subscription[]> m_portTable;
+        Result<int> addFlow(const FlowMatch& match, const Subscription& sub);
+        void resetHot() noexcept;
+        std::unique_ptr<detail::FlowTable<Subscription>> m_flows;
 
         // Timing state
         struct timespec m_pcapStartTs = {0, 0}; // TS of first packet in file
@@ -204,6 +411,10 @@ class ATU_API PcapReceiver : public PacketReceiver {
         bool m_swapped = false;
         bool m_isNanosecond = false;
 
+        // Chosen by selectSteps(): one indirect call per step (FLOOD: per 20000 packets)
+        StepFn m_step = nullptr;
+        void (*m_floodLoop)(PcapReceiver* self) = nullptr;
+
         // Maps Interface ID (index in file) to its metadata
         std::unordered_map<uint32_t, InterfaceInfo> m_interfaces;
         uint32_t m_interfaceCount = 0;
@@ -211,8 +422,15 @@ class ATU_API PcapReceiver : public PacketReceiver {
         bool m_isPcapNg = true;
 
         uint16_t m_hotPort = 0; // In Network Byte Order
+        bool m_hotPortWide = false;     // m_hotSub holds for any packet to m_hotPort
+        const Subscription* m_hotSub = nullptr;
         PacketHandlerFn m_hotHandler = nullptr;
+        PacketBatchHandlerFn m_hotBatchHandler = nullptr;
         void* m_hotContext = nullptr;
+
+        // Pending batch, always for m_hotSub; flushed before returning to the loop
+        std::vector<PacketMetadata> m_batch;
+        int m_batchCount = 0;
 };
 
 }  // namespace atu_reactor
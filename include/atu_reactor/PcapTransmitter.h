@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <sys/socket.h>
+#include <unordered_map>
+
+// Library headers
+#include <atu_reactor/Export.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/UDPSender.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Transmit counters, readable from any thread.
+ */
+struct TransmitStats {
+    RelaxedCounter packets;     // Handed to the UDPSender
+    RelaxedCounter bytes;
+    RelaxedCounter dropped;     // Send ring full (after a flush), or payload over bufferSize
+
+    // TIMED: nanoseconds packets reached the sender after their play time (0 if on time)
+    LatencyHistogram lateness;
+
+    // From the first packet to the latest one, in nanoseconds
+    RelaxedCounter targetSpanNs;    // Play times: capture span divided by the replay speed
+    RelaxedCounter achievedSpanNs;  // Wall clock when handed to the sender
+
+    // Packets per second the capture asks for (0 outside TIMED mode)
+    double targetRate() const { return rate(targetSpanNs.load()); }
+
+    // Packets per second actually handed to the sender. Well below targetRate
+    // together with a growing lateness means the replayer is the bottleneck.
+    double achievedRate() const { return rate(achievedSpanNs.load()); }
+
+    private:
+        double rate(uint64_t spanNs) const {
+            const uint64_t n = packets.load();
+            return (n < 2 || spanNs == 0) ? 0.0 : static_cast<double>(n - 1) * 1e9 / static_cast<double>(spanNs);
+        }
+};
+
+/**
+ * @class PcapTransmitter
+ * @brief Sends the UDP payloads a PcapReceiver replays back onto the network.
+ * Each routed capture port is rewritten to a destination address and port
+ * and its payloads are queued in a UDPSender, which leaves in sendmmsg
+ * batches (GSO if enabled) every loop iteration.
+ *
+ * In TIMED mode the replay already paces packets to the nanosecond timer.
+ * With SenderConfig::enableTxTime and a PcapConfig::dispatchLead, packets
+ * are handed over that much early and carry their play time as SO_TXTIME
+ * launch time, so the qdisc (fq, or ETF with CLOCK_TAI) releases them with
+ * sub-microsecond accuracy regardless of reactor jitter.
+ *
+ * @note Thread-hostile; the PcapReceiver must outlive the transmitter.
+ */
+class ATU_API PcapTransmitter {
+    public:
+        /**
+         * @brief Constructor
+         * @throws std::runtime_error if the UDPSender cannot be created.
+         */
+        PcapTransmitter(EventLoop& loop, PcapReceiver& reader, SenderConfig config = {});
+
+        // Removes the routes from the reader
+        ~PcapTransmitter();
+
+        /**
+         * @brief Sends the packets replayed for capturePort to dest.
+         * @return The reader's error if the port is already subscribed.
+         */
+        [[nodiscard]] Result<void> route(uint16_t capturePort, const struct sockaddr* dest, socklen_t destLen);
+
+        [[nodiscard]] Result<void> unroute(uint16_t capturePort);
+
+        const TransmitStats& stats() const { return m_stats; }
+
+        // True if launch times are passed to the kernel (SO_TXTIME accepted)
+        bool txTimeEnabled() const { return m_sender.txTimeEnabled(); }
+
+        UDPSender& sender() { return m_sender; }
+
+        // Disable copy/move to strictly manage resource identity
+        PcapTransmitter(const PcapTransmitter&) = delete;
+        PcapTransmitter& operator=(const PcapTransmitter&) = delete;
+        PcapTransmitter(PcapTransmitter&&) = delete;
+        PcapTransmitter& operator=(PcapTransmitter&&) = delete;
+
+    private:
+        // Context of one reader subscription
+        struct Route {
+            PcapTransmitter* owner;
+            struct sockaddr_storage dest;
+            socklen_t destLen;
+        };
+
+        static void onBatch(void* context, int n, const PacketMetadata* meta,
+                const uint8_t* base, size_t stride);
+        void send(const Route& route, int n, const PacketMetadata* meta);
+
+        PcapReceiver& m_reader;
+        SenderConfig m_config;
+        UDPSender m_sender;
+        std::unordered_map<uint16_t, std::unique_ptr<Route>> m_routes;
+        TransmitStats m_stats;
+
+        // Spans start at the first packet sent
+        bool m_started = false;
+        std::chrono::steady_clock::time_point m_firstTarget;
+        std::chrono::steady_clock::time_point m_firstSent;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
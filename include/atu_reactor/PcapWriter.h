@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/Export.h>
+#include <atu_reactor/PacketMetadata.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/ScopedFd.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/SubscribeOptions.h>
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+class UDPReceiver;
+
+/**
+ * @brief Configuration for PcapWriter.
+ */
+struct WriterConfig {
+    size_t stagingBytes = 4 * 1024 * 1024;  // Each of the two staging halves
+    Duration flushInterval{100};            // Hand a partial half over at least this often (0: only when full)
+    bool hardwareStamps = true;             // Record hwTs when PacketStatus::HW_TIMESTAMP is set
+};
+
+/**
+ * @brief Recorder counters, readable from any thread.
+ */
+struct WriterStats {
+    RelaxedCounter staged;      // Packets copied on the reactor thread
+    RelaxedCounter dropped;     // Both halves busy (the disk is too slow), or payload over a half
+    RelaxedCounter written;     // Packets written by the background thread
+    RelaxedCounter bytes;       // File bytes written
+    RelaxedCounter writeErrors;
+};
+
+/**
+ * @class PcapWriter
+ * @brief Records what UDPReceiver handlers see into a nanosecond pcapng file.
+ * A tap subscribes on the receiver, copies each batch (payloads, kernel or
+ * hardware timestamps, sender) into a double-buffered hugepage staging area
+ * and then runs the user handler. The reactor never waits on the disk: a
+ * background thread turns full halves into Enhanced Packet Blocks with
+ * synthesized Ethernet/IP/UDP headers, which PcapReceiver replays as is
+ * (IPv6 senders are recorded as IPv6 frames and replay the same way).
+ *
+ * @note Thread-hostile, like UDPReceiver; the receivers must outlive their taps.
+ */
+class ATU_API PcapWriter {
+    public:
+        /**
+         * @brief Creates (truncates) path and starts the writer thread.
+         * @throws std::runtime_error if the file or the staging area cannot be created.
+         */
+        PcapWriter(EventLoop& loop, const std::string& path, WriterConfig config = {});
+
+        // Removes the taps, writes what is staged and closes the file
+        ~PcapWriter();
+
+        /**
+         * @brief Subscribes handler on receiver, recording every packet first.
+         */
+        [[nodiscard]] Result<int> tap(UDPReceiver& receiver, uint16_t localPort,
+                void* context, PacketHandlerFn handler);
+        [[nodiscard]] Result<int> tap(UDPReceiver& receiver, uint16_t localPort,
+                const SubscribeOptions& options, void* context, PacketHandlerFn handler);
+
+        [[nodiscard]] Result<int> tapBatch(UDPReceiver& receiver, uint16_t localPort,
+                void* context, PacketBatchHandlerFn handler);
+        [[nodiscard]] Result<int> tapBatch(UDPReceiver& receiver, uint16_t localPort,
+                const SubscribeOptions& options, void* context, PacketBatchHandlerFn handler);
+
+        /**
+         * @brief Unsubscribes a tap from its receiver.
+         */
+        [[nodiscard]] Result<void> untap(UDPReceiver& receiver, uint16_t localPort);
+
+        /**
+         * @brief Stages a batch directly, e.g. from a handler of another receiver.
+         */
+        void record(int count, const PacketMetadata* packets) noexcept;
+
+        /**
+         * @brief Hands the partial half to the writer thread now.
+         */
+        void flush() noexcept;
+
+        const WriterStats& stats() const { return m_stats; }
+
+        // Disable copy/move to strictly manage resource identity
+        PcapWriter(const PcapWriter&) = delete;
+        PcapWriter& operator=(const PcapWriter&) = delete;
+        PcapWriter(PcapWriter&&) = delete;
+        PcapWriter& operator=(PcapWriter&&) = delete;
+
+    private:
+        struct Tap {
+            PcapWriter* owner;
+            UDPReceiver* receiver;
+            uint16_t port;
+            void* context;
+            PacketHandlerFn handler;
+            PacketBatchHandlerFn batchHandler;
+        };
+
+        static void onBatch(void* context, int count, const PacketMetadata* packets,
+                const uint8_t* base, size_t stride);
+        Result<int> addTap(UDPReceiver& receiver, uint16_t port, const SubscribeOptions* options,
+                void* context, PacketHandlerFn handler, PacketBatchHandlerFn batchHandler);
+
+        // Reactor side: room for bytes in the active half, nullptr to drop
+        inline uint8_t* stage(size_t bytes) noexcept;
+        void handOver() noexcept;
+
+        // Writer thread
+        void run();
+        void writeHalf(const uint8_t* data, size_t used);
+        bool writeAll(const uint8_t* data, size_t len);
+
+        EventLoop& m_loop;
+        WriterConfig m_config;
+        ScopedFd m_fd;
+        ScopedFd m_wakeFd;
+        TimerId m_flushTimer = 0;
+
+        uint8_t* m_staging = nullptr;       // Two halves of m_config.stagingBytes
+        size_t m_mappedSize = 0;
+
+        // Bytes handed over per half, 0 once written (released by the writer)
+        std::atomic<size_t> m_pending[2] = {{0}, {0}};
+        int m_active = 0;                   // Reactor: half being filled
+        size_t m_fill = 0;
+        bool m_activeFree = true;
+
+        std::vector<std::unique_ptr<Tap>> m_taps;
+        WriterStats m_stats;
+
+        std::atomic<bool> m_stop{false};
+        std::thread m_writer;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/Export.h>
+#include <atu_reactor/PacketReceiver.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+// Forward declaration
+class UDPReceiver;
+
+/**
+ * @brief Configuration for ReactorGroup.
+ */
+struct ReactorGroupConfig {
+    std::vector<int> cpus;          // One shard (thread + EventLoop + UDPReceiver) per entry
+    ReceiverConfig receiver;        // Per-shard receiver tuning
+    PollPolicy poll;                // Per-shard loop wait policy
+    bool steerByCpu = true;         // Attach the SO_INCOMING_CPU reuseport program
+    int pollTimeoutMs = 100;        // epoll_wait timeout; stop() and subscribe() wake shards directly
+};
+
+/**
+ * @class ReactorGroup
+ * @brief Runs one pinned EventLoop per core, sharing ports through SO_REUSEPORT.
+ * Every subscription is opened once per shard. Shards are started one at a
+ * time, so shard i owns the i-th socket of each reuseport group; a classic
+ * BPF program then returns the shard pinned to the CPU that processed the
+ * packet (wrapping modulo the shard count for unlisted CPUs). Pin each
+ * shard to the core that serves the matching RX queue IRQ to keep a flow
+ * on one core end to end.
+ *
+ * Handlers run concurrently on every shard thread with the same context;
+ * use currentShard() to reach per-shard state.
+ *
+ * Once running, subscription changes are post()ed to each shard in turn
+ * and wait for it to apply them.
+ *
+ * @note The control methods are not thread-safe among themselves and must
+ *       not be called from a shard thread.
+ */
+class ATU_API ReactorGroup {
+    public:
+        /**
+         * @brief Constructor
+         * @throws std::runtime_error if no CPU is configured.
+         */
+        explicit ReactorGroup(ReactorGroupConfig config);
+
+        // Destructor stops and joins every shard
+        ~ReactorGroup();
+
+        /**
+         * @brief Opens a subscription on every shard.
+         * Before start() it is only recorded; afterwards each shard opens its
+         * socket on its own thread and steering is attached to the new group.
+         * @return The port, EINVAL for port 0 (shards must agree on a port),
+         *         EDEADLK if called from a shard thread.
+         */
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler);
+
+        [[nodiscard]] Result<int> subscribeBatch(uint16_t localPort, void* context, PacketBatchHandlerFn handler);
+
+        /**
+         * @brief Closes the subscription on every shard.
+         * @return ENOENT if the port is not subscribed.
+         */
+        Result<void> unsubscribe(uint16_t localPort);
+
+        /**
+         * @brief Spawns the shards, opens the sockets and attaches the steering program.
+         * On failure every shard already started is stopped again.
+         */
+        [[nodiscard]] Result<void> start();
+
+        /**
+         * @brief Asks every shard to leave its loop and joins the threads.
+         */
+        void stop();
+
+        size_t size() const { return m_shards.size(); }
+
+        /**
+         * @brief Index of the shard running the calling thread, or -1 outside the group.
+         */
+        static int currentShard();
+
+        // Disable copy/move to strictly manage resource identity
+        ReactorGroup(const ReactorGroup&) = delete;
+        ReactorGroup& operator=(const ReactorGroup&) = delete;
+        ReactorGroup(ReactorGroup&&) = delete;
+        ReactorGroup& operator=(ReactorGroup&&) = delete;
+
+    private:
+        struct Subscription {
+            uint16_t port;
+            void* context;
+            PacketHandlerFn handler;
+            PacketBatchHandlerFn batchHandler;
+        };
+
+        struct Shard {
+            int cpu;
+            std::thread thread;
+            EventLoop* loop = nullptr;          // Owned by the shard thread, valid until joined
+            UDPReceiver* receiver = nullptr;
+            std::vector<int> fds;               // Socket per subscription, in m_subscriptions order
+            bool stopping = false;              // Only touched on the shard thread
+        };
+
+        Result<int> addSubscription(Subscription sub);
+        void runShard(size_t index, std::promise<std::error_code> ready);
+        std::error_code openOnShard(Shard& shard, const Subscription& sub);
+        std::error_code runOnShard(Shard& shard, const std::function<std::error_code()>& fn);
+        Result<void> attachSteering(size_t subscription);
+
+        ReactorGroupConfig m_config;
+        std::vector<Shard> m_shards;
+        std::vector<Subscription> m_subscriptions;
+        bool m_running = false;
+        bool m_started = false;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace atu_reactor {
+
+namespace detail {
+
+constexpr size_t ringCapacity(size_t requested) {
+    size_t capacity = 1;
+    while (capacity < requested) capacity <<= 1;
+    return capacity;
+}
+
+} // namespace detail
+
+/**
+ * @class SpscRing
+ * @brief Bounded single-producer single-consumer ring, capacity rounded up to a power of two.
+ * Producer and consumer indices live on separate cache lines, each next to
+ * a cached copy of the other side, so the shared lines are only touched
+ * when the cache says the ring looks full (or empty). produce() and
+ * consume() move a whole run of items with a single release store.
+ */
+template <typename T>
+class SpscRing {
+    public:
+        explicit SpscRing(size_t capacity)
+            : m_mask(detail::ringCapacity(capacity) - 1), m_items(new T[m_mask + 1]) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        size_t capacity() const { return m_mask + 1; }
+
+        // Either side; exact only when the other side is idle
+        size_t sizeApprox() const {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Producer: fill(T& item, size_t i) writes up to n items in place,
+         * then all of them are published at once.
+         * @return Number of items written (less than n when the ring is full).
+         */
+        template <typename Fill>
+        size_t produce(size_t n, Fill&& fill) {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (capacity() - (tail - m_headCache) < n) {
+                m_headCache = m_head.load(std::memory_order_acquire);
+                n = std::min(n, capacity() - (tail - m_headCache));
+            }
+            if (n == 0) return 0;
+
+            for (size_t i = 0; i < n; ++i) {
+                fill(m_items[(tail + i) & m_mask], i);
+            }
+            m_tail.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        bool tryPush(const T& item) { return produce(1, [&](T& slot, size_t) { slot = item; }) == 1; }
+        bool tryPush(T&& item) { return produce(1, [&](T& slot, size_t) { slot = std::move(item); }) == 1; }
+
+        size_t pushBatch(const T* items, size_t n) {
+            return produce(n, [items](T& slot, size_t i) { slot = items[i]; });
+        }
+
+        /**
+         * @brief Consumer: take(T& item) is called for up to max items, which
+         * are then released to the producer at once.
+         * @return Number of items taken.
+         */
+        template <typename Take>
+        size_t consume(size_t max, Take&& take) {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (m_tailCache - head < max) {
+                m_tailCache = m_tail.load(std::memory_order_acquire);
+                max = std::min(max, m_tailCache - head);
+            }
+            if (max == 0) return 0;
+
+            for (size_t i = 0; i < max; ++i) {
+                take(m_items[(head + i) & m_mask]);
+            }
+            m_head.store(head + max, std::memory_order_release);
+            return max;
+        }
+
+        bool tryPop(T& out) { return consume(1, [&](T& slot) { out = std::move(slot); }) == 1; }
+
+        size_t popBatch(T* out, size_t max) {
+            return consume(max, [&out](T& slot) { *out++ = std::move(slot); });
+        }
+
+    private:
+        const size_t m_mask;
+        std::unique_ptr<T[]> m_items;
+
+        // Producer line
+        alignas(64) std::atomic<size_t> m_tail{0};
+        size_t m_headCache = 0;
+
+        // Consumer line
+        alignas(64) std::atomic<size_t> m_head{0};
+        size_t m_tailCache = 0;
+};
+
+/**
+ * @class MpmcRing
+ * @brief Bounded multi-producer multi-consumer ring (Vyukov), capacity a power of two.
+ * Each cell carries a sequence number, so producers and consumers only
+ * contend on their own index with one CAS per item and never block each
+ * other. There is no batch publication: every item is released on its own.
+ */
+template <typename T>
+class MpmcRing {
+    public:
+        explicit MpmcRing(size_t capacity)
+            : m_mask(detail::ringCapacity(capacity) - 1), m_cells(new Cell[m_mask + 1])
+        {
+            for (size_t i = 0; i <= m_mask; ++i) {
+                m_cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcRing(const MpmcRing&) = delete;
+        MpmcRing& operator=(const MpmcRing&) = delete;
+
+        size_t capacity() const { return m_mask + 1; }
+
+        // Any thread: fill(T& item, size_t i) for up to n items
+        template <typename Fill>
+        size_t produce(size_t n, Fill&& fill) {
+            for (size_t i = 0; i < n; ++i) {
+                size_t pos;
+                Cell* cell = claim(m_tail, 0, pos);
+                if (cell == nullptr) return i;
+                fill(cell->value, i);
+                cell->seq.store(pos + 1, std::memory_order_release);
+            }
+            return n;
+        }
+
+        bool tryPush(const T& item) { return produce(1, [&](T& slot, size_t) { slot = item; }) == 1; }
+        bool tryPush(T&& item) { return produce(1, [&](T& slot, size_t) { slot = std::move(item); }) == 1; }
+
+        size_t pushBatch(const T* items, size_t n) {
+            return produce(n, [items](T& slot, size_t i) { slot = items[i]; });
+        }
+
+        // Any thread: take(T& item) for up to max items
+        template <typename Take>
+        size_t consume(size_t max, Take&& take) {
+            for (size_t i = 0; i < max; ++i) {
+                size_t pos;
+                Cell* cell = claim(m_head, 1, pos);
+                if (cell == nullptr) return i;
+                take(cell->value);
+                cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+            }
+            return max;
+        }
+
+        bool tryPop(T& out) { return consume(1, [&](T& slot) { out = std::move(slot); }) == 1; }
+
+        size_t popBatch(T* out, size_t max) {
+            return consume(max, [&out](T& slot) { *out++ = std::move(slot); });
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> seq;
+            T value;
+        };
+
+        /**
+         * @brief Reserves the cell at index once its sequence reads index + lag
+         * (0: free for producers, 1: filled for consumers).
+         * @param pos Receives the claimed position.
+         * @return nullptr when the ring is full (or empty).
+         */
+        Cell* claim(std::atomic<size_t>& index, size_t lag, size_t& pos) {
+            pos = index.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell* cell = &m_cells[pos & m_mask];
+                const size_t seq = cell->seq.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + lag);
+                if (diff == 0) {
+                    if (index.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        return cell;
+                    }
+                } else if (diff < 0) {
+                    return nullptr;
+                } else {
+                    pos = index.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+
+        alignas(64) std::atomic<size_t> m_tail{0};
+        alignas(64) std::atomic<size_t> m_head{0};
+};
+
+} // namespace atu_reactor
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
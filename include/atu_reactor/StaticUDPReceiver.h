@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sys/socket.h>
+#include <utility>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/Export.h>
+#include <atu_reactor/PacketMetadata.h>
+#include <atu_reactor/PacketReceiver.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/SubscribeOptions.h>
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Compile-time receive parameters for StaticUDPReceiver.
+ */
+template <int BatchSize = 64, int BufferSize = 2048, TimestampSource Timestamps = TimestampSource::SOFTWARE>
+struct StaticReceiverConfig {
+    static_assert(BatchSize > 0 && BufferSize > 0, "batch and buffer sizes must be positive");
+
+    static constexpr int batchSize = BatchSize;
+    static constexpr int bufferSize = BufferSize;
+    static constexpr TimestampSource timestamps = Timestamps;
+};
+
+/**
+ * @class StaticReceiverBase
+ * @brief Socket and buffer management shared by every StaticUDPReceiver.
+ * Sockets are registered as plain callback sources, so the loop calls the
+ * instantiated read loop directly instead of through a virtual handleRead.
+ */
+class ATU_API StaticReceiverBase : protected PacketReceiver {
+    public:
+        Result<void> unsubscribe(uint16_t localPort) override;
+        using PacketReceiver::getFd;
+
+    protected:
+        // Context of one registered socket
+        struct Socket {
+            StaticReceiverBase* owner;
+            int fd;
+            uint16_t port;
+            uint16_t weight;
+        };
+
+        StaticReceiverBase(EventLoop& loop, ReceiverConfig config);
+        ~StaticReceiverBase() override;
+
+        /**
+         * @brief Opens and registers a socket whose readiness calls onReadable(Socket*, events).
+         * @return The local port actually bound (resolves port 0).
+         */
+        [[nodiscard]] Result<int> addSocket(uint16_t localPort, const SubscribeOptions& options,
+                EventCallbackFn onReadable);
+
+        // Sources are callbacks: the EventLoop never calls this
+        void handleRead(int, void*, PacketHandlerFn) override {}
+
+        // Edge-triggered mode: reports a socket left non-empty again on the next wait
+        void rearm(int fd);
+
+        // Bumped by unsubscribe: a handler may close the socket being drained
+        uint64_t m_epoch = 0;
+
+    private:
+        std::map<uint16_t, std::unique_ptr<Socket>> m_sockets;
+};
+
+/**
+ * @class StaticUDPReceiver
+ * @brief UDPReceiver front end with the handler type, batch size, buffer size
+ * and timestamp mode fixed at compile time.
+ * The recvmmsg loop, the control message walk for the selected timestamp
+ * source and the handler call are instantiated together and inlined; GRO,
+ * statistics and the buffer pool are not compiled in (use UDPReceiver).
+ * Handler is any callable taking const PacketMetadata&, called once per datagram.
+ * ReceiverConfig supplies the remaining run-time knobs (maxFds, busy polling,
+ * hwTimestampInterface, edgeTriggered and readBudget).
+ *
+ * @note Thread-hostile, like UDPReceiver.
+ */
+template <typename Handler, typename Config = StaticReceiverConfig<>>
+class StaticUDPReceiver : public StaticReceiverBase {
+    public:
+        explicit StaticUDPReceiver(EventLoop& loop, Handler handler = Handler{}, ReceiverConfig config = {})
+                : StaticReceiverBase(loop, layout(config)), m_handler(std::move(handler))
+        {
+            for (int i = 0; i < BATCH; ++i) {
+                struct msghdr& h = m_msgs[i].msg_hdr;
+                h.msg_iov = &m_ioVectors[i];
+                h.msg_iovlen = 1;
+                h.msg_name = &m_senders[i];
+                h.msg_control = (TIMESTAMPS != TimestampSource::NONE) ? m_control[i].data() : nullptr;
+            }
+        }
+
+        /**
+         * @brief Binds localPort (0 picks a free one) and delivers its datagrams to the handler.
+         * @return The local port actually bound.
+         */
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, const SubscribeOptions& options = {}) {
+            return addSocket(localPort, options, &StaticUDPReceiver::onReadable);
+        }
+
+        Handler& handler() { return m_handler; }
+        const Handler& handler() const { return m_handler; }
+
+    private:
+        static constexpr int BATCH = Config::batchSize;
+        static constexpr size_t STRIDE = (static_cast<size_t>(Config::bufferSize) + 63) & ~size_t(63);
+        static constexpr TimestampSource TIMESTAMPS = Config::timestamps;
+
+        // SCM_TIMESTAMPNS carries one timespec, SCM_TIMESTAMPING three
+        static constexpr size_t CONTROL_SIZE =
+            TIMESTAMPS == TimestampSource::NONE ? 1
+            : TIMESTAMPS == TimestampSource::SOFTWARE ? CMSG_SPACE(sizeof(struct timespec))
+            : CMSG_SPACE(3 * sizeof(struct timespec));
+
+        static ReceiverConfig layout(ReceiverConfig config) {
+            config.batchSize = Config::batchSize;
+            config.bufferSize = Config::bufferSize;
+            config.timestamps = TIMESTAMPS;
+            config.enableGro = false;
+            config.enableStats = false;
+            config.poolSlots = 0;
+            return config;
+        }
+
+        static void onReadable(void* context, uint32_t) {
+            auto* sock = static_cast<Socket*>(context);
+            static_cast<StaticUDPReceiver*>(sock->owner)->drain(sock->fd, sock->port, sock->weight);
+        }
+
+        void drain(int fd, uint16_t port, int rounds) {
+            checkThread();
+
+            int budget = m_config.readBudget * rounds;
+            const uint64_t epoch = m_epoch;
+            while (true) {
+                const int numPackets = readBatch(fd, port);
+                if (numPackets < BATCH || epoch != m_epoch) return;
+
+                // Level-triggered sockets are reported again while data is queued
+                if (!m_config.edgeTriggered) {
+                    if (--rounds <= 0) return;
+                    continue;
+                }
+                if (m_config.readBudget > 0 && (budget -= numPackets) <= 0) {
+                    rearm(fd);
+                    return;
+                }
+            }
+        }
+
+        // One recvmmsg, delivered packet by packet
+        int readBatch(int fd, uint16_t port) {
+            for (int i = 0; i < BATCH; ++i) {
+                m_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+                if constexpr (TIMESTAMPS != TimestampSource::NONE) {
+                    m_msgs[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+                }
+            }
+
+            const int numPackets = ::recvmmsg(fd, m_msgs.data(), BATCH, MSG_DONTWAIT, nullptr);
+
+            for (int k = 0; k < numPackets; ++k) {
+                const struct msghdr& h = m_msgs[k].msg_hdr;
+                PacketMetadata meta;
+                meta.status = (h.msg_flags & MSG_TRUNC) ? PacketStatus::TRUNCATED : PacketStatus::OK;
+                meta.ts = {0, 0};
+                meta.hwTs = {0, 0};
+
+                if constexpr (TIMESTAMPS != TimestampSource::NONE) {
+                    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&h); cmsg != nullptr;
+                         cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&h), cmsg)) {
+                        if (cmsg->cmsg_level != SOL_SOCKET) continue;
+
+                        if constexpr (TIMESTAMPS == TimestampSource::SOFTWARE) {
+                            if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                                std::memcpy(&meta.ts, CMSG_DATA(cmsg), sizeof(meta.ts));
+                            }
+                        } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                            // ts[0] software, ts[1] deprecated, ts[2] raw hardware
+                            struct timespec stamps[3];
+                            std::memcpy(stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                            meta.ts = stamps[0];
+                            if (stamps[2].tv_sec != 0 || stamps[2].tv_nsec != 0) {
+                                meta.hwTs = stamps[2];
+                                meta.status |= PacketStatus::HW_TIMESTAMP;
+                            }
+                        }
+                    }
+                }
+
+                meta.len = m_msgs[k].msg_len;
+                meta.destPort = port;
+                meta.sender = &m_senders[k];
+                meta.data = m_cachedBasePtr + static_cast<size_t>(k) * STRIDE;
+                m_handler(static_cast<const PacketMetadata&>(meta));
+            }
+            return numPackets;
+        }
+
+        Handler m_handler;
+        std::array<struct mmsghdr, BATCH> m_msgs{};
+        std::array<struct sockaddr_storage, BATCH> m_senders{};
+        alignas(struct cmsghdr) std::array<std::array<uint8_t, CONTROL_SIZE>, BATCH> m_control{};
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
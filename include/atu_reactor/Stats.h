@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace atu_reactor {
+
+/**
+ * @class RelaxedCounter
+ * @brief Counter with a single writer (the reactor thread) and any number of readers.
+ * The writer updates it with a plain load/store pair instead of a locked
+ * read-modify-write; readers on other threads always see a whole value.
+ */
+class RelaxedCounter {
+    public:
+        RelaxedCounter() = default;
+        RelaxedCounter(const RelaxedCounter& other) : m_value(other.load()) {}
+        RelaxedCounter& operator=(const RelaxedCounter& other) {
+            m_value.store(other.load(), std::memory_order_relaxed);
+            return *this;
+        }
+
+        // Writer side
+        void add(uint64_t n) { m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        void set(uint64_t v) { m_value.store(v, std::memory_order_relaxed); }
+        RelaxedCounter& operator++() { add(1); return *this; }
+        RelaxedCounter& operator++(int) { add(1); return *this; }
+        RelaxedCounter& operator+=(uint64_t n) { add(n); return *this; }
+
+        // Any thread
+        uint64_t load() const { return m_value.load(std::memory_order_relaxed); }
+        operator uint64_t() const { return load(); }
+
+    private:
+        std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear histogram of nanosecond values, single writer, lock-free readers.
+ * Each power of two is split into 8 linear buckets, bounding the relative
+ * error to 12.5% over the whole 64-bit range with 496 counters.
+ */
+class LatencyHistogram {
+    public:
+        static constexpr int SUB_BITS = 3;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BITS;
+        static constexpr int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+        static int bucketOf(uint64_t value) {
+            if (value < SUB_BUCKETS) return static_cast<int>(value);
+            int exponent = 63 - __builtin_clzll(value);
+            int sub = static_cast<int>((value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1));
+            return (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+        }
+
+        // Smallest value that lands in bucket
+        static uint64_t lowerBound(int bucket) {
+            if (bucket < SUB_BUCKETS) return static_cast<uint64_t>(bucket);
+            int exponent = bucket / SUB_BUCKETS + SUB_BITS - 1;
+            uint64_t sub = static_cast<uint64_t>(bucket % SUB_BUCKETS);
+            return (SUB_BUCKETS + sub) << (exponent - SUB_BITS);
+        }
+
+        // Writer side
+        void record(uint64_t value) {
+            m_buckets[static_cast<size_t>(bucketOf(value))]++;
+            m_count++;
+        }
+
+        // Any thread
+        uint64_t count() const { return m_count.load(); }
+        uint64_t bucket(int index) const { return m_buckets[static_cast<size_t>(index)].load(); }
+
+        /**
+         * @brief Lower bound of the bucket holding the given quantile (0.0 - 1.0).
+         * Concurrent updates may make the result lag by a few samples.
+         */
+        uint64_t quantile(double q) const {
+            const uint64_t total = count();
+            if (total == 0) return 0;
+
+            auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (int i = 0; i < BUCKETS; ++i) {
+                seen += bucket(i);
+                if (seen >= rank) return lowerBound(i);
+            }
+            return lowerBound(BUCKETS - 1);
+        }
+
+    private:
+        std::array<RelaxedCounter, BUCKETS> m_buckets{};
+        RelaxedCounter m_count;
+};
+
+/**
+ * @brief Per-subscription counters, kept alive by the shared_ptr handed out.
+ */
+struct PortStats {
+    RelaxedCounter packets;
+    RelaxedCounter bytes;
+    RelaxedCounter truncated;       // PacketStatus::TRUNCATED
+    RelaxedCounter kernelDrops;     // Last SO_RXQ_OVFL value: cumulative socket queue drops
+};
+
+/**
+ * @brief Receiver-wide counters.
+ */
+struct ReceiverStats {
+    // batchFill[0] counts empty reads, batchFill[b] reads of [2^(b-1), 2^b) datagrams
+    static constexpr int FILL_BUCKETS = 17;
+    std::array<RelaxedCounter, FILL_BUCKETS> batchFill{};
+
+    RelaxedCounter batches;
+    RelaxedCounter packets;
+
+    // Kernel software timestamp to dispatch, in nanoseconds
+    LatencyHistogram latency;
+
+    static int fillBucket(int count) {
+        if (count <= 0) return 0;
+        int bucket = 32 - __builtin_clz(static_cast<unsigned>(count));
+        return bucket < FILL_BUCKETS ? bucket : FILL_BUCKETS - 1;
+    }
+};
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
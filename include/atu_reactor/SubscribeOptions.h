@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <linux/filter.h>
+#include <string>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/Types.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief One multicast membership, any-source or source-specific.
+ */
+struct MulticastJoin {
+    std::string group;      // IPv4 or IPv6 group address
+    std::string source;     // Source for SSM (MCAST_JOIN_SOURCE_GROUP), "" for ASM
+};
+
+/**
+ * @brief Per-subscription socket options for UDPReceiver.
+ * The defaults reproduce the plain subscribe(): bound to the wildcard
+ * address, kernel default receive buffer, no filter.
+ */
+struct SubscribeOptions {
+    // Local address to bind, "" for any. Binding to the multicast group
+    // itself keeps unicast traffic to the same port out of the socket.
+    std::string bindAddress;
+
+    // SO_BINDTODEVICE, also the interface multicast groups are joined on
+    std::string interface;
+
+    std::vector<MulticastJoin> joins;
+
+    int rcvbuf = 0;             // SO_RCVBUF bytes, 0 = kernel default
+    bool forceRcvbuf = false;   // SO_RCVBUFFORCE: ignore net.core.rmem_max (CAP_NET_ADMIN)
+
+    // Classic BPF program attached with SO_ATTACH_FILTER before bind.
+    // Offsets are relative to the UDP header (payload starts at 8); return
+    // 0 to drop a datagram in the kernel.
+    std::vector<struct sock_filter> filter;
+
+    // Dispatch class of the socket on the EventLoop
+    Priority priority = Priority::NORMAL;
+
+    // recvmmsg calls allowed per wakeup; edge-triggered receivers scale
+    // ReceiverConfig::readBudget by it instead. A weight 4 feed drains four
+    // times as much per iteration as a weight 1 feed sharing the loop.
+    uint16_t weight = 1;
+};
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace atu_reactor {
+
+/**
+ * @class InlineTask
+ * @brief Move-only void() callable stored in a fixed inline buffer.
+ * Callables up to CAPACITY bytes (a lambda capturing a few pointers, a
+ * std::function, a raw function + context pair) never touch the heap.
+ * Larger ones are boxed so that any callable is still accepted.
+ */
+class InlineTask {
+    public:
+        static constexpr size_t CAPACITY = 48;
+
+        template <typename F, typename = std::enable_if_t<
+            !std::is_same_v<std::decay_t<F>, InlineTask> &&
+            std::is_invocable_v<std::decay_t<F>&>>>
+        InlineTask(F&& f) {
+            using Fn = std::decay_t<F>;
+            if constexpr (fitsInline<Fn>()) {
+                emplace<Fn>(std::forward<F>(f));
+            } else {
+                // Cold path: the box itself fits inline
+                emplace<Boxed<Fn>>(Boxed<Fn>{std::make_unique<Fn>(std::forward<F>(f))});
+            }
+        }
+
+        // Matches the PacketHandlerFn style: no capture, no type erasure cost
+        InlineTask(void (*fn)(void*), void* context) {
+            emplace<RawCall>(RawCall{fn, context});
+        }
+
+        InlineTask(InlineTask&& other) noexcept
+            : m_invoke(other.m_invoke), m_manage(other.m_manage)
+        {
+            relocateFrom(other);
+        }
+
+        InlineTask& operator=(InlineTask&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_invoke = other.m_invoke;
+                m_manage = other.m_manage;
+                relocateFrom(other);
+            }
+            return *this;
+        }
+
+        ~InlineTask() { reset(); }
+
+        void operator()() { m_invoke(m_storage); }
+
+        InlineTask(const InlineTask&) = delete;
+        InlineTask& operator=(const InlineTask&) = delete;
+
+    private:
+        using InvokeFn = void (*)(void* storage);
+        // dst == nullptr destroys src, otherwise moves src into dst and destroys src
+        using ManageFn = void (*)(void* dst, void* src);
+
+        struct RawCall {
+            void (*fn)(void*);
+            void* context;
+            void operator()() const { fn(context); }
+        };
+
+        template <typename Fn>
+        struct Boxed {
+            std::unique_ptr<Fn> fn;
+            void operator()() const { (*fn)(); }
+        };
+
+        template <typename Fn>
+        static constexpr bool fitsInline() {
+            return sizeof(Fn) <= CAPACITY &&
+                alignof(Fn) <= alignof(std::max_align_t) &&
+                std::is_nothrow_move_constructible_v<Fn>;
+        }
+
+        template <typename Fn, typename Arg>
+        void emplace(Arg&& arg) {
+            ::new (static_cast<void*>(m_storage)) Fn(std::forward<Arg>(arg));
+            m_invoke = [](void* s) { (*static_cast<Fn*>(s))(); };
+
+            // Trivial callables (the common [this] lambda) are moved with memcpy
+            if constexpr (!std::is_trivially_copyable_v<Fn>) {
+                m_manage = [](void* dst, void* src) {
+                    Fn* from = static_cast<Fn*>(src);
+                    if (dst) ::new (dst) Fn(std::move(*from));
+                    from->~Fn();
+                };
+            }
+        }
+
+        void relocateFrom(InlineTask& other) noexcept {
+            if (m_manage) m_manage(m_storage, other.m_storage);
+            else std::memcpy(m_storage, other.m_storage, CAPACITY);
+            other.m_invoke = nullptr;
+            other.m_manage = nullptr;
+        }
+
+        void reset() noexcept {
+            if (m_manage) m_manage(nullptr, m_storage);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[CAPACITY];
+        InvokeFn m_invoke = nullptr;
+        ManageFn m_manage = nullptr;
+};
+
+/**
+ * @class TaskQueue
+ * @brief Double-buffered queue of InlineTask.
+ * Tasks pushed while draining land in the other buffer and run on the
+ * next drain. Both buffers keep their capacity, so once they have grown
+ * to the high-water mark neither push nor drain allocates.
+ */
+class TaskQueue {
+    public:
+        template <typename F>
+        void push(F&& f) { m_queues[m_active].emplace_back(std::forward<F>(f)); }
+
+        void push(void (*fn)(void*), void* context) {
+            m_queues[m_active].emplace_back(fn, context);
+        }
+
+        bool empty() const { return m_queues[m_active].empty(); }
+
+        /**
+         * @brief Runs every task queued before the call.
+         */
+        void drain() {
+            std::vector<InlineTask>& tasks = m_queues[m_active];
+            m_active ^= 1;
+
+            for (auto& task : tasks) {
+                task();
+            }
+            tasks.clear();
+        }
+
+    private:
+        std::vector<InlineTask> m_queues[2];
+        int m_active = 0;
+};
+
+/**
+ * @class MpscTaskQueue
+ * @brief Unbounded lock-free multi-producer single-consumer queue of InlineTask.
+ * Intrusive Vyukov queue with a stub node: push is one exchange plus one
+ * store from any thread, pop is wait-free for the single consumer. Each
+ * push allocates its node on the producing thread.
+ */
+class MpscTaskQueue {
+    public:
+        MpscTaskQueue() : m_head(new Node), m_tail(m_head) {}
+
+        ~MpscTaskQueue() {
+            while (m_head) {
+                Node* next = m_head->next.load(std::memory_order_relaxed);
+                delete m_head;
+                m_head = next;
+            }
+        }
+
+        // Any thread
+        template <typename F>
+        void push(F&& f) { link(new Node(std::forward<F>(f))); }
+
+        void push(void (*fn)(void*), void* context) { link(new Node(fn, context)); }
+
+        /**
+         * @brief Runs every task that is fully linked. Consumer thread only.
+         * @return false if a producer was caught between its two steps: that
+         *         task is not visible yet and drain() must be called again.
+         */
+        bool drain() {
+            for (;;) {
+                Node* next = m_head->next.load(std::memory_order_acquire);
+                if (next == nullptr) {
+                    return m_tail.load(std::memory_order_seq_cst) == m_head;
+                }
+
+                // next becomes the new stub once its task is taken out
+                delete m_head;
+                m_head = next;
+
+                InlineTask task = std::move(*next->task);
+                next->task.reset();
+                task();
+            }
+        }
+
+        MpscTaskQueue(const MpscTaskQueue&) = delete;
+        MpscTaskQueue& operator=(const MpscTaskQueue&) = delete;
+
+    private:
+        struct Node {
+            Node() = default;
+
+            template <typename... Args>
+            explicit Node(Args&&... args) : task(std::in_place, std::forward<Args>(args)...) {}
+
+            std::atomic<Node*> next{nullptr};
+            std::optional<InlineTask> task;
+        };
+
+        void link(Node* node) {
+            Node* prev = m_tail.exchange(node, std::memory_order_seq_cst);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        Node* m_head;                                       // Consumer side
+        alignas(64) std::atomic<Node*> m_tail;              // Producer side
+};
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
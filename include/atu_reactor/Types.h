@@ -22,10 +22,13 @@
 
 namespace atu_reactor {
 
+    struct PacketMetadata;
+
     // Status bitmask for robustness
     enum PacketStatus : uint32_t {
         OK = 0,
         TRUNCATED = 1 << 0,   // Data was larger than buffer
+        HW_TIMESTAMP = 1 << 1, // PacketMetadata::hwTs holds a NIC timestamp
     };
 
     // Define the function pointer type here
@@ -35,6 +38,29 @@ namespace atu_reactor {
                                      uint32_t status,
                                      struct timespec ts);
 
+    /**
+     * Batch variant: called once per receive batch.
+     * Payload i starts at packets[i].data; when base is not null the payloads
+     * are also laid out at base + i * stride in the receiver flat buffer.
+     */
+    using PacketBatchHandlerFn = void (*)(void* context,
+                                          int count,
+                                          const PacketMetadata* packets,
+                                          const uint8_t* base,
+                                          size_t stride);
+
+    /**
+     * Service class of an EventLoop source or deferred task. Within one
+     * runOnce, ready sources of a higher class are dispatched first.
+     */
+    enum class Priority : uint8_t {
+        HIGH = 0,
+        NORMAL = 1,
+        LOW = 2
+    };
+
+    constexpr int PRIORITY_CLASSES = 3;
+
 }  // namespace atu_reactor
 
 
@@ -21,12 +21,17 @@
 #include <atu_reactor/PacketReceiver.h>
 
 // System headers
+#include <map>
+#include <memory>
 #include <netinet/in.h>
 #include <vector>
 #include <sys/socket.h>
 
 // Library headers
+#include <atu_reactor/BufferPool.h>
 #include <atu_reactor/Export.h>
+#include <atu_reactor/Stats.h>
+#include <atu_reactor/SubscribeOptions.h>
 
 namespace atu_reactor {
 
@@ -51,7 +56,7 @@ class ATU_API UDPReceiver : public PacketReceiver {
         explicit UDPReceiver(EventLoop& loop, ReceiverConfig config = {});
 
         // Destructor ensures FDs are removed from the EventLoop before closing
-        ~UDPReceiver() override = default;
+        ~UDPReceiver() override;
 
         /**
          * @brief Creates a UDP socket, binds it to localPort, and registers it with the EventLoop.
@@ -61,6 +66,49 @@ class ATU_API UDPReceiver : public PacketReceiver {
          */
         [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler);
 
+        /**
+         * @brief Same as subscribe, but the handler is called once per recvmmsg batch.
+         * Payloads are passed as the flat buffer base and stride plus one
+         * PacketMetadata entry per datagram (zero-length datagrams included).
+         * When GRO splits a super-datagram, base is nullptr for that batch; in
+         * pooled mode (ReceiverConfig::poolSlots) base is always nullptr.
+         */
+        [[nodiscard]] Result<int> subscribeBatch(uint16_t localPort, void* context, PacketBatchHandlerFn handler) override;
+
+        /**
+         * @brief subscribe with per-socket options: bind address or device,
+         * multicast (including source-specific) joins, SO_RCVBUF and an
+         * in-kernel BPF filter.
+         */
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, const SubscribeOptions& options,
+                void* context, PacketHandlerFn handler);
+
+        [[nodiscard]] Result<int> subscribeBatch(uint16_t localPort, const SubscribeOptions& options,
+                void* context, PacketBatchHandlerFn handler);
+
+        Result<void> unsubscribe(uint16_t localPort) override;
+
+        /**
+         * @brief Receiver-wide counters (all zero unless enableStats).
+         * The object lives as long as the receiver and may be read from any thread.
+         */
+        const ReceiverStats& stats() const { return m_stats; }
+
+        /**
+         * @brief Counters of one subscription, or nullptr without enableStats.
+         * Must be called on the owner thread; the returned object may then be
+         * read from any thread and outlives unsubscribe().
+         */
+        std::shared_ptr<const PortStats> portStats(uint16_t localPort) const;
+
+        /**
+         * @brief The packet pool (ReceiverConfig::poolSlots), or nullptr.
+         * Handlers retain a payload with bufferPool()->lease(data, len); the slot
+         * is then skipped by later reads until every lease is gone. Hold this
+         * pointer as long as leases may outlive the receiver.
+         */
+        const std::shared_ptr<BufferPool>& bufferPool() const { return m_pool; }
+
         // Disable copy/move to strictly manage resource identity
         UDPReceiver(const UDPReceiver&) = delete;
         UDPReceiver& operator=(const UDPReceiver&) = delete;
@@ -71,9 +119,61 @@ class ATU_API UDPReceiver : public PacketReceiver {
         /**
          * @brief Internal callback triggered by EventLoop when a socket has data.
          */
-        void handleRead(int fd, void* context, PacketHandlerFn handler);
+        void handleRead(int fd, void* context, PacketHandlerFn handler) override;
+        void handleRead(int fd, void* context, PacketHandlerFn handler, PortStats* stats,
+                uint16_t weight = 1);
+
+        /**
+         * @brief Batch counterpart of handleRead, used by subscribeBatch sockets.
+         */
+        void handleReadBatch(int fd, uint16_t port, void* context, PacketBatchHandlerFn handler,
+                PortStats* stats, uint16_t weight = 1);
 
     private:
+        // Largest datagram the kernel can coalesce with UDP_GRO
+        static constexpr int GRO_BUFFER_SIZE = 65535;
+
+        // Kernel limit on segments per GRO super-datagram (UDP_GRO_CNT_MAX)
+        static constexpr int GRO_MAX_SEGMENTS = 64;
+
+        // Room for SCM_TIMESTAMPING (software, legacy, hardware), the UDP_GRO
+        // segment size and the SO_RXQ_OVFL drop counter
+        static constexpr size_t CONTROL_SPACE =
+            CMSG_SPACE(3 * sizeof(struct timespec)) + CMSG_SPACE(sizeof(int)) +
+            CMSG_SPACE(sizeof(uint32_t));
+
+        static ReceiverConfig bufferLayout(ReceiverConfig config);
+
+        // Opens the socket and applies the per-receiver options (GRO, busy polling)
+        Result<uint16_t> openSocket(uint16_t port, const SubscribeOptions& options, ScopedFd& sock);
+
+        // Allocates the subscription counters and enables SO_RXQ_OVFL (enableStats only)
+        Result<PortStats*> attachStats(uint16_t port, int fd);
+
+        /**
+         * @brief Pooled mode: swaps retained slots for free ones and packs the
+         * usable slots at the front of the iovec array.
+         * @return Number of slots ready for recvmmsg.
+         */
+        int armSlots();
+
+        /**
+         * @brief Pulls one recvmmsg batch and fills m_metadata.
+         * GRO super-datagrams are split into one entry per segment.
+         * @return Number of metadata entries (0 on error or empty socket).
+         */
+        int receiveBatch(int fd, uint16_t port, PortStats* stats);
+
+        /**
+         * @brief True while the socket may hold more datagrams and the wakeup
+         * allows another read: rounds (the subscription weight) in level-triggered
+         * mode, budget in edge-triggered mode, which re-arms the fd when it yields early.
+         */
+        inline bool readAgain(int fd, int& budget, int& rounds, uint64_t epoch) noexcept;
+
+        // EPOLLIN, plus EPOLLET in edge-triggered mode
+        uint32_t sourceEvents() const;
+
         /**
          * Memory structures for recvmmsg.
          * Pre-allocated based on m_config to avoid heap allocation during the hot path.
@@ -84,7 +184,31 @@ class ATU_API UDPReceiver : public PacketReceiver {
         std::vector<struct sockaddr_storage> m_senderAddrs;
 
         // Add a member to hold control buffers for the batch
-        std::vector<std::array<uint8_t, CMSG_SPACE(sizeof(struct timespec))>> m_controlBuffers;
+        std::vector<std::array<uint8_t, CONTROL_SPACE>> m_controlBuffers;
+
+        // Normalized view of the last batch
+        std::vector<PacketMetadata> m_metadata;
+
+        // Set when the last batch split a super-datagram (base/stride no longer apply)
+        bool m_batchSplit = false;
+
+        // Datagrams read by the last recvmmsg, and whether it found the queue empty
+        int m_lastRead = 0;
+        bool m_drained = true;
+
+        // Bumped by unsubscribe: a handler may close the socket being drained
+        uint64_t m_epoch = 0;
+
+        // False when neither timestamps, GRO nor stats are enabled: no control messages to read
+        bool m_wantControl = true;
+
+        ReceiverStats m_stats;
+        std::map<uint16_t, std::shared_ptr<PortStats>> m_portStats;
+
+        // Pooled mode: the slot behind each iovec, and how many the last read filled
+        std::shared_ptr<BufferPool> m_pool;
+        std::vector<uint32_t> m_slots;
+        int m_slotsUsed = 0;
 };
 
 }  // namespace atu_reactor
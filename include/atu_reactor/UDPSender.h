@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/Export.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/ScopedFd.h>
+
+namespace atu_reactor {
+
+/**
+ * @brief Configuration for UDPSender performance tuning.
+ */
+struct SenderConfig {
+    int ringSize = 1024;      // Datagrams that can be queued between flushes
+    int bufferSize = 2048;    // Max payload per datagram
+    int batchSize = 64;       // Max messages per sendmmsg
+    bool enableGso = false;   // Coalesce same-destination bursts with UDP_SEGMENT
+
+    // SO_TXTIME: datagrams sent with a txTime leave at that time, scheduled by
+    // the qdisc (fq with CLOCK_MONOTONIC, ETF with CLOCK_TAI)
+    bool enableTxTime = false;
+    clockid_t txClock = CLOCK_MONOTONIC;
+};
+
+/**
+ * @class UDPSender
+ * @brief Queues outgoing datagrams and sends them in sendmmsg batches.
+ * Payloads are copied into a preallocated hugepage ring. The queue is
+ * flushed by the EventLoop before it waits and after each dispatch round,
+ * so every datagram queued from a handler leaves in the same iteration.
+ *
+ * With enableGso, runs of equal-sized datagrams to the same destination
+ * are handed to the kernel as a single UDP_SEGMENT message.
+ *
+ * When the socket buffer is full the sender stops flushing and waits for
+ * EPOLLOUT; send() reports ENOBUFS once the ring itself is full.
+ *
+ * With enableTxTime, each datagram can carry a launch time (SCM_TXTIME).
+ * If the kernel refuses SO_TXTIME (old kernel, or CLOCK_TAI without
+ * CAP_NET_ADMIN) launch times are ignored and datagrams leave on flush.
+ *
+ * @note This class is THREAD-HOSTILE, like UDPReceiver.
+ */
+class ATU_API UDPSender {
+    // Grant EventLoop access to handleWrite
+    friend class EventLoop;
+
+    public:
+        /**
+         * @brief Constructor
+         * @throws std::runtime_error if the socket or the ring cannot be created.
+         */
+        explicit UDPSender(EventLoop& loop, SenderConfig config = {});
+
+        // Destructor tries a last flush, then detaches from the EventLoop
+        ~UDPSender();
+
+        /**
+         * @brief Copies a datagram into the send ring.
+         * @param dest IPv4 or IPv6 destination (IPv4 is mapped on dual-stack sockets).
+         * @return EMSGSIZE if len > bufferSize, ENOBUFS if the ring is full.
+         */
+        [[nodiscard]] Result<void> send(const struct sockaddr* dest, socklen_t destLen,
+                const uint8_t* data, size_t len);
+
+        /**
+         * @brief Same as send(), launched at txTimeNs on SenderConfig::txClock.
+         * @param txTimeNs Launch time in nanoseconds, 0 = as soon as flushed.
+         */
+        [[nodiscard]] Result<void> send(const struct sockaddr* dest, socklen_t destLen,
+                const uint8_t* data, size_t len, uint64_t txTimeNs);
+
+        /**
+         * @brief Sends everything queued now instead of waiting for the loop.
+         */
+        Result<void> flush();
+
+        // Number of datagrams still waiting in the ring
+        size_t pending() const { return static_cast<size_t>(m_tail - m_head); }
+
+        // Datagrams dropped because the kernel rejected them
+        uint64_t errors() const { return m_errors; }
+
+        // True if the kernel accepted SO_TXTIME, so launch times are honoured
+        bool txTimeEnabled() const { return m_txTime; }
+
+        // Disable copy/move to strictly manage resource identity
+        UDPSender(const UDPSender&) = delete;
+        UDPSender& operator=(const UDPSender&) = delete;
+        UDPSender(UDPSender&&) = delete;
+        UDPSender& operator=(UDPSender&&) = delete;
+
+    private:
+        // Destination in the socket's own address family
+        union Destination {
+            struct sockaddr_in v4;
+            struct sockaddr_in6 v6;
+        };
+
+        struct Slot {
+            Destination dest;
+            socklen_t destLen;
+            uint64_t txTime;    // SCM_TXTIME launch time, 0 = none
+        };
+
+        // Called by the EventLoop once the socket is writable again
+        void handleWrite();
+
+        static void onFlushHook(void* context);
+
+        // Builds up to batchSize messages starting at m_head
+        int buildBatch(int& segments);
+
+        EventLoop& m_loop;
+        SenderConfig m_config;
+        ScopedFd m_fd;
+        bool m_isV6 = true;
+        bool m_gso = false;
+        bool m_txTime = false;
+        bool m_blocked = false;     // Waiting for EPOLLOUT
+
+        size_t m_alignedBufferSize = 0;
+        uint8_t* m_buffer = nullptr;
+        size_t m_mappedSize = 0;
+
+        // Ring indices: [m_head, m_tail) are queued
+        uint64_t m_head = 0;
+        uint64_t m_tail = 0;
+        uint64_t m_errors = 0;
+
+        std::vector<Slot> m_slots;
+        std::vector<struct iovec> m_ioVectors;      // One per slot, contiguous for GSO runs
+        std::vector<struct mmsghdr> m_msgHeaders;
+        std::vector<int> m_msgSegments;             // Slots covered by each message
+        std::vector<std::array<uint8_t, CMSG_SPACE(sizeof(uint16_t)) + CMSG_SPACE(sizeof(uint64_t))>> m_controlBuffers;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
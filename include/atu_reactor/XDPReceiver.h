@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Inherits from
+#include <atu_reactor/PacketReceiver.h>
+
+// System headers
+#include <linux/if_xdp.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/Export.h>
+
+namespace atu_reactor {
+
+enum class XDPBindMode {
+    AUTO,       // Let the kernel pick zero-copy if the driver supports it
+    COPY,       // Force copy mode (works on every driver)
+    ZEROCOPY    // Fail if the driver cannot do zero-copy
+};
+
+/**
+ * @brief Configuration for the AF_XDP backend.
+ * batchSize is the number of RX descriptors consumed per wakeup and
+ * bufferSize is the UMEM frame size (must be 2048 or 4096).
+ * maxFds does not apply: every port is served by the one AF_XDP socket.
+ */
+struct XDPConfig : public ReceiverConfig {
+    uint32_t frameCount = 4096;     // UMEM frames (packet buffers)
+    uint32_t ringSize = 2048;       // Fill/RX ring entries (power of two)
+    XDPBindMode bindMode = XDPBindMode::AUTO;
+    bool attachProgram = true;      // Load the built-in port filter program
+    bool genericXdp = false;        // Attach in SKB mode (no driver support needed)
+};
+
+/**
+ * @class XDPReceiver
+ * @brief Receives UDP datagrams from a NIC queue through an AF_XDP socket.
+ * The PacketReceiver flat buffer is registered as the UMEM, so packets are
+ * DMA'ed (zero-copy mode) or copied once (copy mode) straight into it and
+ * handed to the same PacketHandlerFn used by UDPReceiver.
+ *
+ * A small XDP program redirects IPv4/IPv6 UDP datagrams whose destination
+ * port is subscribed; everything else goes on to the kernel stack.
+ *
+ * @note Requires CAP_NET_ADMIN/CAP_BPF and a kernel with BPF links (5.9+).
+ * AF_XDP provides no kernel timestamp: packets are stamped with
+ * CLOCK_REALTIME once per batch.
+ */
+class ATU_API XDPReceiver : public PacketReceiver {
+    // Grant EventLoop access to private members like handleRead
+    friend class EventLoop;
+
+    public:
+        /**
+         * @brief Constructor
+         * @param loop Reference to the external event loop.
+         * @param config Optional tuning parameters for UMEM and rings.
+         */
+        explicit XDPReceiver(EventLoop& loop, XDPConfig config = {});
+
+        // Destructor detaches the program and unmaps the rings
+        ~XDPReceiver() override;
+
+        /**
+         * @brief Binds an AF_XDP socket to one queue of a network interface.
+         * @param interface Interface name (e.g. "eth0").
+         * @param queueId Hardware RX queue to bind to.
+         */
+        [[nodiscard]] Result<void> open(const std::string& interface, uint32_t queueId = 0);
+
+        /**
+         * @brief Subscribes to UDP datagrams with the given destination port.
+         * The port is added to the XDP program's filter map.
+         */
+        [[nodiscard]] Result<int> subscribe(uint16_t localPort, void* context, PacketHandlerFn handler) override;
+
+        [[nodiscard]] Result<void> unsubscribe(uint16_t port) override;
+
+        // Disable copy/move to strictly manage resource identity
+        XDPReceiver(const XDPReceiver&) = delete;
+        XDPReceiver& operator=(const XDPReceiver&) = delete;
+        XDPReceiver(XDPReceiver&&) = delete;
+        XDPReceiver& operator=(XDPReceiver&&) = delete;
+
+    protected:
+        /**
+         * @brief Internal callback triggered by EventLoop when the RX ring has data.
+         */
+        void handleRead(int fd, void* context, PacketHandlerFn handler) override;
+
+    private:
+        // Mapping of one of the shared producer/consumer rings
+        struct Ring {
+            uint32_t* producer = nullptr;
+            uint32_t* consumer = nullptr;
+            uint32_t* flags = nullptr;
+            void* descs = nullptr;
+            uint32_t mask = 0;
+            void* map = nullptr;
+            size_t mapSize = 0;
+        };
+
+        struct Subscription {
+            void* context = nullptr;
+            PacketHandlerFn handler = nullptr;
+        };
+
+        // Derives the PacketReceiver layout (one slot per UMEM frame)
+        static ReceiverConfig umemLayout(const XDPConfig& config);
+
+        Result<void> mapRing(Ring& ring, size_t descSize, uint64_t pgoff,
+                const struct xdp_ring_offset& off);
+        Result<void> loadProgram(int ifindex, uint32_t queueId);
+        void updatePortMap(uint16_t port, bool enabled);
+        void refill(const uint64_t* frames, uint32_t n);
+        void close();
+
+        XDPConfig m_xdpConfig;
+
+        ScopedFd m_xskFd;
+        ScopedFd m_portMapFd;
+        ScopedFd m_xskMapFd;
+        ScopedFd m_progFd;
+        ScopedFd m_linkFd;
+
+        Ring m_fill;
+        Ring m_completion;
+        Ring m_rx;
+
+        // Frames not currently owned by the kernel
+        std::vector<uint64_t> m_spareFrames;
+        std::vector<uint64_t> m_recycled;
+
+        // Port (Network Byte Order) -> Handler info
+        std::unique_ptr<Subscription[]> m_portTable;
+};
+
+}  // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
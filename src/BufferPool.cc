@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/BufferPool.h>
+
+// System headers
+#include <stdexcept>
+#include <sys/mman.h>
+
+// Library headers
+#include "HugePages.h"
+#include "Numa.h"
+
+namespace atu_reactor {
+
+BufferPool::BufferPool(size_t slots, size_t slotSize, int numaNode, bool prefault)
+        : m_slots(slots),
+        m_slotSize((slotSize + 63) & ~size_t{63}),
+        m_refs(new std::atomic<uint32_t>[slots]),
+        m_next(new uint32_t[slots])
+{
+    if (slots == 0 || slots >= NO_SLOT) {
+        throw std::invalid_argument("BufferPool needs between 1 and 2^32 - 2 slots");
+    }
+
+    m_base = detail::mapHugeBuffer(m_slots * m_slotSize, m_mappedSize);
+    if (m_base == nullptr) {
+        throw std::runtime_error("Failed to allocate buffer pool via mmap");
+    }
+    if (numaNode >= 0) {
+        if (auto res = detail::bindToNode(m_base, m_mappedSize, numaNode); !res) {
+            ::munmap(m_base, m_mappedSize);
+            throw std::runtime_error("Failed to bind buffer pool to NUMA node: " + res.error().message());
+        }
+    }
+    if (prefault) {
+        detail::prefault(m_base, m_mappedSize);
+    }
+
+    // Hand out low slots first so a lightly loaded pool stays cache and TLB warm
+    m_free.reserve(slots);
+    for (size_t i = slots; i-- > 0;) {
+        m_refs[i].store(0, std::memory_order_relaxed);
+        m_free.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+BufferPool::~BufferPool() {
+    if (m_base != nullptr) {
+        ::munmap(m_base, m_mappedSize);
+    }
+}
+
+uint32_t BufferPool::acquire() {
+    if (m_free.empty()) [[unlikely]] {
+        // Take every slot released since the last refill in one exchange
+        uint32_t slot = m_returned.exchange(NO_SLOT, std::memory_order_acquire);
+        while (slot != NO_SLOT) {
+            m_free.push_back(slot);
+            slot = m_next[slot];
+        }
+        if (m_free.empty()) {
+            return NO_SLOT;
+        }
+    }
+
+    uint32_t slot = m_free.back();
+    m_free.pop_back();
+    m_refs[slot].store(1, std::memory_order_relaxed);
+    return slot;
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -19,13 +19,33 @@
 #include <atu_reactor/EventLoop.h>
 
 // System headers
+#include <algorithm>
 #include <errno.h>
 #include <stdexcept>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
 #include <sys/timerfd.h>
 
 // Library headers
+#include <atu_reactor/IoUringUDPReceiver.h>
 #include <atu_reactor/UDPReceiver.h>
+#include <atu_reactor/UDPSender.h>
+#include <atu_reactor/XDPReceiver.h>
+#include "CpuRelax.h"
+#include "PreciseTimers.h"
+#include "TimerWheel.h"
+
+// Fallback for libc headers predating epoll busy-poll ioctls (Linux 6.9)
+#ifndef EPIOCSPARAMS
+struct epoll_params {
+    uint32_t busy_poll_usecs;
+    uint16_t busy_poll_budget;
+    uint8_t prefer_busy_poll;
+    uint8_t __pad;
+};
+#define EPIOCSPARAMS _IOW(0x8A, 0x01, struct epoll_params)
+#endif
 
 namespace atu_reactor {
 
@@ -42,13 +62,20 @@ struct EventLoop::EpollInternal {
 EventLoop::EventLoop()
     : m_epoll_fd(epoll_create1(0)),
     m_timer_fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)),
-    m_impl(std::make_unique<EpollInternal>(MAX_EVENTS))
+    m_wakeup_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    m_impl(std::make_unique<EpollInternal>(MAX_EVENTS)),
+    m_timers(std::make_unique<detail::TimerWheel>(Clock::now())),
+    m_preciseTimers(std::make_unique<detail::PreciseTimers>())
 {
     if (m_epoll_fd < 0) throw std::runtime_error("Failed to create epoll");
     if (m_timer_fd < 0) throw std::runtime_error("Failed to create timerfd");
+    if (m_wakeup_fd < 0) throw std::runtime_error("Failed to create eventfd");
 
     // Register the timer FD into the epoll loop immediately
     addSource(m_timer_fd, EPOLLIN, TimerTag{this}).value();
+
+    // Idle unless someone post()s: no cost for single-threaded reactors
+    addSource(m_wakeup_fd, EPOLLIN, WakeupTag{this}).value();
 }
 
 /**
@@ -58,7 +85,7 @@ EventLoop::EventLoop()
  */
 EventLoop::~EventLoop() = default;
 
-Result<void> EventLoop::addSource(int fd, uint32_t eventMask, InternalHandler handler) {
+Result<void> EventLoop::addSource(int fd, uint32_t eventMask, InternalHandler handler, Priority priority) {
     if (fd < 0) {
         return std::error_code(EBADF, std::generic_category());
     }
@@ -69,12 +96,13 @@ Result<void> EventLoop::addSource(int fd, uint32_t eventMask, InternalHandler ha
     // Store the callback in our local map
     // Point epoll directly to the memory address of this source
     if (fd < MAX_FAST_FDS) {
-        m_fastSources[fd] = {handler};
+        m_fastSources[fd] = {handler, priority};
         ev.data.ptr = &m_fastSources[fd];
     } else {
-        m_slowSources[fd] = {handler};
+        m_slowSources[fd] = {handler, priority};
         ev.data.ptr = &m_slowSources[fd];
     }
+    usePriority(priority);
 
     // Tell the kernel to start monitoring this FD
     if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) [[unlikely]] {
@@ -88,7 +116,7 @@ Result<void> EventLoop::addSource(int fd, uint32_t eventMask, InternalHandler ha
 
 Result<void> EventLoop::removeSource(int fd) {
     if (fd < MAX_FAST_FDS) {
-        m_fastSources[fd].handler = std::monostate{};
+        m_fastSources[fd] = Source{};
     } else {
         m_slowSources.erase(fd);
     }
@@ -107,15 +135,180 @@ Result<void> EventLoop::removeSource(int fd) {
     return Result<void>::success();
 }
 
+Result<void> EventLoop::modifySource(int fd, uint32_t eventMask) {
+    if (fd < 0) {
+        return std::error_code(EBADF, std::generic_category());
+    }
+
+    struct epoll_event ev{};
+    ev.events = eventMask;
+
+    // Keep pointing at the Source stored by addSource
+    if (fd < MAX_FAST_FDS) {
+        ev.data.ptr = &m_fastSources[fd];
+    } else {
+        auto it = m_slowSources.find(fd);
+        if (it == m_slowSources.end()) {
+            return std::error_code(ENOENT, std::system_category());
+        }
+        ev.data.ptr = &it->second;
+    }
+
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1) [[unlikely]] {
+        return std::error_code(errno, std::system_category());
+    }
+
+    return Result<void>::success();
+}
+
+EventLoop::Source* EventLoop::findSource(int fd) {
+    if (fd < 0) return nullptr;
+    if (fd < MAX_FAST_FDS) {
+        Source& source = m_fastSources[fd];
+        return std::holds_alternative<std::monostate>(source.handler) ? nullptr : &source;
+    }
+    auto it = m_slowSources.find(fd);
+    return it == m_slowSources.end() ? nullptr : &it->second;
+}
+
+Result<void> EventLoop::setSourcePriority(int fd, Priority priority) {
+    Source* source = findSource(fd);
+    if (!source) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+
+    // Read through ev.data.ptr on the next dispatch: no epoll_ctl needed
+    source->priority = priority;
+    usePriority(priority);
+    return Result<void>::success();
+}
+
+void EventLoop::addFlushHook(void* context, FlushHookFn hook) {
+    m_flushHooks.push_back({context, hook});
+}
+
+void EventLoop::removeFlushHook(void* context) {
+    for (auto it = m_flushHooks.begin(); it != m_flushHooks.end();) {
+        it = (it->context == context) ? m_flushHooks.erase(it) : it + 1;
+    }
+}
+
+void EventLoop::runFlushHooks() {
+    // Index based: a hook may remove itself
+    for (size_t i = 0; i < m_flushHooks.size(); ++i) {
+        m_flushHooks[i].fn(m_flushHooks[i].context);
+    }
+}
+
+Result<void> EventLoop::setPollPolicy(const PollPolicy& policy) {
+    m_pollPolicy = policy;
+
+    struct epoll_params params{};
+    params.busy_poll_usecs = policy.epollBusyPollUs;
+    params.busy_poll_budget = policy.epollBusyPollBudget;
+    params.prefer_busy_poll = policy.epollPreferBusyPoll ? 1 : 0;
+
+    // All zero is the kernel default: nothing to tell it
+    if (params.busy_poll_usecs == 0 && params.busy_poll_budget == 0 && params.prefer_busy_poll == 0) {
+        return Result<void>::success();
+    }
+
+    if (::ioctl(m_epoll_fd, EPIOCSPARAMS, &params) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    return Result<void>::success();
+}
+
+int EventLoop::waitForEvents(int timeoutMs) {
+    struct epoll_event* events = m_impl->events.data();
+
+    if (m_pollPolicy.mode == PollMode::BLOCK || timeoutMs == 0) [[likely]] {
+        return epoll_wait(m_epoll_fd, events, MAX_EVENTS, timeoutMs);
+    }
+
+    const Timestamp start = Clock::now();
+    const Timestamp deadline = timeoutMs < 0 ? Timestamp::max() : start + Duration(timeoutMs);
+    const Timestamp spinEnd = m_pollPolicy.mode == PollMode::SPIN
+        ? deadline
+        : std::min(deadline, start + m_pollPolicy.spinBudget);
+
+    int ready;
+    Timestamp now;
+    for (;;) {
+        ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, 0);
+        now = Clock::now();
+        if (ready != 0 || now >= spinEnd) break;
+
+        m_stats.emptyPolls++;
+        detail::cpuRelax();
+    }
+    m_stats.spinNs += static_cast<uint64_t>(std::chrono::nanoseconds(now - start).count());
+
+    if (ready == 0 && now < deadline) {
+        // HYBRID budget exhausted: sleep for what is left of the timeout
+        int remaining = -1;
+        if (timeoutMs >= 0) {
+            remaining = static_cast<int>(std::chrono::ceil<Duration>(deadline - now).count());
+        }
+        m_stats.blockingWaits++;
+        ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, remaining);
+    }
+
+    return ready;
+}
+
+inline void EventLoop::dispatch(Source& source, uint32_t events) {
+    std::visit([this, events](auto&& arg) {
+        using T = std::decay_t<decltype(arg)>;
+
+        if constexpr (std::is_same_v<T, TimerTag>) {
+            // Timers generally only trigger on EPOLLIN,
+            // but we call it normally.
+            handleTimerRead();
+        } else if constexpr (std::is_same_v<T, WakeupTag>) {
+            // Another thread post()ed work
+            handleWakeup();
+        } else if constexpr (std::is_same_v<T, UDPReceiverTag>) {
+            // Pass the event to the receiver
+            arg.receiver->handleRead(arg.fd, arg.userContext, arg.handler, arg.stats, arg.weight);
+        } else if constexpr (std::is_same_v<T, UDPBatchReceiverTag>) {
+            // Whole recvmmsg batch in one callback
+            arg.receiver->handleReadBatch(arg.fd, arg.port, arg.userContext, arg.handler, arg.stats, arg.weight);
+        } else if constexpr (std::is_same_v<T, XDPReceiverTag>) {
+            // One AF_XDP socket serves every subscribed port
+            arg.receiver->handleRead(arg.fd, nullptr, nullptr);
+        } else if constexpr (std::is_same_v<T, UDPSenderTag>) {
+            // The send queue was blocked and the socket is writable again
+            arg.sender->handleWrite();
+        } else if constexpr (std::is_same_v<T, IoUringReceiverTag>) {
+            // The ring fd signals completions for every subscribed socket
+            arg.receiver->handleRead(arg.fd, nullptr, nullptr);
+        } else if constexpr (std::is_same_v<T, CallbackTag>) {
+            // No virtual call: the function is the specialized read loop
+            arg.fn(arg.context, events);
+        }
+    }, source.handler);
+}
+
 Result<void> EventLoop::runOnce(int timeoutMs) {
+    m_stats.iterations++;
+
+    // Push out anything queued since the last iteration before sleeping
+    runFlushHooks();
+
     // Optimization: If we have deferred tasks (e.g., PCAP flood),
     // do not block the CPU. Force non-blocking poll.
-    if (!m_pendingTasks.empty()) {
+    if (tasksPending()) {
         timeoutMs = 0;
     }
 
-    // Block until at least one event occurs or the timeout expires
-    int ready = epoll_wait(m_epoll_fd, m_impl->events.data(), MAX_EVENTS, timeoutMs);
+    // Block (or spin, depending on the policy) until events or timeout
+    int ready = waitForEvents(timeoutMs);
+
+    const bool measure = m_pollPolicy.mode != PollMode::BLOCK;
+    Timestamp workStart;
+    if (measure || m_prioritized) workStart = Clock::now();
 
     if (ready < 0) [[unlikely]] {
         // EINTR means a system signal (like Ctrl+C) woke us up; this is not a failure.
@@ -127,37 +320,66 @@ Result<void> EventLoop::runOnce(int timeoutMs) {
         return std::error_code(errno, std::system_category());
     }
 
-    // Iterate only through the number of file descriptors that actually have events
-    for (int i = 0; i < ready; ++i) {
-        // Retrieve the pointer we saved earlier
-        Source* source = static_cast<Source*>(m_impl->events[i].data.ptr);
-
-        if (source) {
-            // 2. Dispatch using the pointer
-            std::visit([this](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-
-                if constexpr (std::is_same_v<T, TimerTag>) {
-                    // Timers generally only trigger on EPOLLIN,
-                    // but we call it normally.
-                    handleTimerRead();
-                } else if constexpr (std::is_same_v<T, UDPReceiverTag>) {
-                    // Pass the event to the receiver
-                    arg.receiver->handleRead(arg.fd, arg.userContext, arg.handler);
-                }
-            }, source->handler);
+    m_stats.events += static_cast<uint64_t>(ready);
+    struct epoll_event* events = m_impl->events.data();
+
+    if (!m_prioritized) [[likely]] {
+        // Iterate only through the number of file descriptors that actually have events
+        for (int i = 0; i < ready; ++i) {
+            // Retrieve the pointer we saved earlier
+            if (auto* source = static_cast<Source*>(events[i].data.ptr)) {
+                // 2. Dispatch using the pointer
+                dispatch(*source, events[i].events);
+            }
+        }
+    } else {
+        // Urgent deferred work goes ahead of any I/O
+        if (!m_urgentTasks.empty()) {
+            m_urgentTasks.drain();
+        }
+
+        // Counting sort of the ready array by class, stable within a class
+        auto classOf = [](const struct epoll_event& event) {
+            return static_cast<int>(static_cast<const Source*>(event.data.ptr)->priority);
+        };
+        uint8_t order[MAX_EVENTS];
+        int start[PRIORITY_CLASSES + 1] = {};
+        for (int i = 0; i < ready; ++i) {
+            start[classOf(events[i]) + 1]++;
+        }
+        for (int c = 0; c < PRIORITY_CLASSES; ++c) {
+            start[c + 1] += start[c];
+        }
+        for (int i = 0; i < ready; ++i) {
+            order[start[classOf(events[i])]++] = static_cast<uint8_t>(i);
+        }
+
+        for (int n = 0; n < ready; ++n) {
+            const struct epoll_event& event = events[order[n]];
+            if (auto* source = static_cast<Source*>(event.data.ptr)) {
+                const auto cls = static_cast<size_t>(source->priority);
+                m_stats.classEvents[cls]++;
+                m_stats.classDelay[cls].record(static_cast<uint64_t>(
+                    std::chrono::nanoseconds(Clock::now() - workStart).count()));
+                dispatch(*source, event.events);
+            }
         }
     }
 
     // 3. Execute Pending Tasks
-    // We swap to a local vector to handle re-entrant calls safely.
+    // Double buffered: tasks queued from a task run on the next iteration.
     if (!m_pendingTasks.empty()) {
-        std::vector<std::function<void()>> tasks;
-        m_pendingTasks.swap(tasks);
+        m_pendingTasks.drain();
+    }
+    if (!m_lowTasks.empty()) {
+        m_lowTasks.drain();
+    }
 
-        for (const auto& task : tasks) {
-            task();
-        }
+    // 4. Flush output produced during this iteration
+    runFlushHooks();
+
+    if (measure) {
+        m_stats.busyNs += static_cast<uint64_t>(std::chrono::nanoseconds(Clock::now() - workStart).count());
     }
 
 
@@ -165,8 +387,31 @@ Result<void> EventLoop::runOnce(int timeoutMs) {
     return Result<void>::success();
 }
 
-void EventLoop::runInLoop(std::function<void()> cb) {
-    m_pendingTasks.push_back(std::move(cb));
+void EventLoop::writeWakeup() {
+    uint64_t one = 1;
+    // EAGAIN only if the counter is saturated, which still leaves it readable
+    (void)::write(m_wakeup_fd, &one, sizeof(one));
+}
+
+void EventLoop::handleWakeup() {
+    uint64_t count;
+    (void)::read(m_wakeup_fd, &count, sizeof(count));
+
+    // Re-open the gate before draining: a post racing with the drain
+    // either is seen by it or writes the eventfd again
+    m_wakeupPending.store(false, std::memory_order_seq_cst);
+    drainPosted();
+}
+
+void EventLoop::drainPosted() {
+    if (!m_posted.drain()) [[unlikely]] {
+        // A producer is half way through its push; retry next iteration
+        runInLoop(&EventLoop::redrainPosted, this);
+    }
+}
+
+void EventLoop::redrainPosted(void* self) {
+    static_cast<EventLoop*>(self)->drainPosted();
 }
 
 Result<TimerId> EventLoop::runAfter(Duration delay, TimerCallback cb) {
@@ -174,14 +419,7 @@ Result<TimerId> EventLoop::runAfter(Duration delay, TimerCallback cb) {
         return std::error_code(EINVAL, std::system_category());
     }
 
-    TimerId id = m_nextTimerId++;
-    Timestamp when = Clock::now() + delay;
-    Timer t{when, Duration(0), std::move(cb), id, false};
-
-    insertTimer(std::move(t));
-
-    // Return the id; it will be wrapped in Result<TimerId> automatically
-    return t.id;
+    return insertTimer(delay, Duration(0), std::move(cb));
 }
 
 Result<TimerId> EventLoop::runEvery(Duration interval, TimerCallback cb) {
@@ -189,74 +427,100 @@ Result<TimerId> EventLoop::runEvery(Duration interval, TimerCallback cb) {
         return std::error_code(EINVAL, std::system_category());
     }
 
-    TimerId id = m_nextTimerId++;
-    Timestamp when = Clock::now() + interval;
-    Timer t{when, interval, std::move(cb), id, true};
+    return insertTimer(interval, interval, std::move(cb));
+}
 
-    insertTimer(std::move(t));
+Result<TimerId> EventLoop::runAt(Timestamp deadline, TimerCallback cb, PreciseDuration spin) {
+    if (spin.count() < 0) [[unlikely]] {
+        return std::error_code(EINVAL, std::system_category());
+    }
 
+    TimerId id = m_preciseTimers->add(deadline, PreciseDuration(0), spin, std::move(cb));
+    if (!m_firingTimers) {
+        armTimerFd();
+    }
     return id;
 }
 
-Result<void> EventLoop::cancelTimer(TimerId id) {
-    auto it = m_activeTimers.find(id);
+Result<TimerId> EventLoop::runAfterPrecise(PreciseDuration delay, TimerCallback cb, PreciseDuration spin) {
+    if (delay.count() < 0) [[unlikely]] {
+        return std::error_code(EINVAL, std::system_category());
+    }
 
-    if (it == m_activeTimers.end()) [[unlikely]] {
-        // Return an error if the TimerId was not found
-        return std::error_code(ENOENT, std::system_category());
+    return runAt(Clock::now() + delay, std::move(cb), spin);
+}
+
+Result<TimerId> EventLoop::runEveryPrecise(PreciseDuration interval, TimerCallback cb, PreciseDuration spin) {
+    if (interval.count() <= 0 || spin.count() < 0) [[unlikely]] {
+        return std::error_code(EINVAL, std::system_category());
     }
 
-    m_timers.erase(it->second); // Remove from the set
-    m_activeTimers.erase(it);   // Remove from the map
+    TimerId id = m_preciseTimers->add(Clock::now() + interval, interval, spin, std::move(cb));
+    if (!m_firingTimers) {
+        armTimerFd();
+    }
+    return id;
+}
 
-    // If we removed the earliest timer, we must update the hardware timer
-    // to reflect the new earliest time.
-    resetTimerFd();
+Result<void> EventLoop::cancelTimer(TimerId id) {
+    const bool cancelled = detail::PreciseTimers::owns(id)
+        ? m_preciseTimers->cancel(id)
+        : m_timers->cancel(id);
+    if (!cancelled) [[unlikely]] {
+        // Return an error if the TimerId was not found
+        return std::error_code(ENOENT, std::system_category());
+    }
 
+    // The timerfd is left armed: an early wakeup finds nothing due and
+    // simply re-arms for the next deadline, which is cheaper than a syscall here.
     return Result<void>::success();
 }
 
-void EventLoop::insertTimer(Timer t) {
-    bool earliestChanged = false;
-    if (m_timers.empty() || t.expiration < m_timers.begin()->expiration) {
-        earliestChanged = true;
+Result<TimerId> EventLoop::insertTimer(Duration delay, Duration interval, TimerCallback cb) {
+    TimerId id = m_timers->add(Clock::now() + delay, interval, std::move(cb));
+
+    // Timers added from a timer callback are picked up by the single
+    // re-arm at the end of handleTimerRead
+    if (!m_firingTimers) {
+        armTimerFd();
     }
 
-    auto result = m_timers.insert(std::move(t));
-    m_activeTimers[result.first->id] = result.first;
+    return id;
+}
 
-    if (earliestChanged) {
-        resetTimerFd();
+void EventLoop::armTimerFd() {
+    // Earliest of the wheel tick and the precise heap
+    Timestamp when;
+    Timestamp precise;
+    const bool hasWheel = m_timers->nextWakeup(when);
+    const bool hasPrecise = m_preciseTimers->nextWakeup(precise);
+    if (hasPrecise && (!hasWheel || precise < when)) {
+        when = precise;
     }
-}
 
-void EventLoop::resetTimerFd() {
-    if (m_timers.empty()) {
-        // Disarm timer
-        struct itimerspec newValue{};
-        timerfd_settime(m_timer_fd, 0, &newValue, nullptr);
+    if (!hasWheel && !hasPrecise) {
+        if (m_armed) {
+            // Disarm timer
+            struct itimerspec newValue{};
+            timerfd_settime(m_timer_fd, 0, &newValue, nullptr);
+            m_armed = false;
+        }
         return;
     }
 
-    auto now = Clock::now();
-    auto expiration = m_timers.begin()->expiration;
+    if (m_armed && when == m_armedAt) return;
 
-    struct itimerspec newValue{};
+    // Absolute deadline on CLOCK_MONOTONIC, the clock behind steady_clock.
+    // A deadline already in the past makes the timerfd fire immediately.
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
 
-    if (expiration <= now) {
-        // Timer already expired! Set to smallest non-zero value
-        // to trigger the epoll loop immediately.
-        newValue.it_value.tv_sec = 0;
-        newValue.it_value.tv_nsec = 1;
-    } else {
-        // Calculate delay from now until next expiration
-        auto dur = expiration - now;
-        newValue.it_value.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(dur).count();
-        newValue.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count() % 1'000'000'000;
-    }
+    struct itimerspec newValue{};
+    newValue.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    newValue.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
 
-    // Using Absolute Time is safer against system clock drift
     timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &newValue, nullptr);
+    m_armedAt = when;
+    m_armed = true;
 }
 
 void EventLoop::handleTimerRead() {
@@ -267,36 +531,18 @@ void EventLoop::handleTimerRead() {
         return; // Should not happen
     }
 
-    Timestamp now = Clock::now();
+    // The one-shot deadline has been consumed
+    m_armed = false;
 
-    // Process all expired timers
-    // We must be careful: the callback might add new timers or cancel existing ones.
-    // Iterating while modifying requires care.
-
-    // 1. Extract all expired timers from the set
-    std::vector<Timer> expired;
-    while (!m_timers.empty() && m_timers.begin()->expiration <= now) {
-        auto it = m_timers.begin();
-        expired.push_back(std::move(*it));
-        m_activeTimers.erase(it->id);
-        m_timers.erase(it);
-    }
-
-    // 2. Execute callbacks
-    for (auto& t : expired) {
-        if (t.callback) {
-            t.callback();
-        }
-
-        // 3. Re-schedule if repeating
-        if (t.repeat) {
-            t.expiration += t.interval;
-            insertTimer(t);
-        }
-    }
+    // Callbacks may add or cancel timers; the wheel copes with both
+    m_firingTimers = true;
+    const Timestamp now = Clock::now();
+    m_timers->advance(now);
+    m_preciseTimers->advance(now);
+    m_firingTimers = false;
 
-    // 4. Ensure hardware timer waits for the next valid event
-    resetTimerFd();
+    // One timerfd_settime per tick, for the next slot with work
+    armTimerFd();
 }
 
 } // namespace atu_reactor
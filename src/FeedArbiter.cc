@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/FeedArbiter.h>
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+
+namespace atu_reactor {
+
+FeedArbiter::FeedArbiter(ArbiterConfig config)
+        : m_config(config), m_mask(static_cast<uint64_t>(config.window) - 1)
+{
+    if (!m_config.sequence) {
+        throw std::invalid_argument("FeedArbiter needs a SequenceFn");
+    }
+    if (m_config.window < 64 || (m_config.window & (m_config.window - 1)) != 0) {
+        throw std::invalid_argument("Arbitration window must be a power of two of at least 64");
+    }
+    m_seen.assign(m_config.window / 64, 0);
+}
+
+FeedArbiter::~FeedArbiter() {
+    for (int i = 0; i < m_lineCount; ++i) {
+        if (m_lines[i].receiver) {
+            (void)m_lines[i].receiver->unsubscribe(m_lines[i].port);
+        }
+    }
+}
+
+Result<int> FeedArbiter::addLine(PacketReceiver& receiver, uint16_t localPort) {
+    if (m_lineCount == MAX_LINES) {
+        return std::error_code(ENOSPC, std::system_category());
+    }
+
+    Line& line = m_lines[m_lineCount];
+    line = {this, &receiver, localPort, m_lineCount};
+    auto res = receiver.subscribeBatch(localPort, &line, &FeedArbiter::onBatch);
+    if (!res) {
+        return res.error();
+    }
+    // An ephemeral port (0) is resolved by the receiver
+    line.port = static_cast<uint16_t>(res.value());
+    return m_lineCount++;
+}
+
+Result<int> FeedArbiter::addLine() {
+    if (m_lineCount == MAX_LINES) {
+        return std::error_code(ENOSPC, std::system_category());
+    }
+    m_lines[m_lineCount] = {this, nullptr, 0, m_lineCount};
+    return m_lineCount++;
+}
+
+void FeedArbiter::setHandler(void* context, PacketHandlerFn handler) {
+    m_handlerContext = context;
+    m_handler = handler;
+    m_batchHandler = nullptr;
+}
+
+void FeedArbiter::setBatchHandler(void* context, PacketBatchHandlerFn handler) {
+    m_handlerContext = context;
+    m_batchHandler = handler;
+    m_handler = nullptr;
+}
+
+void FeedArbiter::setGapHandler(void* context, GapHandlerFn handler) {
+    m_gapContext = context;
+    m_gapHandler = handler;
+}
+
+void FeedArbiter::reset() {
+    std::fill(m_seen.begin(), m_seen.end(), 0);
+    m_started = false;
+    m_first = 0;
+    m_newest = 0;
+}
+
+void FeedArbiter::onBatch(void* context, int n, const PacketMetadata* meta, const uint8_t* base, size_t stride) {
+    const auto* line = static_cast<const Line*>(context);
+    line->owner->arbitrate(*line, n, meta, base, stride);
+}
+
+void FeedArbiter::arbitrate(const Line& line, int n, const PacketMetadata* meta, const uint8_t* base, size_t stride) {
+    uint64_t wins = 0;
+    uint64_t duplicates = 0;
+    uint64_t stale = 0;
+    uint64_t unsequenced = 0;
+
+    // Survivors leave as maximal runs of the receiver's array
+    int runStart = 0;
+    for (int i = 0; i < n; ++i) {
+        uint64_t seq;
+        bool keep = true;
+        if (!m_config.sequence(m_config.sequenceContext, meta[i].data, meta[i].len, seq)) {
+            ++unsequenced;
+        } else {
+            switch (admit(seq)) {
+            case Verdict::FIRST:
+                ++wins;
+                break;
+            case Verdict::DUPLICATE:
+                ++duplicates;
+                keep = false;
+                break;
+            case Verdict::STALE:
+                ++stale;
+                keep = false;
+                break;
+            }
+        }
+
+        if (!keep) {
+            forward(i - runStart, meta + runStart, base ? base + runStart * stride : nullptr, stride);
+            runStart = i + 1;
+        }
+    }
+    forward(n - runStart, meta + runStart, base ? base + runStart * stride : nullptr, stride);
+
+    LineStats& stats = m_stats.lines[line.index];
+    stats.packets += static_cast<uint64_t>(n);
+    stats.wins += wins;
+    stats.duplicates += duplicates;
+    stats.stale += stale;
+    m_stats.unsequenced += unsequenced;
+    m_stats.forwarded += wins + unsequenced;
+}
+
+FeedArbiter::Verdict FeedArbiter::admit(uint64_t seq) noexcept {
+    if (!m_started) {
+        m_started = true;
+        m_first = seq;
+        m_newest = seq;
+    } else if (seq > m_newest) {
+        advance(seq);
+    } else if (m_newest - seq > m_mask) {
+        return Verdict::STALE;  // Its slot already holds a newer number
+    }
+
+    // Numbers behind the newest one are late fills, or copies of a forwarded one
+    uint64_t& word = m_seen[(seq & m_mask) >> 6];
+    const uint64_t bit = 1ULL << (seq & 63);
+    if (word & bit) {
+        return Verdict::DUPLICATE;
+    }
+    word |= bit;
+    return Verdict::FIRST;
+}
+
+void FeedArbiter::advance(uint64_t seq) noexcept {
+    const uint64_t window = m_mask + 1;
+    const uint64_t steps = seq - m_newest;
+
+    // Each number entering the window takes the slot of the one leaving it
+    uint64_t runFirst = 0;
+    uint64_t runCount = 0;
+    for (uint64_t y = m_newest + 1, last = m_newest + std::min(steps, window); y <= last; ++y) {
+        uint64_t& word = m_seen[(y & m_mask) >> 6];
+        const uint64_t bit = 1ULL << (y & 63);
+        if (y - m_first >= window && !(word & bit)) {
+            const uint64_t gone = y - window;
+            if (runCount > 0 && runFirst + runCount == gone) {
+                ++runCount;
+            } else {
+                reportMissing(runFirst, runCount);
+                runFirst = gone;
+                runCount = 1;
+            }
+        }
+        word &= ~bit;
+    }
+    reportMissing(runFirst, runCount);
+
+    // A jump past the whole window skips numbers that never entered it
+    if (steps > window) {
+        reportMissing(m_newest + 1, steps - window);
+    }
+    m_newest = seq;
+}
+
+void FeedArbiter::reportMissing(uint64_t first, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    m_stats.missing += count;
+    ++m_stats.gaps;
+    if (m_gapHandler) {
+        m_gapHandler(m_gapContext, first, count);
+    }
+}
+
+void FeedArbiter::forward(int n, const PacketMetadata* meta, const uint8_t* base, size_t stride) {
+    if (n == 0) {
+        return;
+    }
+    if (m_batchHandler) {
+        m_batchHandler(m_handlerContext, n, meta, base, stride);
+        return;
+    }
+    if (m_handler) {
+        // Same delivery as PacketReceiver::dispatch
+        for (int i = 0; i < n; ++i) {
+            if (meta[i].len > 0) {
+                const struct timespec& ts = (meta[i].status & PacketStatus::HW_TIMESTAMP)
+                    ? meta[i].hwTs : meta[i].ts;
+                m_handler(m_handlerContext, meta[i].data, meta[i].len, meta[i].status, ts);
+            }
+        }
+    }
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace atu_reactor::detail {
+
+/**
+ * @brief Destination (and optionally source) address a flow is restricted to.
+ * IPv4 addresses occupy the first 4 bytes; both are in network byte order.
+ */
+struct FlowAddress {
+    uint8_t bytes[16] = {};
+    bool v6 = false;
+    bool any = true;        // Wildcard: matches every address of either family
+
+    bool matches(const uint8_t* addr, bool isV6) const noexcept {
+        if (any) return true;
+        if (v6 != isV6) return false;
+        return isV6 ? std::memcmp(bytes, addr, 16) == 0 : std::memcmp(bytes, addr, 4) == 0;
+    }
+
+    bool operator==(const FlowAddress& other) const noexcept {
+        return any == other.any && v6 == other.v6 && std::memcmp(bytes, other.bytes, 16) == 0;
+    }
+};
+
+struct FlowKey {
+    uint16_t portNet = 0;   // Destination port, network byte order
+    FlowAddress dst;
+    FlowAddress src;
+
+    // More constrained flows are tried first
+    int specificity() const noexcept { return (dst.any ? 0 : 2) + (src.any ? 0 : 1); }
+
+    bool operator==(const FlowKey& other) const noexcept {
+        return portNet == other.portNet && dst == other.dst && src == other.src;
+    }
+};
+
+/**
+ * @class FlowTable
+ * @brief Read-mostly map of (destination port, destination address, source
+ * address) flows to Value, sized to stay in L1/L2 whatever the port numbers.
+ * An 8KB port bitmap rejects unsubscribed ports with one load. Subscribed
+ * ports are found in a small open-addressing table holding the range of
+ * their flows in one dense array, most specific first. Addresses are only
+ * read from the IP header when the port has an address-restricted flow.
+ * Updates rebuild the table: Value pointers do not survive insert or erase.
+ */
+template <typename Value>
+class FlowTable {
+    public:
+        struct Entry {
+            FlowKey key;
+            Value value;
+        };
+
+        FlowTable() { rebuild(); }
+
+        // False if the exact key is already present
+        bool insert(const FlowKey& key, const Value& value) {
+            for (const auto& e : m_flows) {
+                if (e.key == key) return false;
+            }
+            m_flows.push_back({key, value});
+            rebuild();
+            return true;
+        }
+
+        bool erase(const FlowKey& key) {
+            auto it = std::find_if(m_flows.begin(), m_flows.end(),
+                    [&key](const Entry& e) { return e.key == key; });
+            if (it == m_flows.end()) return false;
+            m_flows.erase(it);
+            rebuild();
+            return true;
+        }
+
+        // Drops every flow of a port, returns how many there were
+        size_t erasePort(uint16_t portNet) {
+            const size_t before = m_flows.size();
+            m_flows.erase(std::remove_if(m_flows.begin(), m_flows.end(),
+                    [portNet](const Entry& e) { return e.key.portNet == portNet; }), m_flows.end());
+            const size_t removed = before - m_flows.size();
+            if (removed > 0) rebuild();
+            return removed;
+        }
+
+        bool hasPort(uint16_t portNet) const noexcept {
+            return (m_ports[portNet >> 6] >> (portNet & 63)) & 1;
+        }
+
+        // One bit per port (network order), for kernels testing many packets at once
+        const uint64_t* portBitmap() const noexcept { return m_ports.data(); }
+
+        /**
+         * @brief Most specific flow of portNet matching the packet.
+         * @param ip IPv4 or IPv6 header (addresses are read only when needed).
+         * @param portWide Set when the result does not depend on the addresses,
+         *        so it may be cached by port alone.
+         */
+        const Value* find(uint16_t portNet, const uint8_t* ip, bool v6, bool& portWide) const noexcept {
+            if (!hasPort(portNet)) [[likely]] return nullptr;
+
+            const Slot* slot = findSlot(portNet);
+            portWide = slot->portWide;
+            const Entry* e = m_flows.data() + slot->first;
+            const Entry* end = e + slot->count;
+            if (portWide) return &e->value;
+
+            const uint8_t* src = ip + (v6 ? 8 : 12);
+            const uint8_t* dst = ip + (v6 ? 24 : 16);
+            for (; e != end; ++e) {
+                if (e->key.dst.matches(dst, v6) && e->key.src.matches(src, v6)) return &e->value;
+            }
+            return nullptr;
+        }
+
+        bool empty() const noexcept { return m_flows.empty(); }
+
+    private:
+        struct Slot {
+            uint32_t first = 0;     // Range of the port's flows in m_flows
+            uint16_t count = 0;     // 0 = empty slot
+            uint16_t portNet = 0;
+            bool portWide = false;  // A single wildcard flow
+        };
+
+        static size_t hashPort(uint16_t portNet) noexcept {
+            return static_cast<size_t>((uint64_t{portNet} * 0x9E3779B97F4A7C15ULL) >> 32);
+        }
+
+        const Slot* findSlot(uint16_t portNet) const noexcept {
+            // The bitmap guarantees the port is present, and the table is never full
+            for (size_t i = hashPort(portNet) & m_mask;; i = (i + 1) & m_mask) {
+                const Slot& s = m_slots[i];
+                if (s.portNet == portNet && s.count > 0) return &s;
+            }
+        }
+
+        void rebuild() {
+            // Grouped by port, most specific first, insertion order kept otherwise
+            std::stable_sort(m_flows.begin(), m_flows.end(), [](const Entry& a, const Entry& b) {
+                if (a.key.portNet != b.key.portNet) return a.key.portNet < b.key.portNet;
+                return a.key.specificity() > b.key.specificity();
+            });
+
+            size_t ports = 0;
+            for (size_t i = 0; i < m_flows.size(); ++i) {
+                if (i == 0 || m_flows[i].key.portNet != m_flows[i - 1].key.portNet) ++ports;
+            }
+
+            // Load factor at most 1/2
+            size_t capacity = 16;
+            while (capacity < 2 * ports) capacity <<= 1;
+            m_slots.assign(capacity, Slot{});
+            m_mask = capacity - 1;
+            m_ports.fill(0);
+
+            for (size_t i = 0; i < m_flows.size();) {
+                const uint16_t portNet = m_flows[i].key.portNet;
+                size_t j = i;
+                while (j < m_flows.size() && m_flows[j].key.portNet == portNet) ++j;
+
+                size_t h = hashPort(portNet) & m_mask;
+                while (m_slots[h].count > 0) h = (h + 1) & m_mask;
+                Slot& s = m_slots[h];
+                s.first = static_cast<uint32_t>(i);
+                s.count = static_cast<uint16_t>(j - i);
+                s.portNet = portNet;
+                s.portWide = (j - i == 1) && m_flows[i].key.specificity() == 0;
+
+                m_ports[portNet >> 6] |= uint64_t{1} << (portNet & 63);
+                i = j;
+            }
+        }
+
+        std::array<uint64_t, 65536 / 64> m_ports{};
+        std::vector<Slot> m_slots;
+        size_t m_mask = 0;
+        std::vector<Entry> m_flows;
+};
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
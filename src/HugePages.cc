@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include "HugePages.h"
+
+// System headers
+#include <sys/mman.h>
+
+namespace atu_reactor::detail {
+
+uint8_t* mapHugeBuffer(size_t requested, size_t& mappedSize) {
+    mappedSize = (requested + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
+
+    // Try to allocate memory using Hugepages first for better TLB performance
+    void* buffer = ::mmap(nullptr, mappedSize,
+        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    // Fallback: If Hugepages are not available/reserved, use standard 4KB pages
+    if (buffer == MAP_FAILED) {
+        buffer = ::mmap(nullptr, mappedSize,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (buffer == MAP_FAILED) {
+            mappedSize = 0;
+            return nullptr;
+        }
+    }
+
+    return static_cast<uint8_t*>(buffer);
+}
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
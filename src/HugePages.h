@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+
+namespace atu_reactor::detail {
+
+// Hugepages are typically 2MB. Mappings are rounded up to this boundary.
+constexpr size_t HUGEPAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * @brief Maps an anonymous buffer, preferring MAP_HUGETLB.
+ * Falls back to standard 4KB pages if no hugepages are reserved.
+ * @param requested Bytes needed.
+ * @param mappedSize Receives the rounded size to pass to munmap.
+ * @return The mapping, or nullptr on failure (errno is set).
+ */
+uint8_t* mapHugeBuffer(size_t requested, size_t& mappedSize);
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
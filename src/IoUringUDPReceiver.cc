@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/IoUringUDPReceiver.h>
+
+// System headers
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Library headers
+#include "UdpSocket.h"
+
+namespace atu_reactor {
+
+namespace {
+
+// user_data of requests whose completion carries nothing to dispatch
+constexpr uint64_t IGNORED_TOKEN = ~0ULL;
+
+constexpr uint16_t BUFFER_GROUP = 0;
+
+inline uint64_t makeToken(uint32_t slot, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) | slot;
+}
+
+int ringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+} // namespace
+
+ReceiverConfig IoUringUDPReceiver::bufferLayout(const IoUringConfig& config) {
+    // One provided buffer per slot of the base class hugepage buffer
+    ReceiverConfig layout = config;
+    layout.batchSize = static_cast<int>(config.bufferCount);
+    layout.bufferSize = config.bufferSize + static_cast<int>(HEADER_SPACE);
+    return layout;
+}
+
+IoUringUDPReceiver::IoUringUDPReceiver(EventLoop& loopRef, IoUringConfig config)
+        : PacketReceiver(loopRef, bufferLayout(config)),
+        m_uringConfig(config)
+{
+    const uint32_t bufferCount = m_uringConfig.bufferCount;
+    if (bufferCount == 0 || bufferCount > 32768 || (bufferCount & (bufferCount - 1)) != 0) {
+        throw std::runtime_error("io_uring bufferCount must be a power of two <= 32768");
+    }
+
+    // 1. Create the ring
+    struct io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = m_uringConfig.cqEntries;
+
+    m_ringFd.reset(static_cast<int>(::syscall(__NR_io_uring_setup, m_uringConfig.sqEntries, &params)));
+    if (m_ringFd < 0) {
+        throw std::runtime_error("Failed to create io_uring");
+    }
+
+    m_sqMapSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    m_cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Kernels with SINGLE_MMAP expose both rings through the same mapping
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        m_sqMapSize = m_cqMapSize = std::max(m_sqMapSize, m_cqMapSize);
+    }
+
+    m_sqMap = ::mmap(nullptr, m_sqMapSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqMap == MAP_FAILED) {
+        m_sqMap = nullptr;
+        releaseRing();
+        throw std::runtime_error("Failed to map io_uring SQ ring");
+    }
+
+    if (singleMmap) {
+        m_cqMap = m_sqMap;
+    } else {
+        m_cqMap = ::mmap(nullptr, m_cqMapSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqMap == MAP_FAILED) {
+            m_cqMap = nullptr;
+            releaseRing();
+            throw std::runtime_error("Failed to map io_uring CQ ring");
+        }
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    m_sqes = static_cast<struct io_uring_sqe*>(::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES));
+    if (m_sqes == MAP_FAILED) {
+        m_sqes = nullptr;
+        releaseRing();
+        throw std::runtime_error("Failed to map io_uring SQEs");
+    }
+
+    auto* sq = static_cast<uint8_t*>(m_sqMap);
+    m_sqHead = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    m_sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    m_sqMask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    m_sqEntries = params.sq_entries;
+    m_sqLocalTail = *m_sqTail;
+
+    auto* cq = static_cast<uint8_t*>(m_cqMap);
+    m_cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // 2. Register the provided buffer ring, backed by the hugepage buffer slots
+    m_bufRingSize = bufferCount * sizeof(struct io_uring_buf);
+    void* ring = ::mmap(nullptr, m_bufRingSize, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (ring == MAP_FAILED) {
+        releaseRing();
+        throw std::runtime_error("Failed to allocate io_uring buffer ring");
+    }
+    m_bufRing = static_cast<struct io_uring_buf_ring*>(ring);
+
+    struct io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(m_bufRing);
+    reg.ring_entries = bufferCount;
+    reg.bgid = BUFFER_GROUP;
+    if (::syscall(__NR_io_uring_register, m_ringFd.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        releaseRing();
+        throw std::runtime_error("Failed to register io_uring buffer ring");
+    }
+
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        recycleBuffer(static_cast<uint16_t>(i));
+    }
+    __atomic_store_n(&m_bufRing->tail, m_bufTail, __ATOMIC_RELEASE);
+
+    // 3. The multishot recvmsg only reads the reserved name/control lengths
+    m_msgTemplate.msg_namelen = NAME_SPACE;
+    m_msgTemplate.msg_controllen = CONTROL_SPACE;
+
+    // 4. Completions are signalled through the ring fd
+    if (!m_loop.addSource(m_ringFd, EPOLLIN, IoUringReceiverTag{this, m_ringFd})) {
+        releaseRing();
+        throw std::runtime_error("Failed to register io_uring with the event loop");
+    }
+}
+
+IoUringUDPReceiver::~IoUringUDPReceiver() {
+    m_loop.removeSource(m_ringFd);
+    releaseRing();
+
+    // Sockets were never registered with the EventLoop: close them here
+    m_port_to_fd_map.clear();
+}
+
+void IoUringUDPReceiver::releaseRing() {
+    // Closing the ring cancels every pending multishot request
+    m_ringFd.reset();
+
+    if (m_sqes) ::munmap(m_sqes, m_sqesSize);
+    if (m_cqMap && m_cqMap != m_sqMap) ::munmap(m_cqMap, m_cqMapSize);
+    if (m_sqMap) ::munmap(m_sqMap, m_sqMapSize);
+    if (m_bufRing) ::munmap(m_bufRing, m_bufRingSize);
+    m_sqes = nullptr;
+    m_cqMap = nullptr;
+    m_sqMap = nullptr;
+    m_bufRing = nullptr;
+}
+
+void IoUringUDPReceiver::recycleBuffer(uint16_t bid) {
+    const uint32_t mask = m_uringConfig.bufferCount - 1;
+    // Index the entries directly: in C++ the empty struct hidden in the UAPI
+    // flexible array takes one byte and would shift bufs[] by 8 bytes.
+    auto* entries = reinterpret_cast<struct io_uring_buf*>(m_bufRing);
+    struct io_uring_buf& buf = entries[m_bufTail & mask];
+    buf.addr = reinterpret_cast<uint64_t>(m_cachedBasePtr + bid * m_alignedBufferSize);
+    buf.len = static_cast<uint32_t>(m_config.bufferSize);
+    buf.bid = bid;
+    ++m_bufTail;
+}
+
+struct io_uring_sqe* IoUringUDPReceiver::getSqe() {
+    if (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+        // Queue full: push what we have to the kernel first
+        submit();
+    }
+
+    uint32_t index = m_sqLocalTail & m_sqMask;
+    struct io_uring_sqe* sqe = &m_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+
+    ++m_sqLocalTail;
+    return sqe;
+}
+
+void IoUringUDPReceiver::submit() {
+    uint32_t toSubmit = m_sqLocalTail - *m_sqTail;
+    if (toSubmit == 0) return;
+
+    // Publish the filled SQEs, then a single enter for the whole batch
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+    ringEnter(m_ringFd, toSubmit, 0, 0);
+}
+
+void IoUringUDPReceiver::armReceive(uint32_t slotIndex) {
+    const Slot& slot = m_slots[slotIndex];
+
+    struct io_uring_sqe* sqe = getSqe();
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = slot.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(&m_msgTemplate);
+    sqe->len = 1;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = makeToken(slotIndex, slot.generation);
+}
+
+Result<int> IoUringUDPReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
+    if (auto baseRes = PacketReceiver::subscribe(port, context, handler); !baseRes.has_value()) {
+        return Result<int>(baseRes.error());
+    }
+
+    ScopedFd udp_socket;
+    auto openRes = detail::openUdpSocket(port, udp_socket);
+    if (!openRes) {
+        return openRes.error();
+    }
+
+    uint16_t localPort = openRes.value();
+
+    // Reuse a released slot if possible
+    uint32_t index = 0;
+    while (index < m_slots.size() && m_slots[index].active) ++index;
+    if (index == m_slots.size()) m_slots.emplace_back();
+
+    Slot& slot = m_slots[index];
+    slot.fd = udp_socket;
+    slot.context = context;
+    slot.handler = handler;
+    slot.active = true;
+
+    armReceive(index);
+    submit();
+
+    // Move ownership of ScopedFd to our map only after success
+    m_port_to_fd_map.emplace(localPort, std::move(udp_socket));
+
+    return {static_cast<int>(localPort)};
+}
+
+Result<void> IoUringUDPReceiver::unsubscribe(uint16_t port) {
+    checkThread();
+
+    auto it = m_port_to_fd_map.find(port);
+    if (it == m_port_to_fd_map.end()) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+
+    for (uint32_t index = 0; index < m_slots.size(); ++index) {
+        Slot& slot = m_slots[index];
+        if (!slot.active || slot.fd != it->second) continue;
+
+        // Cancel the multishot request; its final CQE is dropped by generation
+        struct io_uring_sqe* sqe = getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = makeToken(index, slot.generation);
+        sqe->user_data = IGNORED_TOKEN;
+        submit();
+
+        slot.active = false;
+        slot.fd = -1;
+        ++slot.generation;
+        break;
+    }
+
+    m_port_to_fd_map.erase(it);
+    return Result<void>::success();
+}
+
+void IoUringUDPReceiver::handleRead(int, void*, PacketHandlerFn) {
+    checkThread();
+
+    uint32_t head = *m_cqHead;
+    const uint32_t tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    const uint32_t budget = static_cast<uint32_t>(m_uringConfig.batchSize > 0 ? m_uringConfig.batchSize : 64);
+
+    const uint16_t bufTailStart = m_bufTail;
+
+    for (uint32_t processed = 0; head != tail && processed < budget; ++head, ++processed) {
+        const struct io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+        if (cqe.user_data == IGNORED_TOKEN) continue;
+
+        const uint32_t index = static_cast<uint32_t>(cqe.user_data);
+        const uint32_t generation = static_cast<uint32_t>(cqe.user_data >> 32);
+        const bool hasBuffer = cqe.flags & IORING_CQE_F_BUFFER;
+        const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+        const bool live = index < m_slots.size() &&
+                m_slots[index].active &&
+                m_slots[index].generation == generation;
+
+        if (live && cqe.res > 0 && hasBuffer) [[likely]] {
+            const Slot& slot = m_slots[index];
+            uint8_t* buf = m_cachedBasePtr + bid * m_alignedBufferSize;
+            const auto* out = reinterpret_cast<const struct io_uring_recvmsg_out*>(buf);
+
+            uint32_t status = PacketStatus::OK;
+            if (out->flags & MSG_TRUNC) {
+                status |= PacketStatus::TRUNCATED;
+            }
+
+            // Walk the control block exactly as recvmsg would have filled it
+            struct timespec packetTime = {0, 0};
+            struct msghdr view{};
+            view.msg_control = buf + sizeof(*out) + NAME_SPACE;
+            view.msg_controllen = out->controllen;
+            for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&view);
+                 cmsg != nullptr;
+                 cmsg = CMSG_NXTHDR(&view, cmsg)) {
+
+                if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPNS)) {
+                    std::memcpy(&packetTime, CMSG_DATA(cmsg), sizeof(packetTime));
+                    break;
+                }
+            }
+
+            const size_t len = static_cast<size_t>(cqe.res) - HEADER_SPACE;
+            if (len > 0) {
+                slot.handler(slot.context, buf + HEADER_SPACE, len, status, packetTime);
+            }
+        }
+
+        if (hasBuffer) {
+            recycleBuffer(bid);
+        }
+
+        // A multishot request without F_MORE has terminated (e.g. ENOBUFS): re-arm it
+        if (live && !(cqe.flags & IORING_CQE_F_MORE)) {
+            armReceive(index);
+        }
+    }
+
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+
+    if (m_bufTail != bufTailStart) {
+        __atomic_store_n(&m_bufRing->tail, m_bufTail, __ATOMIC_RELEASE);
+    }
+
+    submit();
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
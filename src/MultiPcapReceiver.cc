@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/MultiPcapReceiver.h>
+
+namespace atu_reactor {
+
+namespace {
+
+inline int64_t toNs(const struct timespec& ts) noexcept {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// The files are only read: one record per step, without dispatching
+PcapConfig sourceConfig(PcapConfig config) {
+    config.mode = ReplayMode::STEP;
+    config.batchSize = 1;
+    return config;
+}
+
+} // namespace
+
+MultiPcapReceiver::MultiPcapReceiver(EventLoop& loopRef, PcapConfig config)
+        : PacketReceiver(loopRef, config), m_pcapConfig(config),
+        m_dispatcher(loopRef, config)
+{
+}
+
+Result<void> MultiPcapReceiver::open(const std::vector<std::string>& paths) {
+    checkThread();
+    m_dispatcher.flushBatch();
+    ++m_generation;
+    m_sources.clear();
+    m_heap.clear();
+    m_finished = true;
+
+    std::vector<Source> sources;
+    sources.reserve(paths.size());
+    for (const auto& path : paths) {
+        auto reader = std::make_unique<PcapReceiver>(m_loop, sourceConfig(m_pcapConfig));
+        if (auto res = reader->open(path); !res) {
+            return res;
+        }
+        reader->m_batchOwner = &m_dispatcher;
+        sources.push_back({std::move(reader), {}});
+    }
+
+    m_sources = std::move(sources);
+    m_heap.reserve(m_sources.size());
+    rebuildHeap();
+    return Result<void>::success();
+}
+
+Result<void> MultiPcapReceiver::loadIndex(uint32_t every) {
+    checkThread();
+    for (auto& src : m_sources) {
+        if (auto res = src.reader->loadIndex("", every); !res) {
+            return res;
+        }
+    }
+    return Result<void>::success();
+}
+
+Result<void> MultiPcapReceiver::seek(const struct timespec& ts) {
+    checkThread();
+    m_dispatcher.flushBatch();
+    ++m_generation;
+
+    for (auto& src : m_sources) {
+        auto res = src.reader->seek(ts);
+        if (!res && res.error().value() != ENOENT) {
+            return res;
+        }
+    }
+
+    rebuildHeap();
+    if (m_finished) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+    return Result<void>::success();
+}
+
+void MultiPcapReceiver::rewind() {
+    checkThread();
+    m_dispatcher.flushBatch();
+    ++m_generation;
+    for (auto& src : m_sources) {
+        src.reader->rewind();
+    }
+    rebuildHeap();
+}
+
+void MultiPcapReceiver::rebuildHeap() noexcept {
+    m_heap.clear();
+    for (uint32_t i = 0; i < m_sources.size(); ++i) {
+        Source& src = m_sources[i];
+        if (src.reader->m_currentPtr && src.reader->peekRecord(src.next)) {
+            m_heap.push_back({toNs(src.next.ts), i});
+        }
+    }
+    for (size_t i = m_heap.size() / 2; i-- > 0;) {
+        siftDown(i);
+    }
+
+    // TIMED pacing restarts from the earliest head
+    m_dispatcher.m_firstPacket = true;
+    m_finished = m_heap.empty();
+}
+
+void MultiPcapReceiver::siftDown(size_t i) noexcept {
+    const size_t n = m_heap.size();
+    const Head head = m_heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && earlier(m_heap[child + 1], m_heap[child])) ++child;
+        if (!earlier(m_heap[child], head)) break;
+        m_heap[i] = m_heap[child];
+        i = child;
+    }
+    m_heap[i] = head;
+}
+
+Result<int> MultiPcapReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
+    checkThread();
+    return m_dispatcher.subscribe(port, context, handler);
+}
+
+Result<int> MultiPcapReceiver::subscribeBatch(uint16_t port, void* context, PacketBatchHandlerFn handler) {
+    checkThread();
+    return m_dispatcher.subscribeBatch(port, context, handler);
+}
+
+Result<void> MultiPcapReceiver::unsubscribe(uint16_t port) {
+    checkThread();
+    return m_dispatcher.unsubscribe(port);
+}
+
+Result<int> MultiPcapReceiver::subscribeFlow(const FlowMatch& match, void* context, PacketHandlerFn handler) {
+    checkThread();
+    return m_dispatcher.subscribeFlow(match, context, handler);
+}
+
+Result<int> MultiPcapReceiver::subscribeFlowBatch(const FlowMatch& match, void* context,
+        PacketBatchHandlerFn handler) {
+    checkThread();
+    return m_dispatcher.subscribeFlowBatch(match, context, handler);
+}
+
+Result<void> MultiPcapReceiver::unsubscribeFlow(const FlowMatch& match) {
+    checkThread();
+    return m_dispatcher.unsubscribeFlow(match);
+}
+
+void MultiPcapReceiver::start() {
+    checkThread();
+    if (m_finished) return;
+
+    m_dispatcher.m_firstPacket = true;
+
+    // In STEP mode, we do nothing. User must call step().
+    if (m_pcapConfig.mode == ReplayMode::STEP) {
+        return;
+    }
+
+    m_loop.runInLoop(&MultiPcapReceiver::deferredBatch, this);
+}
+
+bool MultiPcapReceiver::step() {
+    checkThread();
+    bool processed = internalStep();
+    m_dispatcher.flushBatch();
+    return processed;
+}
+
+bool MultiPcapReceiver::internalStep() noexcept {
+    if (m_heap.empty()) [[unlikely]] {
+        m_finished = true;
+        return false;
+    }
+
+    Source& src = m_sources[m_heap[0].source];
+
+    if (m_pcapConfig.mode == ReplayMode::TIMED) {
+        auto wakeTime = m_dispatcher.calculateTargetTimeHighRes(src.next.ts) - m_pcapConfig.dispatchLead;
+        if (wakeTime > std::chrono::steady_clock::now()) {
+            m_loop.runAt(wakeTime, [this]() { this->processBatch(); }, m_pcapConfig.pacingSpin);
+            return false;
+        }
+    }
+
+    const uint64_t generation = m_generation;
+    m_dispatcher.dispatchRecord(src.next);
+
+    // A handler moved the replay (open, seek, rewind): src and the heap head are stale
+    if (m_generation != generation) [[unlikely]] {
+        return true;
+    }
+
+    // Usually a feed keeps the top for a while: siftDown stops at the first comparison
+    if (src.reader->advanceRecord(src.next)) [[likely]] {
+        m_heap[0].ns = toNs(src.next.ts);
+    } else {
+        m_heap[0] = m_heap.back();
+        m_heap.pop_back();
+        if (m_heap.empty()) {
+            m_finished = true;
+            return true;
+        }
+    }
+    siftDown(0);
+    return true;
+}
+
+void MultiPcapReceiver::processBatch() {
+    if (m_finished) return;
+
+    const int stopLimit = (m_pcapConfig.mode == ReplayMode::FLOOD)
+                          ? 10000
+                          : m_pcapConfig.batchSize;
+
+    for (int i = 0; i < stopLimit; ++i) {
+        if (!internalStep()) {
+            m_dispatcher.flushBatch();
+            return;
+        }
+    }
+
+    // Hand partial batches over before yielding to the loop
+    m_dispatcher.flushBatch();
+
+    if (m_finished) [[unlikely]] {
+        return;
+    }
+
+    // FLOOD yields to the loop; TIMED catches up on the next iteration
+    m_loop.runInLoop(&MultiPcapReceiver::deferredBatch, this);
+}
+
+void MultiPcapReceiver::deferredBatch(void* self) {
+    static_cast<MultiPcapReceiver*>(self)->processBatch();
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
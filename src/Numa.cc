@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include "Numa.h"
+
+// System headers
+#include <cerrno>
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace atu_reactor::detail {
+
+namespace {
+
+bool nodeMask(int node, unsigned long (&mask)[NODE_MASK_WORDS]) {
+    if (node < 0 || static_cast<unsigned long>(node) >= MAX_NUMA_NODES) return false;
+    for (auto& word : mask) word = 0;
+    const auto bits = 8 * sizeof(unsigned long);
+    mask[static_cast<size_t>(node) / bits] = 1UL << (static_cast<size_t>(node) % bits);
+    return true;
+}
+
+// Parses a sysfs list such as "0-3,8-11" into cpus
+bool parseCpuList(const std::string& list, cpu_set_t& cpus) {
+    CPU_ZERO(&cpus);
+    size_t pos = 0;
+    bool any = false;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(pos, end - pos);
+        pos = end + 1;
+        if (range.empty()) continue;
+
+        const size_t dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+                CPU_SET(cpu, &cpus);
+                any = true;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return any;
+}
+
+} // namespace
+
+int interfaceNumaNode(const std::string& interface) {
+    std::ifstream in("/sys/class/net/" + interface + "/device/numa_node");
+    int node = -1;
+    if (!(in >> node)) return -1;
+    return node;
+}
+
+Result<void> pinThreadToNode(int node) {
+    std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    std::string list;
+    if (node < 0 || !std::getline(in, list)) {
+        return std::error_code(ENODEV, std::system_category());
+    }
+
+    cpu_set_t cpus;
+    if (!parseCpuList(list, cpus)) {
+        return std::error_code(ENODEV, std::system_category());
+    }
+    if (int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); rc != 0) {
+        return std::error_code(rc, std::system_category());
+    }
+    return Result<void>::success();
+}
+
+Result<void> bindToNode(void* addr, size_t len, int node) {
+    unsigned long mask[NODE_MASK_WORDS];
+    if (!nodeMask(node, mask)) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+    if (::syscall(SYS_mbind, addr, len, MPOL_PREFERRED, mask, MAX_NUMA_NODES, 0) < 0 && errno != ENOSYS) {
+        return std::error_code(errno, std::system_category());
+    }
+    return Result<void>::success();
+}
+
+void prefault(uint8_t* addr, size_t len) {
+    // A write, not a read: reads of untouched anonymous memory map the zero page
+    for (size_t off = 0; off < len; off += 4096) {
+        static_cast<volatile uint8_t*>(addr)[off] = 0;
+    }
+}
+
+NodeAllocScope::NodeAllocScope(int node) {
+    unsigned long mask[NODE_MASK_WORDS];
+    if (!nodeMask(node, mask)) return;
+
+    // The thread may run a policy of its own: put it back afterwards
+    if (::syscall(SYS_get_mempolicy, &m_savedMode, m_savedMask, MAX_NUMA_NODES, nullptr, 0) < 0) return;
+    m_active = ::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, MAX_NUMA_NODES) == 0;
+}
+
+NodeAllocScope::~NodeAllocScope() {
+    if (m_active) {
+        const bool noMask = m_savedMode == MPOL_DEFAULT || m_savedMode == MPOL_LOCAL;
+        (void)::syscall(SYS_set_mempolicy, m_savedMode, noMask ? nullptr : m_savedMask,
+                noMask ? 0 : MAX_NUMA_NODES);
+    }
+}
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
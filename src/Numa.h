@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Library headers
+#include <atu_reactor/Result.h>
+
+namespace atu_reactor::detail {
+
+// Node masks passed to the mempolicy syscalls (libnuma is not a dependency)
+constexpr unsigned long MAX_NUMA_NODES = 1024;
+constexpr size_t NODE_MASK_WORDS = MAX_NUMA_NODES / (8 * sizeof(unsigned long));
+
+/**
+ * @brief NUMA node of a network interface, from /sys/class/net/<if>/device/numa_node.
+ * @return The node, or -1 for virtual devices and single-node machines.
+ */
+int interfaceNumaNode(const std::string& interface);
+
+/**
+ * @brief Pins the calling thread to the CPUs of a node (its sysfs cpulist).
+ */
+Result<void> pinThreadToNode(int node);
+
+/**
+ * @brief mbind(MPOL_PREFERRED) of a mapping that has not been touched yet.
+ * A kernel without NUMA support (ENOSYS) counts as success: it has one node.
+ */
+Result<void> bindToNode(void* addr, size_t len, int node);
+
+/**
+ * @brief Writes every 4KB page so the first packets take no page faults.
+ */
+void prefault(uint8_t* addr, size_t len);
+
+/**
+ * @brief Prefers a node for the heap allocations made by this thread in scope.
+ * Storage is placed when it is first written, so allocate and initialize
+ * (e.g. vector::resize) inside the scope. Node -1 does nothing.
+ */
+class NodeAllocScope {
+    public:
+        explicit NodeAllocScope(int node);
+        ~NodeAllocScope();
+
+        NodeAllocScope(const NodeAllocScope&) = delete;
+        NodeAllocScope& operator=(const NodeAllocScope&) = delete;
+
+    private:
+        bool m_active = false;
+        int m_savedMode = 0;
+        unsigned long m_savedMask[NODE_MASK_WORDS] = {};
+};
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -23,14 +23,27 @@
 #include <stdexcept>
 #include <sys/mman.h>
 
+// Library headers
+#include "HugePages.h"
+#include "Numa.h"
+
 namespace atu_reactor {
 
 PacketReceiver::PacketReceiver(EventLoop& loopRef, ReceiverConfig config)
         : m_loop(loopRef),
         m_config(config),
         m_ownerThreadId(std::this_thread::get_id()),
-        m_ioVectors(config.batchSize) // Pre-size directly in initializer
+        m_numaNode(config.numaNode >= 0 || config.numaInterface.empty()
+            ? config.numaNode
+            : detail::interfaceNumaNode(config.numaInterface))
 {
+    // Pin before allocating: whatever the thread touches from now on is local
+    if (m_config.pinToNode && m_numaNode >= 0) {
+        if (auto res = detail::pinThreadToNode(m_numaNode); !res) {
+            throw std::runtime_error("Failed to pin receiver thread to NUMA node: " + res.error().message());
+        }
+    }
+
     // Calculate size and alignment
     // Round up the buffer size to a multiple of 64 for cache-line alignment
     m_alignedBufferSize = (m_config.bufferSize + 63) & ~63; // Round up to multiple of 64
@@ -38,29 +51,31 @@ PacketReceiver::PacketReceiver(EventLoop& loopRef, ReceiverConfig config)
     // Total memory needed for all packets
     const size_t totalRequested = m_config.batchSize * m_alignedBufferSize;
 
-    // Hugepages are typically 2MB. We round up the total mapping size to a 2MB boundary.
-    const size_t HUGEPAGE_SIZE = 2 * 1024 * 1024;
-    m_mappedSize = (totalRequested + HUGEPAGE_SIZE - 1) & ~(HUGEPAGE_SIZE - 1);
-
-    // Memory Allocation via mmap
-    // Try to allocate memory using Hugepages first for better TLB performance
-    m_hugeBuffer = static_cast<uint8_t*>(mmap(nullptr, m_mappedSize,
-        PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0));
-
-    // Fallback: If Hugepages are not available/reserved, use standard 4KB pages
-    if (m_hugeBuffer == MAP_FAILED) {
-        m_hugeBuffer = static_cast<uint8_t*>(mmap(nullptr, m_mappedSize,
-            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    // Memory Allocation via mmap (hugepages first, 4KB pages as fallback)
+    m_hugeBuffer = detail::mapHugeBuffer(totalRequested, m_mappedSize);
+    if (m_hugeBuffer == nullptr) {
+        throw std::runtime_error("Failed to allocate packet buffer via mmap");
+    }
 
-        if (m_hugeBuffer == MAP_FAILED) {
-            m_mappedSize = 0;
-            throw std::runtime_error("Failed to allocate packet buffer via mmap");
+    // The policy must be in place before the first write faults the pages in
+    if (m_numaNode >= 0) {
+        if (auto res = detail::bindToNode(m_hugeBuffer, m_mappedSize, m_numaNode); !res) {
+            ::munmap(m_hugeBuffer, m_mappedSize);
+            throw std::runtime_error("Failed to bind packet buffer to NUMA node: " + res.error().message());
         }
     }
+    if (m_config.prefault) {
+        detail::prefault(m_hugeBuffer, m_mappedSize);
+    }
 
     // Set the base pointer for the recvmmsg logic
     m_cachedBasePtr = m_hugeBuffer;
 
+    {
+        detail::NodeAllocScope local(m_numaNode);
+        m_ioVectors.resize(static_cast<size_t>(m_config.batchSize));
+    }
+
     // Initialize iovecs using the aligned stride
     for (int i = 0; i < m_config.batchSize; ++i) {
         // Calculate offset into the flat buffer
@@ -80,7 +95,7 @@ PacketReceiver::~PacketReceiver() {
     }
 
     // Manually unmap the buffer
-    if (m_hugeBuffer != nullptr && m_hugeBuffer != MAP_FAILED) {
+    if (m_hugeBuffer != nullptr) {
         ::munmap(m_hugeBuffer, m_mappedSize);
     }
 }
@@ -95,6 +110,23 @@ Result<int> PacketReceiver::subscribe(uint16_t port,
         return std::error_code(EINVAL, std::system_category());
     }
 
+    if (auto res = checkSubscribe(port); !res) {
+        return res.error();
+    }
+
+    return Result<int>(0); // Base says "OK to proceed"
+}
+
+Result<int> PacketReceiver::subscribeBatch(uint16_t,
+                                           void*,
+                                           PacketBatchHandlerFn) {
+    checkThread();
+    return std::error_code(EOPNOTSUPP, std::system_category());
+}
+
+Result<void> PacketReceiver::checkSubscribe(uint16_t port) const {
+    checkThread();
+
     // Use the OS limit check only if you explicitly want to cap this instance
     if (m_config.maxFds > 0 && m_port_to_fd_map.size() >= static_cast<size_t>(m_config.maxFds)) {
         return std::error_code(EMFILE, std::system_category());
@@ -104,7 +136,7 @@ Result<int> PacketReceiver::subscribe(uint16_t port,
         return std::error_code(EADDRINUSE, std::system_category());
     }
 
-    return Result<int>(0); // Base says "OK to proceed"
+    return Result<void>::success();
 }
 
 Result<void> PacketReceiver::unsubscribe(uint16_t port) {
@@ -133,10 +165,22 @@ Result<void> PacketReceiver::unsubscribe(uint16_t port) {
     return loopRes;
 }
 
+int PacketReceiver::getFd(uint16_t port) const {
+    checkThread();
+
+    auto it = m_port_to_fd_map.find(port);
+    return (it != m_port_to_fd_map.end()) ? static_cast<int>(it->second) : -1;
+}
+
 void PacketReceiver::dispatch(int n, const PacketMetadata* meta, PacketHandlerFn handler, void* context) {
     for (int i = 0; i < n; ++i) {
-        uint8_t* packetData = m_cachedBasePtr + (i * m_alignedBufferSize);
-        handler(context, packetData, meta[i].len, PacketStatus::OK, meta[i].ts);
+        // Empty datagrams carry nothing for the per-packet handler
+        if (meta[i].len > 0) {
+            // Hand out the most precise stamp available
+            const struct timespec& ts = (meta[i].status & PacketStatus::HW_TIMESTAMP)
+                ? meta[i].hwTs : meta[i].ts;
+            handler(context, meta[i].data, meta[i].len, meta[i].status, ts);
+        }
     }
 }
 
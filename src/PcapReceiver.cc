@@ -19,21 +19,41 @@
 #include <atu_reactor/PcapReceiver.h>
 
 // System headers
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
 #include <net/ethernet.h>
 #include <netinet/in.h>
 #include <netinet/ip.h>
 #include <netinet/udp.h>
 #include <iostream>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <thread>
 #include <unistd.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Library headers
+#include "FlowTable.h"
 
 // Fallback for non-standard Linux headers
 #ifndef ETHERTYPE_VLAN
 #define ETHERTYPE_VLAN 0x8100
 #endif
+#ifndef ETHERTYPE_IPV6
+#define ETHERTYPE_IPV6 0x86dd
+#endif
+#ifndef ETHERTYPE_QINQ
+#define ETHERTYPE_QINQ 0x88a8   // 802.1ad service tag
+#endif
 
 // Link Types
 #ifndef DLT_EN10MB
@@ -45,16 +65,85 @@
 
 namespace atu_reactor {
 
+/**
+ * Streaming mode: readahead(2) blocks until the range is in the page cache,
+ * so it runs here rather than on the reactor. Requests are signalled through
+ * an eventfd and only the latest one is kept; the reactor asks for the next
+ * window each time it slides.
+ */
+struct PcapReceiver::Prefetcher {
+    explicit Prefetcher(int fdIn)
+        : fd(fdIn), wakeFd(::eventfd(0, EFD_CLOEXEC)), worker([this]() { run(); }) {}
+
+    ~Prefetcher() {
+        stop.store(true, std::memory_order_relaxed);
+        kick();
+        worker.join();
+    }
+
+    void request(uint64_t offset, size_t len) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingOffset = offset;
+            pendingLen = len;
+        }
+        kick();
+    }
+
+    void kick() {
+        uint64_t one = 1;
+        if (::write(wakeFd, &one, sizeof(one)) < 0) {
+            // Counter saturated: the thread is already due to wake up
+        }
+    }
+
+    void run() {
+        uint64_t count;
+        for (;;) {
+            if (::read(wakeFd, &count, sizeof(count)) < 0) {
+                if (errno == EINTR) continue;
+                return;     // No eventfd: streaming still works, without readahead
+            }
+            if (stop.load(std::memory_order_relaxed)) return;
+
+            uint64_t offset;
+            size_t len;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                offset = pendingOffset;
+                len = pendingLen;
+                pendingLen = 0;
+            }
+            if (len > 0) {
+                ::readahead(fd, static_cast<off64_t>(offset), len);
+            }
+        }
+    }
+
+    int fd;
+    ScopedFd wakeFd;
+    std::atomic<bool> stop{false};
+    std::mutex mutex;
+    uint64_t pendingOffset = 0;
+    size_t pendingLen = 0;
+    std::thread worker;
+};
+
 PcapReceiver::PcapReceiver(EventLoop& loopRef, PcapConfig config)
         : PacketReceiver(loopRef, config), m_pcapConfig(config),
-        m_portTable(std::make_unique<Subscription[]>(65536)),
-        m_finished(false)
+        m_flows(std::make_unique<detail::FlowTable<Subscription>>()),
+        m_finished(false),
+        m_batch(config.batchSize > 0 ? config.batchSize : 1)
 {
+    selectSteps();
 }
 
 PcapReceiver::~PcapReceiver() {
+    // Stop readahead before the descriptor goes away
+    m_prefetcher.reset();
+
     if (m_mappedData && m_mappedData != MAP_FAILED) {
-        munmap(m_mappedData, m_fileSize);
+        munmap(m_mappedData, m_windowSize);
     }
     if (m_fd >= 0) {
         ::close(m_fd);
@@ -76,18 +165,37 @@ Result<void> PcapReceiver::open(const std::string& path) {
         return std::error_code(errno, std::system_category());
     }
     m_fileSize = st.st_size;
+    m_path = path;
+    m_fileMtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    m_index.clear();
 
     // 3. Map into Memory
-    void* mapped = mmap(nullptr, m_fileSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, m_fd, 0);
-    if (mapped == MAP_FAILED) {
-        ::close(m_fd);
-        m_fd = -1;
-        return std::error_code(errno, std::system_category());
-    }
+    if (m_pcapConfig.streamWindow > 0) {
+        // Startup cost and RSS are bounded by the window, whatever the file size
+        m_prefetcher = std::make_unique<Prefetcher>(m_fd);
+        if (!mapWindow(0, sizeof(pcap_file_header))) {
+            m_prefetcher.reset();
+            ::close(m_fd);
+            m_fd = -1;
+            return std::error_code(errno ? errno : EINVAL, std::system_category());
+        }
+    } else {
+        void* mapped = mmap(nullptr, m_fileSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, m_fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(m_fd);
+            m_fd = -1;
+            return std::error_code(errno, std::system_category());
+        }
 
-    // Convert to uint8_t* for arithmetic
-    m_mappedData = static_cast<uint8_t*>(mapped);
-    madvise(m_mappedData, m_fileSize, MADV_SEQUENTIAL | MADV_WILLNEED);
+        // Convert to uint8_t* for arithmetic
+        m_mappedData = static_cast<uint8_t*>(mapped);
+        madvise(m_mappedData, m_fileSize, MADV_SEQUENTIAL | MADV_WILLNEED);
+
+        m_windowOffset = 0;
+        m_windowSize = m_fileSize;
+        m_windowEnd = m_mappedData + m_fileSize;
+        m_currentPtr = m_mappedData;
+    }
 
     // 4. Parse Global Header (24 bytes)
     if (m_fileSize < sizeof(pcap_file_header)) {
@@ -95,7 +203,6 @@ Result<void> PcapReceiver::open(const std::string& path) {
     }
 
     auto* g_hdr = reinterpret_cast<const pcap_file_header*>(m_mappedData);
-    m_currentPtr = m_mappedData;
 
     // Detect format based on Magic Number
     if (g_hdr->magic_number == MAGIC_PCAPNG_SHB) {
@@ -146,21 +253,592 @@ Result<void> PcapReceiver::open(const std::string& path) {
         m_currentPtr += sizeof(pcap_file_header);
     }
 
+    selectSteps();
     return Result<void>::success();
 }
 
 void PcapReceiver::rewind() {
     checkThread();
-    m_currentPtr = m_mappedData;
-    // Move cursor back to the start of the first packet
-    if (!m_isPcapNg) {
-        // right after global header
-        m_currentPtr += sizeof(pcap_file_header);
+    if (!m_mappedData) return;
+
+    // Move cursor back to the start of the first packet (right after the global header)
+    const uint64_t start = m_isPcapNg ? 0 : sizeof(pcap_file_header);
+    if (m_windowOffset == 0) {
+        m_currentPtr = m_mappedData + start;
+    } else {
+        m_batchOwner->flushBatch();
+        if (!mapWindow(start, 0)) return;
     }
+
+    // The section header and interface blocks are read again, each one
+    // overwriting its entry (entries restored from an index stay valid)
+    m_interfaceCount = 0;
+
     m_finished = false;
     m_firstPacket = true;
 }
 
+bool PcapReceiver::ensure(size_t bytes) noexcept {
+    if (static_cast<size_t>(m_windowEnd - m_currentPtr) >= bytes) [[likely]] {
+        return true;
+    }
+    return slideWindow(bytes);
+}
+
+bool PcapReceiver::slideWindow(size_t bytes) noexcept {
+    const uint64_t offset = m_windowOffset + static_cast<uint64_t>(m_currentPtr - m_mappedData);
+    if (m_pcapConfig.streamWindow == 0 || offset + bytes > m_fileSize) {
+        return false;   // End of file, or a record cut short by it
+    }
+
+    // Pending batch entries point into the window about to be unmapped
+    m_batchOwner->flushBatch();
+    return mapWindow(offset, bytes);
+}
+
+bool PcapReceiver::mapWindow(uint64_t offset, size_t bytes) noexcept {
+    static const uint64_t pageMask = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE)) - 1;
+
+    // Grow past the configured window when a single record needs it
+    const uint64_t base = offset & ~pageMask;
+    uint64_t len = std::max<uint64_t>(m_pcapConfig.streamWindow, offset - base + bytes);
+    len = std::min<uint64_t>((len + pageMask) & ~pageMask, m_fileSize - base);
+
+    if (m_mappedData) {
+        ::munmap(m_mappedData, m_windowSize);
+
+        // A forward replay never reads the consumed pages again: keep them
+        // from pushing everything else out of the page cache
+        if (base > m_windowOffset) {
+            ::posix_fadvise(m_fd, static_cast<off_t>(m_windowOffset),
+                    static_cast<off_t>(base - m_windowOffset), POSIX_FADV_DONTNEED);
+        }
+    }
+
+    void* mapped = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE | MAP_POPULATE, m_fd, static_cast<off_t>(base));
+    if (mapped == MAP_FAILED) [[unlikely]] {
+        m_mappedData = nullptr;
+        m_windowSize = 0;
+        m_windowEnd = nullptr;
+        m_currentPtr = nullptr;
+        m_finished = true;
+        return false;
+    }
+
+    m_mappedData = static_cast<uint8_t*>(mapped);
+    m_windowOffset = base;
+    m_windowSize = len;
+    m_windowEnd = m_mappedData + len;
+    m_currentPtr = m_mappedData + (offset - base);
+    madvise(m_mappedData, len, MADV_SEQUENTIAL);
+
+    if (base + len < m_fileSize) {
+        m_prefetcher->request(base + len, std::min<uint64_t>(len, m_fileSize - base - len));
+    }
+    return true;
+}
+
+bool PcapReceiver::moveTo(uint64_t offset) noexcept {
+    if (m_mappedData && offset >= m_windowOffset && offset <= m_windowOffset + m_windowSize) {
+        m_currentPtr = m_mappedData + (offset - m_windowOffset);
+        return true;
+    }
+    if (m_pcapConfig.streamWindow == 0 || offset > m_fileSize) {
+        return false;
+    }
+
+    m_batchOwner->flushBatch();
+    return mapWindow(offset, 0);
+}
+
+size_t PcapReceiver::recordSize(const uint8_t* p) const noexcept {
+    if (!m_isPcapNg) {
+        auto* hdr = reinterpret_cast<const pcap_sf_pkthdr*>(p);
+        return sizeof(pcap_sf_pkthdr) + (m_swapped ? __builtin_bswap32(hdr->caplen) : hdr->caplen);
+    }
+    auto* bh = reinterpret_cast<const PcapNgBlockHeader*>(p);
+    return m_swapped ? __builtin_bswap32(bh->totalLength) : bh->totalLength;
+}
+
+bool PcapReceiver::decodeAt(const uint8_t* p, Record& rec) const noexcept {
+    if (!m_isPcapNg) {
+        auto* hdr = reinterpret_cast<const pcap_sf_pkthdr*>(p);
+        uint32_t sec      = m_swapped ? __builtin_bswap32(hdr->ts_sec)  : hdr->ts_sec;
+        uint32_t fraction = m_swapped ? __builtin_bswap32(hdr->ts_usec) : hdr->ts_usec;
+        rec.caplen        = m_swapped ? __builtin_bswap32(hdr->caplen)  : hdr->caplen;
+        rec.len           = m_swapped ? __builtin_bswap32(hdr->len)     : hdr->len;
+
+        rec.ts.tv_sec = sec;
+        rec.ts.tv_nsec = static_cast<long>(fraction);
+        if (!m_isNanosecond) {
+            rec.ts.tv_nsec *= 1000;
+        }
+        rec.data = p + sizeof(pcap_sf_pkthdr);
+        rec.linkType = m_linkType;
+        rec.size = sizeof(pcap_sf_pkthdr) + rec.caplen;
+        return true;
+    }
+
+    auto* bh = reinterpret_cast<const PcapNgBlockHeader*>(p);
+    uint32_t type = m_swapped ? __builtin_bswap32(bh->type) : bh->type;
+    rec.size = m_swapped ? __builtin_bswap32(bh->totalLength) : bh->totalLength;
+    if (type != PCAPNG_EPB) return false;
+
+    auto* epb = reinterpret_cast<const PcapNgEPBBody*>(p + sizeof(PcapNgBlockHeader));
+    uint32_t ifId = m_swapped ? __builtin_bswap32(epb->interfaceId) : epb->interfaceId;
+    uint64_t high = m_swapped ? __builtin_bswap32(epb->timestampHigh) : epb->timestampHigh;
+    uint64_t low  = m_swapped ? __builtin_bswap32(epb->timestampLow)  : epb->timestampLow;
+    uint64_t tsRaw = (high << 32) | low;
+
+    // Read-only lookup: parallel workers decode concurrently
+    auto it = m_interfaces.find(ifId);
+    const bool known = it != m_interfaces.end();
+    const uint64_t divisor = known ? it->second.tsResolutionDivisor : 1000000;
+    rec.ts.tv_sec  = static_cast<time_t>(tsRaw / divisor);
+    rec.ts.tv_nsec = static_cast<long>((tsRaw % divisor) * 1000000000ULL / divisor);
+    rec.caplen = m_swapped ? __builtin_bswap32(epb->capLen)  : epb->capLen;
+    rec.len    = m_swapped ? __builtin_bswap32(epb->origLen) : epb->origLen;
+    rec.data = p + sizeof(PcapNgBlockHeader) + sizeof(PcapNgEPBBody);
+    rec.linkType = known ? it->second.linkType : DLT_EN10MB;
+    return true;
+}
+
+bool PcapReceiver::peekRecord(Record& rec) noexcept {
+    const size_t headerLen = m_isPcapNg ? sizeof(PcapNgBlockHeader) : sizeof(pcap_sf_pkthdr);
+    while (true) {
+        if (!ensure(headerLen)) return false;
+
+        const size_t size = recordSize(m_currentPtr);
+        if (size < headerLen || !ensure(size)) return false;
+
+        if (decodeAt(m_currentPtr, rec)) return true;
+
+        // pcapng block that is not a packet
+        auto* bh = reinterpret_cast<const PcapNgBlockHeader*>(m_currentPtr);
+        if ((m_swapped ? __builtin_bswap32(bh->type) : bh->type) == PCAPNG_IDB) {
+            parseInterfaceBlock(static_cast<uint32_t>(size));
+        }
+        m_currentPtr += size;
+    }
+}
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'A', 'T', 'U', 'P', 'I', 'D', 'X', '\0'};
+constexpr uint32_t INDEX_VERSION = 1;
+
+// Sidecar layout (host byte order: the index is a cache, not an exchange format)
+struct IndexFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t interval;
+    uint64_t fileSize;
+    int64_t mtimeNs;        // Capture mtime: a rewritten capture invalidates the index
+    uint32_t interfaceCount;
+    uint32_t reserved;
+    uint64_t entryCount;
+    // IndexFileInterface[interfaceCount], then IndexEntry[entryCount]
+};
+
+// Block header, link type, reserved, snap length and trailing length
+constexpr uint64_t MIN_INTERFACE_BLOCK = 20;
+
+struct IndexFileInterface {
+    uint32_t linkType;
+    uint32_t reserved;
+    uint64_t tsResolutionDivisor;
+};
+
+inline int64_t toNs(const struct timespec& ts) noexcept {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+bool readAll(int fd, void* buf, size_t len) noexcept {
+    auto* p = static_cast<uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = ::read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const void* buf, size_t len) noexcept {
+    auto* p = static_cast<const uint8_t*>(buf);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+void PcapReceiver::buildIndex(uint32_t every) {
+    m_batchOwner->flushBatch();
+    const uint64_t saved = currentOffset();
+    const bool finished = m_finished;
+    const bool firstPacket = m_firstPacket;
+
+    // One pass from the first record; pcapng interface blocks are parsed again
+    rewind();
+    m_index.clear();
+
+    int64_t maxNs = INT64_MIN;
+    uint64_t count = 0;
+    Record rec;
+    while (m_currentPtr && peekRecord(rec)) {
+        if (count % every == 0) {
+            m_index.push_back({currentOffset(), maxNs});
+        }
+        maxNs = std::max(maxNs, toNs(rec.ts));
+        m_currentPtr += rec.size;
+        ++count;
+    }
+
+    moveTo(saved);
+    m_finished = finished;
+    m_firstPacket = firstPacket;
+}
+
+bool PcapReceiver::readIndex(const std::string& path, uint32_t every) {
+    ScopedFd fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd < 0) return false;
+
+    IndexFileHeader hdr;
+    if (!readAll(fd, &hdr, sizeof(hdr))) return false;
+    if (std::memcmp(hdr.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0
+            || hdr.version != INDEX_VERSION
+            || hdr.interval != every
+            || hdr.fileSize != m_fileSize
+            || hdr.mtimeNs != m_fileMtimeNs
+            || hdr.entryCount > m_fileSize) {
+        return false;   // Stale, or built with another interval
+    }
+
+    // Corrupt: more interfaces than interface blocks fit in the capture
+    const uint64_t maxInterfaces = m_isPcapNg ? m_fileSize / MIN_INTERFACE_BLOCK : 0;
+    if (hdr.interfaceCount > maxInterfaces) {
+        return false;
+    }
+
+    std::vector<IndexFileInterface> interfaces(hdr.interfaceCount);
+    std::vector<IndexEntry> entries(hdr.entryCount);
+    if (!readAll(fd, interfaces.data(), interfaces.size() * sizeof(IndexFileInterface))
+            || !readAll(fd, entries.data(), entries.size() * sizeof(IndexEntry))) {
+        return false;
+    }
+    for (const auto& interface : interfaces) {
+        if (interface.tsResolutionDivisor == 0) return false;   // Timestamps are divided by it
+    }
+
+    // Seeking into a pcapng file skips its interface blocks: restore them
+    if (m_isPcapNg) {
+        m_interfaces.clear();
+        for (uint32_t i = 0; i < hdr.interfaceCount; ++i) {
+            m_interfaces[i] = {static_cast<uint16_t>(interfaces[i].linkType),
+                interfaces[i].tsResolutionDivisor};
+        }
+        m_interfaceCount = hdr.interfaceCount;
+    }
+    m_index = std::move(entries);
+    return true;
+}
+
+void PcapReceiver::writeIndex(const std::string& path, uint32_t every) const {
+    IndexFileHeader hdr{};
+    std::memcpy(hdr.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    hdr.version = INDEX_VERSION;
+    hdr.interval = every;
+    hdr.fileSize = m_fileSize;
+    hdr.mtimeNs = m_fileMtimeNs;
+    hdr.interfaceCount = m_isPcapNg ? m_interfaceCount : 0;
+    hdr.entryCount = m_index.size();
+
+    std::vector<IndexFileInterface> interfaces(hdr.interfaceCount);
+    for (uint32_t i = 0; i < hdr.interfaceCount; ++i) {
+        auto it = m_interfaces.find(i);
+        if (it != m_interfaces.end()) {
+            interfaces[i] = {it->second.linkType, 0, it->second.tsResolutionDivisor};
+        }
+    }
+
+    // Written aside and renamed so a concurrent reader never sees half an index
+    const std::string tmp = path + ".tmp";
+    ScopedFd fd(::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+    if (fd < 0) return;
+
+    bool ok = writeAll(fd, &hdr, sizeof(hdr))
+        && writeAll(fd, interfaces.data(), interfaces.size() * sizeof(IndexFileInterface))
+        && writeAll(fd, m_index.data(), m_index.size() * sizeof(IndexEntry));
+    if (!ok || ::rename(tmp.c_str(), path.c_str()) < 0) {
+        ::unlink(tmp.c_str());
+    }
+}
+
+Result<void> PcapReceiver::loadIndex(const std::string& indexPath, uint32_t every) {
+    checkThread();
+    if (m_fd < 0) return std::error_code(EBADF, std::system_category());
+    if (every == 0) return std::error_code(EINVAL, std::system_category());
+
+    const std::string path = indexPath.empty() ? m_path + ".idx" : indexPath;
+    if (readIndex(path, every)) {
+        return Result<void>::success();
+    }
+
+    buildIndex(every);
+    writeIndex(path, every);   // Best effort: the index is kept in memory either way
+    return Result<void>::success();
+}
+
+Result<void> PcapReceiver::seek(const struct timespec& ts) {
+    checkThread();
+    if (m_fd < 0) return std::error_code(EBADF, std::system_category());
+
+    m_batchOwner->flushBatch();
+    const int64_t target = toNs(ts);
+
+    if (m_index.empty()) {
+        rewind();
+    } else {
+        // Every record before an entry is older than its maxBeforeNs: the first
+        // packet at or after target follows the last entry still below it
+        auto it = std::partition_point(m_index.begin(), m_index.end(),
+                [target](const IndexEntry& e) { return e.maxBeforeNs < target; });
+        if (it != m_index.begin()) --it;
+        if (!moveTo(it->offset)) {
+            return std::error_code(EIO, std::system_category());
+        }
+    }
+
+    Record rec;
+    while (m_currentPtr && peekRecord(rec)) {
+        if (toNs(rec.ts) >= target) {
+            // TIMED pacing restarts from the packet found
+            m_finished = false;
+            m_firstPacket = true;
+            return Result<void>::success();
+        }
+        m_currentPtr += rec.size;
+    }
+
+    m_finished = true;
+    return std::error_code(ENOENT, std::system_category());
+}
+
+namespace {
+
+// Target chunk size of the parallel FLOOD: large enough for thread start-up
+// to vanish, small enough that one round of descriptors stays cache friendly
+constexpr uint64_t PARALLEL_CHUNK_BYTES = 4 * 1024 * 1024;
+
+// Runs fn(0..n-1), fn(0) on the calling thread
+template <typename Fn>
+void runOnWorkers(unsigned n, Fn&& fn) {
+    std::vector<std::thread> threads;
+    threads.reserve(n - 1);
+    for (unsigned w = 1; w < n; ++w) {
+        threads.emplace_back([&fn, w]() { fn(w); });
+    }
+    fn(0);
+    for (auto& t : threads) t.join();
+}
+
+} // namespace
+
+// Phase one sink: files the packets of one chunk under the worker owning their port
+struct PcapReceiver::ChunkSink {
+    // A packet found by a parsing worker, waiting for the worker owning its port
+    struct Packet {
+        struct timespec ts;
+        const uint8_t* data;
+        const Subscription* sub;
+        uint32_t len;
+        uint32_t status;
+        uint16_t portNet;
+    };
+
+    const detail::FlowTable<Subscription>* flows;
+    const Subscription* found = nullptr;
+    std::vector<std::vector<Packet>> perWorker;
+
+    bool lookupFlow(uint16_t dstPortNet, const uint8_t* ip, bool v6) noexcept {
+        bool portWide;
+        found = flows->find(dstPortNet, ip, v6, portWide);
+        return found != nullptr;
+    }
+
+    void deliver(uint16_t dstPortNet, const uint8_t* payload, size_t len,
+            uint32_t status, const struct timespec& ts) {
+        const size_t owner = ntohs(dstPortNet) % perWorker.size();
+        perWorker[owner].push_back({ts, payload, found, static_cast<uint32_t>(len), status, dstPortNet});
+    }
+};
+
+std::vector<uint64_t> PcapReceiver::chunkBounds(size_t chunks) {
+    const uint64_t start = m_isPcapNg ? 0 : sizeof(pcap_file_header);
+    const uint64_t step = std::max<uint64_t>((m_fileSize - start) / chunks, 1);
+    std::vector<uint64_t> bounds{start};
+
+    if (!m_index.empty()) {
+        // Sampled record offsets are boundaries already
+        for (const auto& entry : m_index) {
+            if (entry.offset >= bounds.back() + step) bounds.push_back(entry.offset);
+        }
+    } else {
+        // Header-only walk; pcapng interface blocks are parsed on the way
+        rewind();
+        Record rec;
+        while (peekRecord(rec)) {
+            const uint64_t offset = currentOffset();
+            if (offset >= bounds.back() + step) bounds.push_back(offset);
+            m_currentPtr += rec.size;
+        }
+    }
+    bounds.push_back(m_fileSize);
+    return bounds;
+}
+
+void PcapReceiver::parseChunk(ChunkSink& sink, const uint8_t* p, const uint8_t* end) const {
+    const size_t headerLen = m_isPcapNg ? sizeof(PcapNgBlockHeader) : sizeof(pcap_sf_pkthdr);
+    Record rec;
+    while (static_cast<size_t>(end - p) >= headerLen) {
+        const size_t size = recordSize(p);
+        if (size < headerLen || size > static_cast<size_t>(end - p)) [[unlikely]] {
+            return;     // Cut short by the end of the file
+        }
+        if (decodeAt(p, rec)) {
+            parseAndDispatch(sink, rec.ts, rec.caplen, rec.len, rec.data, rec.linkType);
+        }
+        p += size;
+    }
+}
+
+Result<uint64_t> PcapReceiver::floodParallel(unsigned workers, const std::vector<void*>& contexts) {
+    checkThread();
+    if (!m_mappedData) return std::error_code(EBADF, std::system_category());
+    if (m_pcapConfig.streamWindow > 0) return std::error_code(EOPNOTSUPP, std::system_category());
+    if (workers == 0 || (!contexts.empty() && contexts.size() != workers)) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+    flushBatch();
+
+    const size_t chunkCount = std::max<size_t>(workers, m_fileSize / PARALLEL_CHUNK_BYTES);
+    const std::vector<uint64_t> bounds = chunkBounds(chunkCount);
+    const size_t chunks = bounds.size() - 1;
+
+    std::vector<ChunkSink> sinks(workers);
+    for (auto& sink : sinks) {
+        sink.flows = m_flows.get();
+        sink.perWorker.resize(workers);
+    }
+    std::vector<uint64_t> delivered(workers, 0);
+    const size_t batchSize = m_batch.size();
+
+    for (size_t first = 0; first < chunks; first += workers) {
+        const size_t inRound = std::min<size_t>(workers, chunks - first);
+
+        // 1. Parse: worker w takes chunk first + w
+        runOnWorkers(static_cast<unsigned>(inRound), [&](unsigned w) {
+            for (auto& list : sinks[w].perWorker) list.clear();
+            parseChunk(sinks[w], m_mappedData + bounds[first + w], m_mappedData + bounds[first + w + 1]);
+        });
+
+        // 2. Deliver: worker w owns its ports and walks the chunks in file order
+        runOnWorkers(workers, [&](unsigned w) {
+            std::vector<PacketMetadata> batch(batchSize);
+            const Subscription* batchSub = nullptr;
+            int count = 0;
+            auto flush = [&]() {
+                if (count == 0) return;
+                void* ctx = contexts.empty() ? batchSub->context : contexts[w];
+                batchSub->batchHandler(ctx, count, batch.data(), nullptr, 0);
+                count = 0;
+            };
+
+            for (size_t c = 0; c < inRound; ++c) {
+                const auto& packets = sinks[c].perWorker[w];
+                for (const auto& pkt : packets) {
+                    const Subscription& sub = *pkt.sub;
+                    if (sub.handler) {
+                        flush();
+                        sub.handler(contexts.empty() ? sub.context : contexts[w],
+                                pkt.data, pkt.len, pkt.status, pkt.ts);
+                        continue;
+                    }
+                    if (&sub != batchSub) {
+                        flush();
+                        batchSub = &sub;
+                    }
+                    PacketMetadata& meta = batch[count];
+                    meta.ts = pkt.ts;
+                    meta.len = pkt.len;
+                    meta.destPort = ntohs(pkt.portNet);
+                    meta.status = pkt.status;
+                    meta.sender = nullptr;
+                    meta.data = pkt.data;
+                    meta.hwTs = {0, 0};
+                    if (++count == static_cast<int>(batchSize)) flush();
+                }
+                delivered[w] += packets.size();
+            }
+            flush();
+        });
+    }
+
+    m_currentPtr = m_windowEnd;
+    m_finished = true;
+
+    uint64_t total = 0;
+    for (uint64_t n : delivered) total += n;
+    return total;
+}
+
+namespace {
+
+// "" is the wildcard; IPv4 addresses keep their 4 bytes, IPv6 all 16
+bool parseFlowAddress(const std::string& text, detail::FlowAddress& addr) {
+    addr = {};
+    if (text.empty()) return true;
+    addr.any = false;
+    if (::inet_pton(AF_INET, text.c_str(), addr.bytes) == 1) return true;
+    addr.v6 = true;
+    return ::inet_pton(AF_INET6, text.c_str(), addr.bytes) == 1;
+}
+
+} // namespace
+
+void PcapReceiver::resetHot() noexcept {
+    // Table updates move the subscriptions the hot cache points to
+    flushBatch();
+    m_hotSub = nullptr;
+    m_hotPortWide = false;
+    m_hotHandler = nullptr;
+    m_hotBatchHandler = nullptr;
+}
+
+Result<int> PcapReceiver::addFlow(const FlowMatch& match, const Subscription& sub) {
+    detail::FlowKey key;
+    key.portNet = htons(match.port);
+    if (!parseFlowAddress(match.dstAddress, key.dst) || !parseFlowAddress(match.srcAddress, key.src)) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    resetHot();
+    if (!m_flows->insert(key, sub)) {
+        return std::error_code(EADDRINUSE, std::system_category());
+    }
+
+    // Return the port as the ID.
+    // This allows the caller to treat the port as the 'handle' for this subscription.
+    return static_cast<int>(match.port);
+}
+
 Result<int> PcapReceiver::subscribe(uint16_t port,
                                     void* context,
                                     PacketHandlerFn handler) {
@@ -170,24 +848,59 @@ Result<int> PcapReceiver::subscribe(uint16_t port,
         return baseRes;
     }
 
-    // Convert to Network Byte Order ONCE
-    uint16_t netPort = htons(port);
+    return addFlow(FlowMatch{port, {}, {}}, {context, handler, nullptr});
+}
 
-    // Perform PcapReceiver specific registration.
-    m_portTable[netPort] = {context, handler};
+Result<int> PcapReceiver::subscribeBatch(uint16_t port,
+                                         void* context,
+                                         PacketBatchHandlerFn handler) {
+    return subscribeFlowBatch(FlowMatch{port, {}, {}}, context, handler);
+}
 
-    // Return the port as the ID.
-    // This allows the caller to treat the port as the 'handle' for this subscription.
-    return static_cast<int>(port);
+Result<int> PcapReceiver::subscribeFlow(const FlowMatch& match, void* context, PacketHandlerFn handler) {
+    auto baseRes = PacketReceiver::subscribe(match.port, context, handler);
+    if (!baseRes) {
+        return baseRes;
+    }
+
+    return addFlow(match, {context, handler, nullptr});
+}
+
+Result<int> PcapReceiver::subscribeFlowBatch(const FlowMatch& match, void* context,
+        PacketBatchHandlerFn handler) {
+    checkThread();
+
+    if (handler == nullptr) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    return addFlow(match, {context, nullptr, handler});
 }
 
 Result<void> PcapReceiver::unsubscribe(uint16_t port) {
-    auto baseResult = PacketReceiver::unsubscribe(port);
-    if (!baseResult) {
-        return baseResult;
+    checkThread();
+
+    // Subscriptions own no descriptor: the flow table is the only record
+    resetHot();
+    if (m_flows->erasePort(htons(port)) == 0) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+    return Result<void>::success();
+}
+
+Result<void> PcapReceiver::unsubscribeFlow(const FlowMatch& match) {
+    checkThread();
+
+    detail::FlowKey key;
+    key.portNet = htons(match.port);
+    if (!parseFlowAddress(match.dstAddress, key.dst) || !parseFlowAddress(match.srcAddress, key.src)) {
+        return std::error_code(EINVAL, std::system_category());
     }
 
-    m_portTable[port] = {};
+    resetHot();
+    if (!m_flows->erase(key)) {
+        return std::error_code(ENOENT, std::system_category());
+    }
     return Result<void>::success();
 }
 
@@ -210,18 +923,53 @@ void PcapReceiver::start() {
 
 bool PcapReceiver::step() {
     checkThread(); // Safety check only happens here
-    return internalStep();
+    bool processed = internalStep();
+    flushBatch();
+    return processed;
 }
 
-// The core logic: Reads one packet from memory
-bool PcapReceiver::internalStep() noexcept {
-    // New Delegation
+void PcapReceiver::selectSteps() noexcept {
+    // One instantiation per byte order, resolution and (Ethernet or other)
+    // link type, so the per-packet tests fold away in the FLOOD loop
+    constexpr uint32_t ETH = DLT_EN10MB;
     if (m_isPcapNg) {
-        return stepPcapNg();
+        m_step = m_swapped ? &PcapReceiver::stepPcapNg<true> : &PcapReceiver::stepPcapNg<false>;
+        m_floodLoop = m_swapped
+            ? &PcapReceiver::floodLoop<&PcapReceiver::stepPcapNg<true>, &PcapReceiver::gatherPcapNg<true>>
+            : &PcapReceiver::floodLoop<&PcapReceiver::stepPcapNg<false>, &PcapReceiver::gatherPcapNg<false>>;
+        return;
+    }
+
+    const int variant = (m_swapped ? 4 : 0) | (m_isNanosecond ? 2 : 0) | (m_linkType == ETH ? 1 : 0);
+    switch (variant) {
+#define ATU_PCAP_STEP(n, swapped, nano, link) \
+        case n: \
+            m_step = &PcapReceiver::stepLegacy<swapped, nano, link>; \
+            m_floodLoop = &PcapReceiver::floodLoop<&PcapReceiver::stepLegacy<swapped, nano, link>, \
+                &PcapReceiver::gatherLegacy<swapped, nano, link>>; \
+            break;
+        ATU_PCAP_STEP(0, false, false, ANY_LINK_TYPE)
+        ATU_PCAP_STEP(1, false, false, ETH)
+        ATU_PCAP_STEP(2, false, true,  ANY_LINK_TYPE)
+        ATU_PCAP_STEP(3, false, true,  ETH)
+        ATU_PCAP_STEP(4, true,  false, ANY_LINK_TYPE)
+        ATU_PCAP_STEP(5, true,  false, ETH)
+        ATU_PCAP_STEP(6, true,  true,  ANY_LINK_TYPE)
+        ATU_PCAP_STEP(7, true,  true,  ETH)
+#undef ATU_PCAP_STEP
+        default: break;
     }
+}
 
+bool PcapReceiver::internalStep() noexcept {
+    return (this->*m_step)();
+}
+
+// The core logic: Reads one packet from memory
+template <bool Swapped, bool Nanosecond, uint32_t LinkType>
+bool PcapReceiver::stepLegacy() noexcept {
     // EOF Check
-    if (m_currentPtr + sizeof(pcap_sf_pkthdr) > m_mappedData + m_fileSize) [[unlikely]] {
+    if (!ensure(sizeof(pcap_sf_pkthdr))) [[unlikely]] {
         m_finished = true;
         return false;
     }
@@ -231,43 +979,48 @@ bool PcapReceiver::internalStep() noexcept {
 
     // Read and potentially swap fields
     uint32_t sec
-        = m_swapped
+        = Swapped
         ? __builtin_bswap32(disk_hdr->ts_sec)
         : disk_hdr->ts_sec;
     uint32_t fraction
-        = m_swapped
+        = Swapped
         ? __builtin_bswap32(disk_hdr->ts_usec)
         : disk_hdr->ts_usec;
     uint32_t caplen
-        = m_swapped
+        = Swapped
         ? __builtin_bswap32(disk_hdr->caplen)
         : disk_hdr->caplen;
     uint32_t len
-        = m_swapped
+        = Swapped
         ? __builtin_bswap32(disk_hdr->len)
         : disk_hdr->len;
 
+    // The whole record must be mapped, even when it straddles two windows
+    if (!ensure(sizeof(pcap_sf_pkthdr) + caplen)) [[unlikely]] {
+        m_finished = true;
+        return false;
+    }
+
     // Create a compatible in-memory header
     struct timespec ts;
     ts.tv_sec = sec;
     ts.tv_nsec = static_cast<long>(fraction);
-    if (!m_isNanosecond) {
+    if constexpr (!Nanosecond) {
         ts.tv_nsec *= 1000;
     }
 
     // TIMED Mode Check: Is it too early?
     if (m_pcapConfig.mode == ReplayMode::TIMED) {
-        auto targetTime = calculateTargetTimeHighRes(ts);
+        auto wakeTime = calculateTargetTimeHighRes(ts) - m_pcapConfig.dispatchLead;
         auto now = std::chrono::steady_clock::now();
 
-        if (targetTime > now) {
+        if (wakeTime > now) {
             // It's in the future.
             // We return FALSE so the loop stops, but we DO NOT advance m_currentPtr.
-            // We reschedule the loop to wake up at targetTime.
-            auto delay = std::chrono::duration_cast<Duration>(targetTime - now);
-            m_loop.runAfter(delay, [this]() {
+            // We reschedule the loop to wake up at wakeTime, to the nanosecond.
+            m_loop.runAt(wakeTime, [this]() {
                 this->processBatch();
-            });
+            }, m_pcapConfig.pacingSpin);
             return false;
         }
     }
@@ -277,19 +1030,21 @@ bool PcapReceiver::internalStep() noexcept {
 
     // Dispatch with precision
     // Passing caplen and len explicitly since we've already handled their endianness
-    parseAndDispatch(ts, caplen, len, packet_data, m_linkType);
+    parseAndDispatch(*this, ts, caplen, len, packet_data,
+            LinkType != ANY_LINK_TYPE ? LinkType : m_linkType);
 
     // Advance Cursor
     m_currentPtr = packet_data + caplen;
     return true;
 }
 
+template <bool Swapped>
 bool PcapReceiver::stepPcapNg() noexcept {
     uint32_t len;
 
     while (true) {
         // EOF Check
-        if (m_currentPtr + sizeof(PcapNgBlockHeader) > m_mappedData + m_fileSize) {
+        if (!ensure(sizeof(PcapNgBlockHeader))) {
             m_finished = true;
             return false;
         }
@@ -298,13 +1053,13 @@ bool PcapReceiver::stepPcapNg() noexcept {
         uint32_t type = bh->type;
         len  = bh->totalLength;
 
-        if (m_swapped) {
+        if constexpr (Swapped) {
             type = __builtin_bswap32(type);
             len  = __builtin_bswap32(len);
         }
 
         // Safety check
-        if (len < sizeof(PcapNgBlockHeader) || m_currentPtr + len > m_mappedData + m_fileSize) [[unlikely]] {
+        if (len < sizeof(PcapNgBlockHeader) || !ensure(len)) [[unlikely]] {
             m_finished = true;
             return false;
         }
@@ -315,29 +1070,7 @@ bool PcapReceiver::stepPcapNg() noexcept {
         }
 
         if (type == PCAPNG_IDB) {
-            auto* idb = reinterpret_cast<const PcapNgIDBBody*>(m_currentPtr + sizeof(PcapNgBlockHeader));
-            InterfaceInfo info;
-            info.linkType = m_swapped ? __builtin_bswap16(idb->linkType) : idb->linkType;
-            info.tsResolutionDivisor = 1000000; // Default to micro (10^6)
-
-            // Parse IDB Options for resolution (if_tsresol)
-            const uint8_t* optPtr = m_currentPtr + sizeof(PcapNgBlockHeader) + sizeof(PcapNgIDBBody);
-            const uint8_t* blockEnd = m_currentPtr + len - 4; // last 4 bytes is the length again
-
-            while (optPtr + 4 <= blockEnd) {
-                uint16_t code = *reinterpret_cast<const uint16_t*>(optPtr);
-                uint16_t vlen = *reinterpret_cast<const uint16_t*>(optPtr + 2);
-                if (m_swapped) { code = __builtin_bswap16(code); vlen = __builtin_bswap16(vlen); }
-
-                if (code == 0) break; // End of options
-                if (code == 9 && vlen == 1) { // if_tsresol
-                    uint8_t res = *(optPtr + 4);
-                    info.tsResolutionDivisor = (res & 0x80) ? (1ULL << (res & 0x7F)) : 1;
-                    if (!(res & 0x80)) for(int i=0; i<res; ++i) info.tsResolutionDivisor *= 10;
-                }
-                optPtr += 4 + ((vlen + 3) & ~3); // Padding to 32-bit
-            }
-            m_interfaces[m_interfaceCount++] = info;
+            parseInterfaceBlock(len);
         }
 
         // 2. Skip other blocks (SHB, Statistics, etc.)
@@ -347,11 +1080,11 @@ bool PcapReceiver::stepPcapNg() noexcept {
     }
 
     auto* epb = reinterpret_cast<const PcapNgEPBBody*>(m_currentPtr + sizeof(PcapNgBlockHeader));
-    uint32_t ifId = m_swapped ? __builtin_bswap32(epb->interfaceId) : epb->interfaceId;
+    uint32_t ifId = Swapped ? __builtin_bswap32(epb->interfaceId) : epb->interfaceId;
 
     auto& info = m_interfaces[ifId]; // Assuming IDB appeared before EPB
-    uint64_t high = m_swapped ? __builtin_bswap32(epb->timestampHigh) : epb->timestampHigh;
-    uint64_t low  = m_swapped ? __builtin_bswap32(epb->timestampLow)  : epb->timestampLow;
+    uint64_t high = Swapped ? __builtin_bswap32(epb->timestampHigh) : epb->timestampHigh;
+    uint64_t low  = Swapped ? __builtin_bswap32(epb->timestampLow)  : epb->timestampLow;
     uint64_t tsRaw = (high << 32) | low;
 
     // Convert to timespec (Assuming standard resolution of units per second)
@@ -364,33 +1097,63 @@ bool PcapReceiver::stepPcapNg() noexcept {
 
     // check TIMED mode
     if (m_pcapConfig.mode == ReplayMode::TIMED) {
-        auto targetTime = calculateTargetTimeHighRes(ts);
+        auto wakeTime = calculateTargetTimeHighRes(ts) - m_pcapConfig.dispatchLead;
         auto now = std::chrono::steady_clock::now();
-        if (targetTime > now) {
-            auto delay = std::chrono::duration_cast<Duration>(targetTime - now);
-            m_loop.runAfter(delay, [this]() { this->processBatch(); });
+        if (wakeTime > now) {
+            m_loop.runAt(wakeTime, [this]() { this->processBatch(); }, m_pcapConfig.pacingSpin);
             return false; // Valid wait, do not advance pointer
         }
     }
 
-    uint32_t capLen  = m_swapped ? __builtin_bswap32(epb->capLen)  : epb->capLen;
-    uint32_t origLen = m_swapped ? __builtin_bswap32(epb->origLen) : epb->origLen;
+    uint32_t capLen  = Swapped ? __builtin_bswap32(epb->capLen)  : epb->capLen;
+    uint32_t origLen = Swapped ? __builtin_bswap32(epb->origLen) : epb->origLen;
 
     // Packet data starts after the EPB body
     const uint8_t* dataPtr = m_currentPtr + sizeof(PcapNgBlockHeader) + sizeof(PcapNgEPBBody);
 
-    parseAndDispatch(ts, capLen, origLen, dataPtr, info.linkType);
+    parseAndDispatch(*this, ts, capLen, origLen, dataPtr, info.linkType);
 
     m_currentPtr += len; // Advance to next block
     return true;
 }
 
+void PcapReceiver::dispatchRecord(const Record& rec) noexcept {
+    parseAndDispatch(*this, rec.ts, rec.caplen, rec.len, rec.data, rec.linkType);
+}
+
+void PcapReceiver::parseInterfaceBlock(uint32_t len) noexcept {
+    auto* idb = reinterpret_cast<const PcapNgIDBBody*>(m_currentPtr + sizeof(PcapNgBlockHeader));
+    InterfaceInfo info;
+    info.linkType = m_swapped ? __builtin_bswap16(idb->linkType) : idb->linkType;
+    info.tsResolutionDivisor = 1000000; // Default to micro (10^6)
+
+    // Parse IDB Options for resolution (if_tsresol)
+    const uint8_t* optPtr = m_currentPtr + sizeof(PcapNgBlockHeader) + sizeof(PcapNgIDBBody);
+    const uint8_t* blockEnd = m_currentPtr + len - 4; // last 4 bytes is the length again
+
+    while (optPtr + 4 <= blockEnd) {
+        uint16_t code = *reinterpret_cast<const uint16_t*>(optPtr);
+        uint16_t vlen = *reinterpret_cast<const uint16_t*>(optPtr + 2);
+        if (m_swapped) { code = __builtin_bswap16(code); vlen = __builtin_bswap16(vlen); }
+
+        if (code == 0) break; // End of options
+        if (code == 9 && vlen == 1) { // if_tsresol
+            uint8_t res = *(optPtr + 4);
+            info.tsResolutionDivisor = (res & 0x80) ? (1ULL << (res & 0x7F)) : 1;
+            if (!(res & 0x80)) for(int i=0; i<res; ++i) info.tsResolutionDivisor *= 10;
+        }
+        optPtr += 4 + ((vlen + 3) & ~3); // Padding to 32-bit
+    }
+    m_interfaces[m_interfaceCount++] = info;
+}
+
 void PcapReceiver::processBatch() {
     if (!m_mappedData || m_finished) return;
 
     // Dispatch to optimized loop for the flood case
     if (m_pcapConfig.mode == ReplayMode::FLOOD) {
         processBatchFlood();
+        return;
     }
 
     int totalProcessed = 0;
@@ -401,61 +1164,339 @@ void PcapReceiver::processBatch() {
     while (totalProcessed < stopLimit) {
         // We prefetch ~128 bytes ahead of the current pointer.
         // This usually covers the next packet's Pcap header and Layer 2/3 headers.
-        if (m_currentPtr + 128 < m_mappedData + m_fileSize) [[likely]] {
+        if (m_currentPtr + 128 < m_windowEnd) [[likely]] {
             __builtin_prefetch(m_currentPtr + 128, 0, 3);
         }
 
         // step() returns false if EOF or if we are waiting for time
         if (!internalStep()) {
+            flushBatch();
             return;
         }
         totalProcessed++;
     }
 
+    // Hand partial batches over before yielding to the loop
+    flushBatch();
+
     if (m_finished) [[unlikely]] {
         return;
     }
 
     // Yield to event loop if we are just flooding (avoid freezing the app)
     if (m_pcapConfig.mode == ReplayMode::FLOOD) {
-        m_loop.runInLoop([this]() {
-            this->processBatch();
-        });
+        m_loop.runInLoop(&PcapReceiver::deferredBatch, this);
     }
     // Note: In TIMED mode, step() handles the rescheduling when it hits a future packet.
-    // If the batch finished but next packet is valid (catch-up scenario), schedule immediate continuation.
+    // If the batch finished but next packet is valid (catch-up scenario), continue on the
+    // next iteration rather than on the next 1ms timer tick.
     else if (m_pcapConfig.mode == ReplayMode::TIMED) {
-         m_loop.runAfter(Duration(0), [this]() {
-            this->processBatch();
-        });
+        m_loop.runInLoop(&PcapReceiver::deferredBatch, this);
     }
 }
 
+void PcapReceiver::deferredBatch(void* self) {
+    static_cast<PcapReceiver*>(self)->processBatch();
+}
+
+void PcapReceiver::deferredBatchFlood(void* self) {
+    static_cast<PcapReceiver*>(self)->processBatchFlood();
+}
+
 void PcapReceiver::processBatchFlood() {
-    constexpr int stopLimit = 20000;
-    constexpr int lookAhead = 512;
+    m_floodLoop(this);
+}
 
-    for (int i = 0; i < stopLimit; i++) {
-        // Calculate the next packet start if possible.
-        // We look "ahead" of the current packet size.
-        // Assuming a standard PCAP header (16 bytes) + typical packet
-        __builtin_prefetch(m_currentPtr + lookAhead, 0, 3);
+// This is portable AND fast because the compiler optimizes the array access
+inline bool isVlanTag(const uint8_t* etherType) {
+    // 802.1Q, 802.1ad (QinQ outer tag) and the legacy 0x9100 outer tag
+    return (etherType[0] == 0x81 && etherType[1] == 0x00)
+        || (etherType[0] == 0x88 && etherType[1] == 0xa8)
+        || (etherType[0] == 0x91 && etherType[1] == 0x00);
+}
 
-        // internalStep() returns false if EOF or if we are waiting for time
-        if (!internalStep()) [[unlikely]] {
-            return;
+namespace {
+
+// How far ahead the record walk prefetches, in records: far enough for memory
+// latency, close enough to stay in L1 with its block
+constexpr size_t FLOOD_PREFETCH_RECORDS = 32;
+
+// Read in place of the bytes the fast path must not touch
+constexpr uint8_t NO_FRAME[64] = {};
+
+} // namespace
+
+// Records of one block FLOOD round, stored column by column so that the
+// classification compares contiguous lanes
+struct PcapReceiver::FloodBlock {
+    static constexpr int SIZE = 64;
+
+    struct timespec ts[SIZE];
+    const uint8_t* record[SIZE];    // Record start, decoded again for the slow path
+    const uint8_t* ip[SIZE];
+    uint16_t ipHeaderLen[SIZE];
+    uint16_t payloadLen[SIZE];
+    uint16_t dstPortNet[SIZE];
+    uint16_t etherType[SIZE];       // 0 when the frame does not hold a whole UDP datagram
+    uint16_t verProto[SIZE];        // IP version << 12 | IPv4 protocol or IPv6 next header
+    uint16_t keep[SIZE];            // 0xFFFF for UDP over IPv4 or IPv6 to a subscribed port
+    uint8_t slow[SIZE];             // Not an untruncated Ethernet frame: parsed the long way
+    const uint8_t* end;             // Record following the block
+
+    // The checks of parseAndDispatch() and dispatchIp() up to the flow lookup,
+    // without branching on the packet: what the record says goes in lane n
+    inline void add(int n, const uint8_t* rec, const uint8_t* frame, uint32_t caplen, uint32_t len,
+            uint32_t linkType) noexcept {
+        const bool fast = linkType == DLT_EN10MB && caplen >= len && caplen >= 42;
+        frame = fast ? frame : NO_FRAME;
+
+        // Up to two VLAN tags (single or QinQ)
+        const uint32_t outer = isVlanTag(frame + 12);
+        const uint32_t inner = outer & isVlanTag(frame + 16);
+        const uint32_t l2Len = 14 + 4 * (outer + inner);
+        const uint8_t* l3 = frame + l2Len;
+        const auto type = static_cast<uint16_t>((l3[-2] << 8) | l3[-1]);
+
+        const bool v6 = type == ETHERTYPE_IPV6;
+        const uint32_t headerLen = v6 ? 40 : static_cast<uint32_t>(l3[0] & 0x0F) << 2;
+        const uint32_t remaining = fast ? caplen - l2Len : 0;
+        const bool headerFits = headerLen >= 20 && remaining >= headerLen + 8;
+
+        const uint8_t* udp = headerFits ? l3 + headerLen : NO_FRAME;
+        uint16_t portNet, udpLenNet;
+        std::memcpy(&portNet, udp + 2, sizeof(portNet));
+        std::memcpy(&udpLenNet, udp + 4, sizeof(udpLenNet));
+        const uint16_t udpLen = ntohs(udpLenNet);
+        const bool whole = headerFits && udpLen >= 8 && remaining >= headerLen + udpLen;
+
+        record[n] = rec;
+        ip[n] = l3;
+        ipHeaderLen[n] = static_cast<uint16_t>(headerLen);
+        payloadLen[n] = static_cast<uint16_t>(udpLen - 8u);
+        dstPortNet[n] = portNet;
+        etherType[n] = whole ? type : 0;
+        verProto[n] = static_cast<uint16_t>(((l3[0] & 0xF0) << 8) | (v6 ? l3[6] : l3[9]));
+        slow[n] = !fast;
+    }
+};
+
+namespace {
+
+// keep[i] = 0xFFFF where (etherType[i], verProto[i]) is UDP over IPv4 or IPv6
+// and ports (one bit per port) holds dstPortNet[i]
+inline void classifyUdp(const uint16_t* etherType, const uint16_t* verProto,
+        const uint16_t* dstPortNet, const uint64_t* ports, uint16_t* keep, int lanes) noexcept {
+    constexpr uint16_t UDP4 = 0x4000 | IPPROTO_UDP;
+    constexpr uint16_t UDP6 = 0x6000 | IPPROTO_UDP;
+#if defined(__AVX2__)
+    const __m256i ip4 = _mm256_set1_epi16(ETHERTYPE_IP);
+    const __m256i ip6 = _mm256_set1_epi16(static_cast<short>(ETHERTYPE_IPV6));
+    const __m256i udp4 = _mm256_set1_epi16(UDP4);
+    const __m256i udp6 = _mm256_set1_epi16(UDP6);
+    const __m256i bitIndex = _mm256_set1_epi32(31);
+    const __m256i one = _mm256_set1_epi32(1);
+    // Little endian: bit p of the 64-bit words is bit (p & 31) of 32-bit word p >> 5
+    const auto* words = reinterpret_cast<const int*>(ports);
+
+    auto portHits = [&](__m128i port) {
+        const __m256i p = _mm256_cvtepu16_epi32(port);
+        const __m256i word = _mm256_i32gather_epi32(words, _mm256_srli_epi32(p, 5), 4);
+        const __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(p, bitIndex)), one);
+        return _mm256_cmpeq_epi32(bit, one);
+    };
+
+    for (int i = 0; i < lanes; i += 16) {
+        const __m256i type = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(etherType + i));
+        const __m256i vp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(verProto + i));
+        const __m256i v4 = _mm256_and_si256(_mm256_cmpeq_epi16(type, ip4), _mm256_cmpeq_epi16(vp, udp4));
+        const __m256i v6 = _mm256_and_si256(_mm256_cmpeq_epi16(type, ip6), _mm256_cmpeq_epi16(vp, udp6));
+
+        // 32-bit hits of lanes 0-7 and 8-15, packed back to 16 bits in lane order
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dstPortNet + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dstPortNet + i + 8));
+        const __m256i hits = _mm256_permute4x64_epi64(_mm256_packs_epi32(portHits(lo), portHits(hi)), 0xD8);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(keep + i),
+                _mm256_and_si256(_mm256_or_si256(v4, v6), hits));
+    }
+#elif defined(__ARM_NEON)
+    const uint16x8_t ip4 = vdupq_n_u16(ETHERTYPE_IP);
+    const uint16x8_t ip6 = vdupq_n_u16(ETHERTYPE_IPV6);
+    const uint16x8_t udp4 = vdupq_n_u16(UDP4);
+    const uint16x8_t udp6 = vdupq_n_u16(UDP6);
+    for (int i = 0; i < lanes; i += 8) {
+        const uint16x8_t type = vld1q_u16(etherType + i);
+        const uint16x8_t vp = vld1q_u16(verProto + i);
+        const uint16x8_t v4 = vandq_u16(vceqq_u16(type, ip4), vceqq_u16(vp, udp4));
+        const uint16x8_t v6 = vandq_u16(vceqq_u16(type, ip6), vceqq_u16(vp, udp6));
+        vst1q_u16(keep + i, vorrq_u16(v4, v6));
+    }
+    // No gather: the table is tested lane by lane
+    for (int i = 0; i < lanes; ++i) {
+        const uint16_t p = dstPortNet[i];
+        keep[i] &= static_cast<uint16_t>(0 - ((ports[p >> 6] >> (p & 63)) & 1));
+    }
+#else
+    for (int i = 0; i < lanes; ++i) {
+        const uint16_t p = dstPortNet[i];
+        const bool udp = (etherType[i] == ETHERTYPE_IP && verProto[i] == UDP4)
+            || (etherType[i] == ETHERTYPE_IPV6 && verProto[i] == UDP6);
+        keep[i] = (udp && ((ports[p >> 6] >> (p & 63)) & 1)) ? 0xFFFF : 0;
+    }
+#endif
+}
+
+} // namespace
+
+// Phase one, legacy format: stops at the first record not wholly mapped,
+// which the scalar step reads after sliding the window
+template <bool Swapped, bool Nanosecond, uint32_t LinkType>
+int PcapReceiver::gatherLegacy(FloodBlock& block) noexcept {
+    const uint32_t linkType = LinkType != ANY_LINK_TYPE ? LinkType : m_linkType;
+    const uint8_t* p = m_currentPtr;
+    int n = 0;
+
+    while (n < FloodBlock::SIZE && static_cast<size_t>(m_windowEnd - p) >= sizeof(pcap_sf_pkthdr)) {
+        auto* hdr = reinterpret_cast<const pcap_sf_pkthdr*>(p);
+        const uint32_t caplen = Swapped ? __builtin_bswap32(hdr->caplen) : hdr->caplen;
+        const size_t size = sizeof(pcap_sf_pkthdr) + caplen;
+        if (size > static_cast<size_t>(m_windowEnd - p)) [[unlikely]] break;
+
+        // The walk is a chain of dependent loads: fetch the record header and
+        // frame headers some records ahead, at the distance the current record
+        // size predicts (a fixed byte distance is too short for small packets)
+        const uint8_t* ahead = p + FLOOD_PREFETCH_RECORDS * size;
+        __builtin_prefetch(ahead, 0, 3);
+        __builtin_prefetch(ahead + 64, 0, 3);
+
+        const uint32_t fraction = Swapped ? __builtin_bswap32(hdr->ts_usec) : hdr->ts_usec;
+        block.ts[n].tv_sec = Swapped ? __builtin_bswap32(hdr->ts_sec) : hdr->ts_sec;
+        block.ts[n].tv_nsec = static_cast<long>(fraction) * (Nanosecond ? 1 : 1000);
+        block.add(n, p, p + sizeof(pcap_sf_pkthdr), caplen,
+                Swapped ? __builtin_bswap32(hdr->len) : hdr->len, linkType);
+        p += size;
+        ++n;
+    }
+    block.end = p;
+    return n;
+}
+
+// Phase one, pcapng: other blocks, interface blocks included, are left to the scalar step
+template <bool Swapped>
+int PcapReceiver::gatherPcapNg(FloodBlock& block) noexcept {
+    constexpr size_t headerLen = sizeof(PcapNgBlockHeader) + sizeof(PcapNgEPBBody);
+    const uint8_t* p = m_currentPtr;
+    uint32_t lastId = UINT32_MAX;
+    const InterfaceInfo* info = nullptr;
+    int n = 0;
+
+    while (n < FloodBlock::SIZE && static_cast<size_t>(m_windowEnd - p) >= headerLen) {
+        auto* bh = reinterpret_cast<const PcapNgBlockHeader*>(p);
+        const uint32_t type = Swapped ? __builtin_bswap32(bh->type) : bh->type;
+        const uint32_t len  = Swapped ? __builtin_bswap32(bh->totalLength) : bh->totalLength;
+        if (type != PCAPNG_EPB || len > static_cast<size_t>(m_windowEnd - p)) [[unlikely]] break;
+
+        auto* epb = reinterpret_cast<const PcapNgEPBBody*>(p + sizeof(PcapNgBlockHeader));
+        const uint32_t capLen = Swapped ? __builtin_bswap32(epb->capLen) : epb->capLen;
+        if (len < headerLen || capLen > len - headerLen) [[unlikely]] break;
+
+        const uint32_t ifId = Swapped ? __builtin_bswap32(epb->interfaceId) : epb->interfaceId;
+        if (ifId != lastId) {
+            auto it = m_interfaces.find(ifId);
+            if (it == m_interfaces.end()) [[unlikely]] break;
+            info = &it->second;
+            lastId = ifId;
         }
+
+        const uint8_t* ahead = p + FLOOD_PREFETCH_RECORDS * len;
+        __builtin_prefetch(ahead, 0, 3);
+        __builtin_prefetch(ahead + 64, 0, 3);
+
+        // Microseconds, the default resolution, divide by a constant
+        const uint64_t high = Swapped ? __builtin_bswap32(epb->timestampHigh) : epb->timestampHigh;
+        const uint64_t low  = Swapped ? __builtin_bswap32(epb->timestampLow)  : epb->timestampLow;
+        const uint64_t tsRaw = (high << 32) | low;
+        const uint64_t divisor = info->tsResolutionDivisor;
+        const uint64_t sec = divisor == 1000000 ? tsRaw / 1000000 : tsRaw / divisor;
+        const uint64_t fraction = tsRaw - sec * divisor;
+        block.ts[n].tv_sec  = static_cast<time_t>(sec);
+        block.ts[n].tv_nsec = static_cast<long>(divisor == 1000000
+                ? fraction * 1000 : fraction * 1000000000ULL / divisor);
+        block.add(n, p, p + headerLen, capLen,
+                Swapped ? __builtin_bswap32(epb->origLen) : epb->origLen, info->linkType);
+        p += len;
+        ++n;
     }
-    if (m_finished) [[unlikely]] {
-        return;
+    block.end = p;
+    return n;
+}
+
+// Phase two: lanes past count match nothing, so the kernel runs whole vectors.
+// A port subscribed by a handler of this block is seen from the next one.
+void PcapReceiver::classifyBlock(FloodBlock& block, int count) const noexcept {
+    for (int i = count; i < FloodBlock::SIZE; ++i) {
+        block.etherType[i] = 0;
+        block.dstPortNet[i] = 0;
+        block.verProto[i] = 0;
     }
+    classifyUdp(block.etherType, block.verProto, block.dstPortNet, m_flows->portBitmap(),
+            block.keep, FloodBlock::SIZE);
+}
 
-    m_loop.runInLoop([this]() {
-        this->processBatchFlood();
-    });
+// Phase three: survivors go through the hot cache to the batch handler
+void PcapReceiver::dispatchBlock(const FloodBlock& block, int count) noexcept {
+    const uint8_t* const cursor = m_currentPtr;
+    for (int i = 0; i < count; ++i) {
+        if (block.keep[i]) [[likely]] {
+            const uint16_t dstPortNet = block.dstPortNet[i];
+            const uint8_t* ip = block.ip[i];
+            if (lookupFlow(dstPortNet, ip, block.etherType[i] == ETHERTYPE_IPV6)) {
+                deliver(dstPortNet, ip + block.ipHeaderLen[i] + 8, block.payloadLen[i],
+                        PacketStatus::OK, block.ts[i]);
+            }
+        } else if (block.slow[i]) [[unlikely]] {
+            Record rec;
+            if (decodeAt(block.record[i], rec)) {
+                dispatchRecord(rec);
+            }
+        }
+
+        // A handler moved the replay (seek, rewind): the rest of the block is stale
+        if (m_currentPtr != cursor) [[unlikely]] return;
+    }
+    m_currentPtr = block.end;
 }
 
+template <PcapReceiver::StepFn Step, PcapReceiver::GatherFn Gather>
+void PcapReceiver::floodLoop(PcapReceiver* self) {
+    constexpr int stopLimit = 20000;
+    FloodBlock block;
+
+    for (int done = 0; done < stopLimit; ) {
+        const int count = (self->*Gather)(block);
+        if (count == 0) [[unlikely]] {
+            // Window edge, non-packet pcapng block or end of file: one record the scalar way.
+            // The step is a template argument: inlined, with its format tests folded
+            if (!(self->*Step)()) {
+                self->flushBatch();
+                return;
+            }
+            ++done;
+            continue;
+        }
 
+        self->classifyBlock(block, count);
+        self->dispatchBlock(block, count);
+        done += count;
+    }
+
+    self->flushBatch();
+    if (self->m_finished) [[unlikely]] {
+        return;
+    }
+
+    self->m_loop.runInLoop(&PcapReceiver::deferredBatchFlood, self);
+}
 
 std::chrono::steady_clock::time_point PcapReceiver::calculateTargetTimeHighRes(
         const struct timespec& ts)
@@ -466,7 +1507,10 @@ std::chrono::steady_clock::time_point PcapReceiver::calculateTargetTimeHighRes(
         m_firstPacket = false;
         return m_wallStartTs;
     }
+    return playTime(ts);
+}
 
+std::chrono::steady_clock::time_point PcapReceiver::playTime(const struct timespec& ts) const {
     long diff_sec = ts.tv_sec  - m_pcapStartTs.tv_sec;
     long diff_ns  = ts.tv_nsec - m_pcapStartTs.tv_nsec;
 
@@ -486,13 +1530,66 @@ std::chrono::steady_clock::time_point PcapReceiver::calculateTargetTimeHighRes(
     return m_wallStartTs + std::chrono::seconds(diff_sec) + std::chrono::nanoseconds(diff_ns);
 }
 
-// This is portable AND fast because the compiler optimizes the array access
-inline bool isFastPathIPv4(const uint8_t* p) {
-    // p+12 is EtherType, p+14 is IP Version
-    return p[12] == 0x08 && p[13] == 0x00 && (p[14] & 0xF0) == 0x40;
+bool PcapReceiver::lookupFlow(uint16_t dstPortNet, const uint8_t* ip, bool v6) noexcept {
+    if (dstPortNet == m_hotPort && m_hotPortWide) [[likely]] {
+        return true;
+    }
+
+    // Cache Miss, First Packet or an address-restricted port: ask the flow table
+    bool portWide = false;
+    const Subscription* sub = m_flows->find(dstPortNet, ip, v6, portWide);
+    if (!sub) {
+        return false;
+    }
+
+    if (sub != m_hotSub) {
+        // The pending batch belongs to the previous hot flow
+        flushBatch();
+        m_hotSub          = sub;
+        m_hotHandler      = sub->handler;
+        m_hotBatchHandler = sub->batchHandler;
+        m_hotContext      = sub->context;
+    }
+
+    // Update the hot cache for subsequent packets
+    m_hotPort     = dstPortNet;
+    m_hotPortWide = portWide;
+    return true;
+}
+
+void PcapReceiver::deliver(uint16_t dstPortNet, const uint8_t* payload, size_t len,
+        uint32_t status, const struct timespec& ts) noexcept {
+    if (!m_hotBatchHandler) {
+        m_hotHandler(m_hotContext, payload, len, status, ts);
+        return;
+    }
+
+    PacketMetadata& meta = m_batch[m_batchCount];
+    meta.ts = ts;
+    meta.len = len;
+    meta.destPort = ntohs(dstPortNet);
+    meta.status = status;
+    meta.sender = nullptr;
+    meta.data = payload;
+    meta.hwTs = {0, 0};
+
+    if (++m_batchCount == static_cast<int>(m_batch.size())) [[unlikely]] {
+        flushBatch();
+    }
+}
+
+void PcapReceiver::flushBatch() noexcept {
+    if (m_batchCount == 0) return;
+
+    // Reset first: the handler may re-enter (e.g. unsubscribe)
+    const int count = m_batchCount;
+    m_batchCount = 0;
+    m_hotBatchHandler(m_hotContext, count, m_batch.data(), nullptr, 0);
 }
 
+template <typename Sink>
 void PcapReceiver::parseAndDispatch(
+        Sink& sink,
         const struct timespec& ts,
         uint32_t caplen,
         uint32_t len,
@@ -502,68 +1599,78 @@ void PcapReceiver::parseAndDispatch(
     // Determine status: If captured length < original length, it's truncated
     PacketStatus status = (caplen < len) ? PacketStatus::TRUNCATED : PacketStatus::OK;
 
-    // Validate Link Type (Done once during init, but used here)
-    // If m_linkType != 1 (Mapping to DLT_EN10MB), we MUST use slow path.
-    if (m_linkType == DLT_EN10MB && status == PacketStatus::OK && caplen >= 42) [[likely]] {
-        // The FAST PATH
-        if (isFastPathIPv4(packet) && packet[23] == IPPROTO_UDP) [[likely]] {
-            // NOW we need IHL to find the start of the UDP header
-            // We only do this math because we KNOW we want this packet.
-            uint8_t ihl = packet[14] & 0x0F;
-            uint32_t ipHeaderLen = ihl << 2;
-            uint32_t totalHeaderLen = 14 + ipHeaderLen + 8; // Eth + IP + UDP
-
-            if (caplen < totalHeaderLen) [[unlikely]] {
-                // Cannot read the udp header
-                return;
+    // Validate Link Type (per file, or per pcapng interface)
+    // If it is not DLT_EN10MB, we MUST use slow path.
+    if (linkType == DLT_EN10MB && status == PacketStatus::OK && caplen >= 42) [[likely]] {
+        // The FAST PATH: the EtherType follows up to two VLAN tags (single or QinQ)
+        uint32_t typeOffset = 12;
+        if (isVlanTag(packet + typeOffset)) [[unlikely]] {
+            typeOffset += 4;
+            if (isVlanTag(packet + typeOffset)) {
+                typeOffset += 4;
             }
+        }
 
-            // Map the UDP header relative to the actual end of the IP header
-            auto* udp = reinterpret_cast<const struct udphdr*>(packet + 14 + ipHeaderLen);
-
-            // Optimized Network-Order Port Table lookup
-            uint16_t dstPortNet = udp->uh_dport;
+        const uint16_t etherType = static_cast<uint16_t>((packet[typeOffset] << 8) | packet[typeOffset + 1]);
+        const uint32_t l2Len = typeOffset + 2;
+        dispatchIp(sink, ts, packet + l2Len, caplen - l2Len, etherType, status);
+        return;
+    }
 
-            // CHECK PORT FIRST
-            if (dstPortNet != m_hotPort || m_hotHandler == nullptr) [[unlikely]] {
-                // Cache Miss or First Packet: Look up the port in our table
-                auto& sub = m_portTable[dstPortNet];
+    // Fallback for SLL, or truncated packets
+    slowPathParse(sink, ts, caplen, len, packet, linkType);
+}
 
-                if (!sub.handler) {
-                    return; // No subscription for this port
-                }
+template <typename Sink>
+void PcapReceiver::dispatchIp(Sink& sink, const struct timespec& ts, const uint8_t* ip,
+        uint32_t remaining, uint16_t etherType, uint32_t status) {
+    uint32_t ipHeaderLen;
+    bool v6;
+    if (etherType == ETHERTYPE_IP && remaining >= 20 && (ip[0] & 0xF0) == 0x40) [[likely]] {
+        if (ip[9] != IPPROTO_UDP) return;
+        // We only do this math because we KNOW we want this packet.
+        ipHeaderLen = static_cast<uint32_t>(ip[0] & 0x0F) << 2;
+        v6 = false;
+    } else if (etherType == ETHERTYPE_IPV6 && remaining >= 40 && (ip[0] & 0xF0) == 0x60) {
+        // Extension headers are not walked: UDP must be the next header
+        if (ip[6] != IPPROTO_UDP) return;
+        ipHeaderLen = 40;
+        v6 = true;
+    } else {
+        return;
+    }
 
-                // Update the hot cache for subsequent packets
-                m_hotPort    = dstPortNet;
-                m_hotHandler = sub.handler;
-                m_hotContext = sub.context;
-            }
+    if (ipHeaderLen < 20 || remaining < ipHeaderLen + 8) [[unlikely]] {
+        // Cannot read the udp header
+        return;
+    }
 
-            // ONLY COMPUTE LENGTHS IF WE HAVE A HANDLER
-            uint16_t udpLen = ntohs(udp->uh_ulen);
-            if (udpLen < 8) [[unlikely]] {
-                // udpLen should be at least its header
-                return;
-            }
+    // Map the UDP header relative to the actual end of the IP header
+    auto* udp = reinterpret_cast<const struct udphdr*>(ip + ipHeaderLen);
+    uint16_t dstPortNet = udp->uh_dport;
 
-            // This protects against packets where the UDP header is bigger than PCAP.
-            if (caplen < (14 + ipHeaderLen + udpLen)) [[unlikely]] {
-                return; // Not enough data
-            }
+    // CHECK THE FLOW FIRST
+    if (!sink.lookupFlow(dstPortNet, ip, v6)) {
+        return; // No subscription for this port and address
+    }
 
-            const uint8_t* payload = packet + totalHeaderLen;
-            int32_t payloadLen = udpLen - 8;
+    // ONLY COMPUTE LENGTHS IF WE HAVE A HANDLER
+    uint16_t udpLen = ntohs(udp->uh_ulen);
+    if (udpLen < 8) [[unlikely]] {
+        // udpLen should be at least its header
+        return;
+    }
 
-            m_hotHandler(m_hotContext, payload, payloadLen, status, ts);
-            return; // Fast path successful
-        }
+    // This protects against packets where the UDP header is bigger than PCAP.
+    if (remaining < ipHeaderLen + udpLen) [[unlikely]] {
+        return; // Not enough data
     }
 
-    // Fallback for VLANs, SLL, or truncated packets
-    slowPathParse(ts, caplen, len, packet, linkType);
+    sink.deliver(dstPortNet, ip + ipHeaderLen + 8, udpLen - 8u, status, ts);
 }
 
-void PcapReceiver::slowPathParse(const struct timespec& ts, uint32_t caplen, uint32_t len,
+template <typename Sink>
+void PcapReceiver::slowPathParse(Sink& sink, const struct timespec& ts, uint32_t caplen, uint32_t len,
         const uint8_t* packet, uint32_t linkType) {
     if (caplen != len) [[unlikely]] return; // Ignore truncated in capture
 
@@ -587,10 +1694,9 @@ void PcapReceiver::slowPathParse(const struct timespec& ts, uint32_t caplen, uin
         ptr += sizeof(struct ether_header);
         remaining -= static_cast<uint32_t>(sizeof(struct ether_header));
 
-        // Handle 802.1Q VLAN Tagging
-        if (proto == ETHERTYPE_VLAN) {
+        // Handle 802.1Q / QinQ VLAN Tagging, up to two tags
+        for (int tags = 0; tags < 2 && (proto == ETHERTYPE_VLAN || proto == ETHERTYPE_QINQ || proto == 0x9100); ++tags) {
             if (remaining < 4) [[unlikely]] return; // VLAN tag size
-                                                    // Skip VLAN (simplified, assuming single tag)
             proto = ntohs(*reinterpret_cast<const uint16_t*>(ptr + 2));
             ptr += 4;
             remaining -= 4;
@@ -601,54 +1707,8 @@ void PcapReceiver::slowPathParse(const struct timespec& ts, uint32_t caplen, uin
         return;
     }
 
-    if (proto != ETHERTYPE_IP) return;
-
-    // --- Layer 3: IPv4 ---
-    if (remaining < sizeof(struct ip)) [[unlikely]] return;
-    auto* ip = reinterpret_cast<const struct ip*>(ptr);
-    if (ip->ip_v != 4) return;
-
-    uint32_t ipLen = ip->ip_hl * 4;
-    if (remaining < ipLen) [[unlikely]] return;
-
-    if (ip->ip_p != IPPROTO_UDP) return;
-
-    ptr += ipLen;
-    remaining -= ipLen;
-
-    // --- Layer 4: UDP ---
-    if (remaining < sizeof(struct udphdr)) [[unlikely]] return;
-    auto* udp = reinterpret_cast<const struct udphdr*>(ptr);
-
-    uint16_t dstPortNet = udp->uh_dport;
-
-    // CHECK PORT FIRST
-    if (dstPortNet != m_hotPort || m_hotHandler == nullptr) [[unlikely]] {
-        // Cache Miss or First Packet: Look up the port in our table
-        auto& sub = m_portTable[dstPortNet];
-
-        if (!sub.handler) {
-            return; // No subscription for this port
-        }
-
-        // Update the hot cache for subsequent packets
-        m_hotPort    = dstPortNet;
-        m_hotHandler = sub.handler;
-        m_hotContext = sub.context;
-    }
-
-    // --- Dispatch ---
-    uint16_t udpLen = ntohs(udp->uh_ulen); // Includes header
-    if (udpLen < sizeof(struct udphdr)) [[unlikely]] return;
-
-    size_t dataLen = udpLen - sizeof(struct udphdr);
-
-    ptr += sizeof(struct udphdr);
-    remaining -= static_cast<uint32_t>(sizeof(struct udphdr));
-
-    if (remaining < dataLen) [[unlikely]] return;
-
-    m_hotHandler(m_hotContext, ptr, dataLen, PacketStatus::OK, ts);
+    // --- Layer 3 and 4: IPv4 or IPv6, then UDP ---
+    dispatchIp(sink, ts, ptr, remaining, proto, PacketStatus::OK);
 }
 
 } // namespace atu_reactor
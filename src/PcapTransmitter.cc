@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/PcapTransmitter.h>
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+namespace atu_reactor {
+
+namespace {
+
+inline int64_t clockNs(clockid_t clock) noexcept {
+    struct timespec ts;
+    ::clock_gettime(clock, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+} // namespace
+
+PcapTransmitter::PcapTransmitter(EventLoop& loop, PcapReceiver& reader, SenderConfig config)
+        : m_reader(reader), m_config(config), m_sender(loop, config)
+{
+}
+
+PcapTransmitter::~PcapTransmitter() {
+    for (const auto& [port, route] : m_routes) {
+        (void)m_reader.unsubscribe(port);
+    }
+}
+
+Result<void> PcapTransmitter::route(uint16_t capturePort, const struct sockaddr* dest, socklen_t destLen) {
+    if (destLen > sizeof(struct sockaddr_storage)) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    auto entry = std::make_unique<Route>();
+    entry->owner = this;
+    std::memcpy(&entry->dest, dest, destLen);
+    entry->destLen = destLen;
+
+    auto res = m_reader.subscribeBatch(capturePort, entry.get(), &PcapTransmitter::onBatch);
+    if (!res) {
+        return res.error();
+    }
+    m_routes[capturePort] = std::move(entry);
+    return Result<void>::success();
+}
+
+Result<void> PcapTransmitter::unroute(uint16_t capturePort) {
+    auto it = m_routes.find(capturePort);
+    if (it == m_routes.end()) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+    auto res = m_reader.unsubscribe(capturePort);
+    m_routes.erase(it);
+    return res;
+}
+
+void PcapTransmitter::onBatch(void* context, int n, const PacketMetadata* meta, const uint8_t*, size_t) {
+    const auto* route = static_cast<const Route*>(context);
+    route->owner->send(*route, n, meta);
+}
+
+void PcapTransmitter::send(const Route& route, int n, const PacketMetadata* meta) {
+    const auto* dest = reinterpret_cast<const struct sockaddr*>(&route.dest);
+    const bool timed = m_reader.mode() == ReplayMode::TIMED;
+    const auto now = std::chrono::steady_clock::now();
+
+    // Launch times are on txClock; steady_clock is CLOCK_MONOTONIC
+    int64_t clockOffset = 0;
+    const bool txTime = timed && m_sender.txTimeEnabled();
+    if (txTime && m_config.txClock != CLOCK_MONOTONIC) {
+        clockOffset = clockNs(m_config.txClock) - clockNs(CLOCK_MONOTONIC);
+    }
+
+    std::chrono::steady_clock::time_point target = now;
+    for (int i = 0; i < n; ++i) {
+        uint64_t launch = 0;
+        if (timed) {
+            target = m_reader.playTime(meta[i].ts);
+            const auto late = std::chrono::duration_cast<std::chrono::nanoseconds>(now - target).count();
+            m_stats.lateness.record(late > 0 ? static_cast<uint64_t>(late) : 0);
+
+            if (txTime && target > now) {
+                launch = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        target.time_since_epoch()).count() + clockOffset);
+            }
+        }
+
+        auto res = m_sender.send(dest, route.destLen, meta[i].data, meta[i].len, launch);
+        if (!res && res.error().value() == ENOBUFS) [[unlikely]] {
+            // FLOOD outruns the per-iteration flush: drain now and retry once
+            (void)m_sender.flush();
+            res = m_sender.send(dest, route.destLen, meta[i].data, meta[i].len, launch);
+        }
+        if (!res) [[unlikely]] {
+            m_stats.dropped++;
+            continue;
+        }
+        m_stats.packets++;
+        m_stats.bytes += meta[i].len;
+    }
+
+    if (!m_started) [[unlikely]] {
+        m_started = true;
+        m_firstTarget = timed ? m_reader.playTime(meta[0].ts) : now;
+        m_firstSent = now;
+    }
+    if (timed) {
+        m_stats.targetSpanNs.set(static_cast<uint64_t>(std::max<int64_t>(0,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(target - m_firstTarget).count())));
+    }
+    m_stats.achievedSpanNs.set(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_firstSent).count()));
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
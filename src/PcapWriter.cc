@@ -0,0 +1,459 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/PcapWriter.h>
+
+// System headers
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Library headers
+#include <atu_reactor/UDPReceiver.h>
+
+#include "HugePages.h"
+
+namespace atu_reactor {
+
+namespace {
+
+constexpr uint32_t PCAPNG_SHB = 0x0A0D0D0A;
+constexpr uint32_t PCAPNG_IDB = 0x00000001;
+constexpr uint32_t PCAPNG_EPB = 0x00000006;
+constexpr uint16_t LINKTYPE_ETHERNET = 1;
+
+constexpr size_t ETH_HEADER = 14;
+constexpr size_t IPV4_HEADER = 20;
+constexpr size_t IPV6_HEADER = 40;
+constexpr size_t UDP_HEADER = 8;
+constexpr size_t EPB_OVERHEAD = 32;         // Block header, EPB body, trailing length
+constexpr size_t OUT_FLUSH = 1024 * 1024;   // Writer thread output buffer
+
+// Record layout in a staging half; the payload follows, padded to 8 bytes
+struct StagedPacket {
+    int64_t tsNs;
+    uint32_t len;
+    uint16_t destPort;
+    uint16_t srcPort;       // Network order
+    uint8_t family;         // AF_INET, AF_INET6 or 0 (unknown sender)
+    uint8_t reserved[7];
+    uint8_t srcAddr[16];
+};
+static_assert(sizeof(StagedPacket) % 8 == 0);
+
+inline size_t align8(size_t n) noexcept { return (n + 7) & ~size_t(7); }
+inline size_t align4(size_t n) noexcept { return (n + 3) & ~size_t(3); }
+
+inline int64_t toNs(const struct timespec& ts) noexcept {
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+template <typename T>
+inline void put(std::vector<uint8_t>& out, T value) {
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+inline void putBytes(std::vector<uint8_t>& out, const void* data, size_t len) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), p, p + len);
+}
+
+inline void pad4(std::vector<uint8_t>& out) {
+    out.resize(align4(out.size()), 0);
+}
+
+uint16_t ipv4Checksum(const uint8_t* hdr) noexcept {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < IPV4_HEADER; i += 2) {
+        sum += static_cast<uint32_t>(hdr[i] << 8 | hdr[i + 1]);
+    }
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return htons(static_cast<uint16_t>(~sum));
+}
+
+void copySender(StagedPacket& rec, const struct sockaddr_storage* sender) noexcept {
+    rec.family = 0;
+    rec.srcPort = 0;
+    std::memset(rec.srcAddr, 0, sizeof(rec.srcAddr));
+    if (!sender) return;
+
+    if (sender->ss_family == AF_INET) {
+        auto* sin = reinterpret_cast<const struct sockaddr_in*>(sender);
+        rec.family = AF_INET;
+        rec.srcPort = sin->sin_port;
+        std::memcpy(rec.srcAddr, &sin->sin_addr, 4);
+    }
+    else if (sender->ss_family == AF_INET6) {
+        auto* sin6 = reinterpret_cast<const struct sockaddr_in6*>(sender);
+        rec.srcPort = sin6->sin6_port;
+        // Dual-stack sockets report IPv4 senders as ::ffff:a.b.c.d
+        if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
+            rec.family = AF_INET;
+            std::memcpy(rec.srcAddr, sin6->sin6_addr.s6_addr + 12, 4);
+        } else {
+            rec.family = AF_INET6;
+            std::memcpy(rec.srcAddr, &sin6->sin6_addr, 16);
+        }
+    }
+}
+
+} // namespace
+
+PcapWriter::PcapWriter(EventLoop& loop, const std::string& path, WriterConfig config)
+        : m_loop(loop),
+          m_config(config),
+          m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)),
+          m_wakeFd(::eventfd(0, EFD_CLOEXEC))
+{
+    if (m_fd < 0) throw std::runtime_error("Failed to create " + path);
+    if (m_wakeFd < 0) throw std::runtime_error("Failed to create eventfd");
+    if (m_config.stagingBytes < sizeof(StagedPacket)) {
+        throw std::invalid_argument("PcapWriter stagingBytes too small");
+    }
+    m_config.stagingBytes = align8(m_config.stagingBytes);
+
+    // Section header, then one nanosecond Ethernet interface
+    std::vector<uint8_t> head;
+    put<uint32_t>(head, PCAPNG_SHB);
+    put<uint32_t>(head, 28);
+    put<uint32_t>(head, 0x1A2B3C4D);    // Byte-order magic
+    put<uint16_t>(head, 1);
+    put<uint16_t>(head, 0);
+    put<int64_t>(head, -1);             // Section length not specified
+    put<uint32_t>(head, 28);
+
+    put<uint32_t>(head, PCAPNG_IDB);
+    put<uint32_t>(head, 32);
+    put<uint16_t>(head, LINKTYPE_ETHERNET);
+    put<uint16_t>(head, 0);
+    put<uint32_t>(head, 0);             // No snap length
+    put<uint16_t>(head, 9);             // if_tsresol: 10^-9
+    put<uint16_t>(head, 1);
+    put<uint32_t>(head, 9);
+    put<uint32_t>(head, 0);             // opt_endofopt
+    put<uint32_t>(head, 32);
+
+    if (!writeAll(head.data(), head.size())) {
+        throw std::runtime_error("Failed to write pcapng header to " + path);
+    }
+
+    m_staging = detail::mapHugeBuffer(2 * m_config.stagingBytes, m_mappedSize);
+    if (!m_staging) {
+        throw std::runtime_error("Failed to allocate pcap staging area via mmap");
+    }
+
+    if (m_config.flushInterval.count() > 0) {
+        auto timer = m_loop.runEvery(m_config.flushInterval, [this]() { flush(); });
+        if (!timer) {
+            ::munmap(m_staging, m_mappedSize);
+            throw std::runtime_error("Failed to arm pcap flush timer");
+        }
+        m_flushTimer = timer.value();
+    }
+
+    m_writer = std::thread([this]() { run(); });
+}
+
+PcapWriter::~PcapWriter() {
+    for (const auto& tap : m_taps) {
+        (void)tap->receiver->unsubscribe(tap->port);
+    }
+    if (m_flushTimer != 0) {
+        (void)m_loop.cancelTimer(m_flushTimer);
+    }
+
+    handOver();
+    m_stop.store(true, std::memory_order_release);
+    const uint64_t one = 1;
+    (void)!::write(m_wakeFd, &one, sizeof(one));
+    m_writer.join();
+
+    ::munmap(m_staging, m_mappedSize);
+}
+
+Result<int> PcapWriter::tap(UDPReceiver& receiver, uint16_t localPort,
+        void* context, PacketHandlerFn handler) {
+    return addTap(receiver, localPort, nullptr, context, handler, nullptr);
+}
+
+Result<int> PcapWriter::tap(UDPReceiver& receiver, uint16_t localPort,
+        const SubscribeOptions& options, void* context, PacketHandlerFn handler) {
+    return addTap(receiver, localPort, &options, context, handler, nullptr);
+}
+
+Result<int> PcapWriter::tapBatch(UDPReceiver& receiver, uint16_t localPort,
+        void* context, PacketBatchHandlerFn handler) {
+    return addTap(receiver, localPort, nullptr, context, nullptr, handler);
+}
+
+Result<int> PcapWriter::tapBatch(UDPReceiver& receiver, uint16_t localPort,
+        const SubscribeOptions& options, void* context, PacketBatchHandlerFn handler) {
+    return addTap(receiver, localPort, &options, context, nullptr, handler);
+}
+
+Result<int> PcapWriter::addTap(UDPReceiver& receiver, uint16_t port, const SubscribeOptions* options,
+        void* context, PacketHandlerFn handler, PacketBatchHandlerFn batchHandler) {
+    if (!handler && !batchHandler) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    auto entry = std::make_unique<Tap>(Tap{this, &receiver, port, context, handler, batchHandler});
+
+    // Taps always read whole batches: one staging pass per recvmmsg
+    auto res = options
+        ? receiver.subscribeBatch(port, *options, entry.get(), &PcapWriter::onBatch)
+        : receiver.subscribeBatch(port, entry.get(), &PcapWriter::onBatch);
+    if (!res) return res;
+
+    // Port 0 subscriptions are keyed by the port the kernel picked
+    entry->port = static_cast<uint16_t>(res.value());
+    m_taps.push_back(std::move(entry));
+    return res;
+}
+
+Result<void> PcapWriter::untap(UDPReceiver& receiver, uint16_t localPort) {
+    for (auto it = m_taps.begin(); it != m_taps.end(); ++it) {
+        if ((*it)->receiver == &receiver && (*it)->port == localPort) {
+            auto res = receiver.unsubscribe(localPort);
+            m_taps.erase(it);
+            return res;
+        }
+    }
+    return std::error_code(ENOENT, std::system_category());
+}
+
+void PcapWriter::onBatch(void* context, int count, const PacketMetadata* packets,
+        const uint8_t* base, size_t stride) {
+    auto* tap = static_cast<Tap*>(context);
+    tap->owner->record(count, packets);
+
+    if (tap->batchHandler) {
+        tap->batchHandler(tap->context, count, packets, base, stride);
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        const PacketMetadata& pkt = packets[i];
+        const struct timespec& ts = (pkt.status & PacketStatus::HW_TIMESTAMP) ? pkt.hwTs : pkt.ts;
+        tap->handler(tap->context, pkt.data, pkt.len, pkt.status, ts);
+    }
+}
+
+uint8_t* PcapWriter::stage(size_t bytes) noexcept {
+    if (bytes > m_config.stagingBytes) [[unlikely]] return nullptr;
+
+    if (m_fill + bytes > m_config.stagingBytes) {
+        handOver();
+    }
+    if (!m_activeFree) {
+        // Reclaim the half once the writer thread has released it
+        if (m_pending[m_active].load(std::memory_order_acquire) != 0) [[unlikely]] {
+            return nullptr;
+        }
+        m_activeFree = true;
+        m_fill = 0;
+    }
+
+    uint8_t* dst = m_staging + static_cast<size_t>(m_active) * m_config.stagingBytes + m_fill;
+    m_fill += bytes;
+    return dst;
+}
+
+void PcapWriter::record(int count, const PacketMetadata* packets) noexcept {
+    int64_t nowNs = 0;
+
+    for (int i = 0; i < count; ++i) {
+        const PacketMetadata& pkt = packets[i];
+        const size_t bytes = sizeof(StagedPacket) + align8(pkt.len);
+
+        uint8_t* dst = stage(bytes);
+        if (!dst) [[unlikely]] {
+            ++m_stats.dropped;
+            continue;
+        }
+
+        auto* rec = reinterpret_cast<StagedPacket*>(dst);
+        const bool hw = m_config.hardwareStamps && (pkt.status & PacketStatus::HW_TIMESTAMP);
+        rec->tsNs = toNs(hw ? pkt.hwTs : pkt.ts);
+        if (rec->tsNs == 0) {
+            // Timestamps disabled on the receiver: stamp with the dispatch time
+            if (nowNs == 0) {
+                struct timespec now;
+                ::clock_gettime(CLOCK_REALTIME, &now);
+                nowNs = toNs(now);
+            }
+            rec->tsNs = nowNs;
+        }
+        rec->len = static_cast<uint32_t>(pkt.len);
+        rec->destPort = pkt.destPort;
+        copySender(*rec, pkt.sender);
+        std::memcpy(dst + sizeof(StagedPacket), pkt.data, pkt.len);
+        ++m_stats.staged;
+    }
+}
+
+void PcapWriter::flush() noexcept {
+    handOver();
+}
+
+void PcapWriter::handOver() noexcept {
+    if (m_fill == 0 || !m_activeFree) return;
+
+    m_pending[m_active].store(m_fill, std::memory_order_release);
+    const uint64_t one = 1;
+    (void)!::write(m_wakeFd, &one, sizeof(one));
+
+    // Halves alternate so the writer consumes them in staging order
+    m_active ^= 1;
+    m_activeFree = m_pending[m_active].load(std::memory_order_acquire) == 0;
+    m_fill = 0;
+}
+
+void PcapWriter::run() {
+    int next = 0;
+    while (true) {
+        uint64_t value;
+        ssize_t n = ::read(m_wakeFd, &value, sizeof(value));
+        if (n < 0 && errno == EINTR) continue;
+
+        const bool stopping = m_stop.load(std::memory_order_acquire);
+        while (true) {
+            const size_t used = m_pending[next].load(std::memory_order_acquire);
+            if (used == 0) break;
+            writeHalf(m_staging + static_cast<size_t>(next) * m_config.stagingBytes, used);
+            m_pending[next].store(0, std::memory_order_release);
+            next ^= 1;
+        }
+        if (stopping) break;
+    }
+}
+
+void PcapWriter::writeHalf(const uint8_t* data, size_t used) {
+    std::vector<uint8_t> out;
+    out.reserve(OUT_FLUSH + EPB_OVERHEAD + ETH_HEADER + IPV6_HEADER + UDP_HEADER + 65536);
+    uint64_t packets = 0;
+
+    auto drain = [&]() {
+        if (out.empty()) return;
+        if (writeAll(out.data(), out.size())) {
+            m_stats.written += packets;
+            m_stats.bytes += out.size();
+        } else {
+            ++m_stats.writeErrors;
+        }
+        out.clear();
+        packets = 0;
+    };
+
+    for (size_t off = 0; off < used; ) {
+        StagedPacket rec;
+        std::memcpy(&rec, data + off, sizeof(rec));
+        const uint8_t* payload = data + off + sizeof(StagedPacket);
+        off += sizeof(StagedPacket) + align8(rec.len);
+
+        // Senders are synthesized as IPv4 unless they were native IPv6
+        const bool v6 = rec.family == AF_INET6;
+        const size_t ipLen = v6 ? IPV6_HEADER : IPV4_HEADER;
+        const size_t udpLen = UDP_HEADER + rec.len;
+        const size_t frameLen = ETH_HEADER + ipLen + udpLen;
+        const size_t paddedFrame = align4(frameLen);
+        const uint32_t blockLen = static_cast<uint32_t>(EPB_OVERHEAD + paddedFrame);
+
+        put<uint32_t>(out, PCAPNG_EPB);
+        put<uint32_t>(out, blockLen);
+        put<uint32_t>(out, 0);          // Interface 0
+        put<uint32_t>(out, static_cast<uint32_t>(static_cast<uint64_t>(rec.tsNs) >> 32));
+        put<uint32_t>(out, static_cast<uint32_t>(static_cast<uint64_t>(rec.tsNs)));
+        put<uint32_t>(out, static_cast<uint32_t>(frameLen));
+        put<uint32_t>(out, static_cast<uint32_t>(frameLen));
+
+        // Ethernet: zero MACs, the tap never sees the link layer
+        uint8_t eth[ETH_HEADER] = {};
+        eth[12] = v6 ? 0x86 : 0x08;
+        eth[13] = v6 ? 0xDD : 0x00;
+        putBytes(out, eth, sizeof(eth));
+
+        // The local address is not known to the tap and is left unspecified
+        if (v6) {
+            uint8_t ip6[IPV6_HEADER] = {};
+            ip6[0] = 0x60;
+            ip6[4] = static_cast<uint8_t>(udpLen >> 8);
+            ip6[5] = static_cast<uint8_t>(udpLen);
+            ip6[6] = IPPROTO_UDP;
+            ip6[7] = 64;
+            std::memcpy(ip6 + 8, rec.srcAddr, 16);
+            putBytes(out, ip6, sizeof(ip6));
+        } else {
+            const size_t totalLen = IPV4_HEADER + udpLen;
+            uint8_t ip4[IPV4_HEADER] = {};
+            ip4[0] = 0x45;
+            ip4[2] = static_cast<uint8_t>(totalLen >> 8);
+            ip4[3] = static_cast<uint8_t>(totalLen);
+            ip4[6] = 0x40;              // Don't fragment
+            ip4[8] = 64;
+            ip4[9] = IPPROTO_UDP;
+            std::memcpy(ip4 + 12, rec.srcAddr, 4);
+            const uint16_t csum = ipv4Checksum(ip4);
+            std::memcpy(ip4 + 10, &csum, sizeof(csum));
+            putBytes(out, ip4, sizeof(ip4));
+        }
+
+        // UDP, checksum left at 0 (not computed)
+        put<uint16_t>(out, rec.srcPort);
+        put<uint16_t>(out, htons(rec.destPort));
+        put<uint16_t>(out, htons(static_cast<uint16_t>(udpLen)));
+        put<uint16_t>(out, 0);
+
+        putBytes(out, payload, rec.len);
+        pad4(out);
+        put<uint32_t>(out, blockLen);
+        ++packets;
+
+        if (out.size() >= OUT_FLUSH) drain();
+    }
+    drain();
+}
+
+bool PcapWriter::writeAll(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(m_fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include "PreciseTimers.h"
+
+// Library headers
+#include "CpuRelax.h"
+
+namespace atu_reactor::detail {
+
+TimerId PreciseTimers::add(Timestamp when, PreciseDuration interval, PreciseDuration spin, Callback cb) {
+    uint32_t index;
+    if (m_free.empty()) [[unlikely]] {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    } else {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+
+    Node& n = m_nodes[index];
+    n.callback = std::move(cb);
+    n.when = when;
+    n.wake = when - spin;
+    n.interval = interval;
+    n.spin = spin;
+    n.seq = m_nextSeq++;
+    n.state = State::LINKED;
+    push(index);
+
+    // Index is biased by one so that no valid id is ever zero
+    return ID_FLAG | (static_cast<TimerId>(n.generation & GENERATION_MASK) << 32) | (index + 1);
+}
+
+bool PreciseTimers::cancel(TimerId id) {
+    auto low = static_cast<uint32_t>(id);
+    if (!owns(id) || low == 0 || low > m_nodes.size()) [[unlikely]] return false;
+
+    uint32_t index = low - 1;
+    Node& n = m_nodes[index];
+    if ((n.generation & GENERATION_MASK) != static_cast<uint32_t>((id >> 32) & GENERATION_MASK)) {
+        return false;
+    }
+
+    switch (n.state) {
+        case State::LINKED:
+            remove(n.heapPos);
+            release(index);
+            return true;
+        case State::RUNNING:
+            // Inside its own callback: advance() releases it afterwards
+            n.state = State::CANCELLED;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PreciseTimers::advance(Timestamp now) {
+    // Timers added by callbacks wait for the next pass, even when already due:
+    // a zero-delay timer that reschedules itself must not livelock the loop
+    const uint64_t limit = m_nextSeq;
+
+    while (!m_heap.empty()) {
+        uint32_t index = m_heap.front();
+        Node& n = m_nodes[index];
+        if (n.wake > now || n.seq >= limit) break;
+
+        remove(0);
+
+        // Woken up early on purpose: burn the last stretch on the clock
+        while (Clock::now() < n.when) {
+            detail::cpuRelax();
+        }
+
+        n.state = State::RUNNING;
+        if (n.callback) n.callback();
+
+        if (n.state == State::CANCELLED || n.interval.count() == 0) {
+            release(index);
+            continue;
+        }
+
+        // Drift-free rescheduling; skip missed periods if we fell behind
+        n.state = State::LINKED;
+        n.when += n.interval;
+        if (n.when <= now) n.when = now + n.interval;
+        n.wake = n.when - n.spin;
+        push(index);
+    }
+}
+
+bool PreciseTimers::nextWakeup(Timestamp& when) const {
+    if (m_heap.empty()) return false;
+
+    when = m_nodes[m_heap.front()].wake;
+    return true;
+}
+
+void PreciseTimers::push(uint32_t index) {
+    m_heap.push_back(index);
+    auto pos = static_cast<uint32_t>(m_heap.size() - 1);
+    m_nodes[index].heapPos = pos;
+    siftUp(pos);
+}
+
+void PreciseTimers::remove(uint32_t pos) {
+    uint32_t index = m_heap[pos];
+    uint32_t last = m_heap.back();
+    m_heap.pop_back();
+    m_nodes[index].heapPos = NO_POS;
+
+    if (pos < m_heap.size()) {
+        place(pos, last);
+        siftUp(pos);
+        siftDown(m_nodes[last].heapPos);
+    }
+}
+
+void PreciseTimers::siftUp(uint32_t pos) {
+    uint32_t index = m_heap[pos];
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!before(index, m_heap[parent])) break;
+        place(pos, m_heap[parent]);
+        pos = parent;
+    }
+    place(pos, index);
+}
+
+void PreciseTimers::siftDown(uint32_t pos) {
+    uint32_t index = m_heap[pos];
+    const auto size = static_cast<uint32_t>(m_heap.size());
+    for (;;) {
+        uint32_t child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && before(m_heap[child + 1], m_heap[child])) child++;
+        if (!before(m_heap[child], index)) break;
+        place(pos, m_heap[child]);
+        pos = child;
+    }
+    place(pos, index);
+}
+
+void PreciseTimers::place(uint32_t pos, uint32_t index) {
+    m_heap[pos] = index;
+    m_nodes[index].heapPos = pos;
+}
+
+void PreciseTimers::release(uint32_t index) {
+    Node& n = m_nodes[index];
+    n.callback = nullptr;
+    n.state = State::FREE;
+    n.generation++;   // Invalidates every TimerId handed out for this node
+    m_free.push_back(index);
+}
+
+} // namespace atu_reactor::detail
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+
+namespace atu_reactor::detail {
+
+/**
+ * @class PreciseTimers
+ * @brief Nanosecond timers kept in a binary min-heap next to the 1ms wheel.
+ * Each timer is keyed by its wake time, the deadline minus an optional spin
+ * lead: the timerfd wakes the loop that much early and advance() busy-waits
+ * on steady_clock for the rest, trading a little CPU for sub-microsecond
+ * accuracy. Nodes are pooled and reused, so steady-state add/cancel never
+ * allocate; both are O(log n).
+ */
+class PreciseTimers {
+    public:
+        using Callback = std::function<void()>;
+
+        // Tags the ids handed out here, so cancelTimer knows where to look
+        static constexpr TimerId ID_FLAG = 1ULL << 63;
+
+        static bool owns(TimerId id) { return (id & ID_FLAG) != 0; }
+
+        /**
+         * @brief Schedules cb at when.
+         * @param interval Zero for one-shot timers.
+         * @param spin How long before when to wake up and start spinning.
+         */
+        TimerId add(Timestamp when, PreciseDuration interval, PreciseDuration spin, Callback cb);
+
+        /**
+         * @brief Cancels a pending timer. Safe to call from any timer callback.
+         * @return false if the id is unknown or the timer already fired.
+         */
+        bool cancel(TimerId id);
+
+        /**
+         * @brief Runs every timer whose wake time has come, spinning up to its deadline.
+         * Timers added from a callback are left for the next call.
+         */
+        void advance(Timestamp now);
+
+        /**
+         * @brief Earliest wake time (deadline minus spin lead).
+         * @return false if no timer is pending.
+         */
+        bool nextWakeup(Timestamp& when) const;
+
+    private:
+        static constexpr uint32_t NO_POS = ~0u;
+        static constexpr uint32_t GENERATION_MASK = 0x7FFFFFFF;
+
+        enum class State : uint8_t { FREE, LINKED, RUNNING, CANCELLED };
+
+        struct Node {
+            Callback callback;
+            Timestamp when;
+            Timestamp wake;
+            PreciseDuration interval{0};
+            PreciseDuration spin{0};
+            uint64_t seq = 0;       // Creation order for equal wake times
+            uint32_t generation = 0;
+            uint32_t heapPos = NO_POS;
+            State state = State::FREE;
+        };
+
+        bool before(uint32_t a, uint32_t b) const {
+            const Node& x = m_nodes[a];
+            const Node& y = m_nodes[b];
+            return x.wake < y.wake || (x.wake == y.wake && x.seq < y.seq);
+        }
+
+        void push(uint32_t index);
+        void remove(uint32_t pos);
+        void siftUp(uint32_t pos);
+        void siftDown(uint32_t pos);
+        void place(uint32_t pos, uint32_t index);
+        void release(uint32_t index);
+
+        // deque: references stay valid while callbacks add timers
+        std::deque<Node> m_nodes;
+        std::vector<uint32_t> m_free;
+        std::vector<uint32_t> m_heap;
+        uint64_t m_nextSeq = 0;
+};
+
+} // namespace atu_reactor::detail
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/ReactorGroup.h>
+
+// System headers
+#include <cerrno>
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/socket.h>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/UDPReceiver.h>
+
+namespace atu_reactor {
+
+namespace {
+
+thread_local int t_currentShard = -1;
+
+} // namespace
+
+ReactorGroup::ReactorGroup(ReactorGroupConfig config)
+        : m_config(std::move(config))
+{
+    if (m_config.cpus.empty()) {
+        throw std::runtime_error("ReactorGroup needs at least one CPU");
+    }
+
+    m_shards.resize(m_config.cpus.size());
+    for (size_t i = 0; i < m_shards.size(); ++i) {
+        m_shards[i].cpu = m_config.cpus[i];
+    }
+}
+
+ReactorGroup::~ReactorGroup() {
+    stop();
+}
+
+int ReactorGroup::currentShard() {
+    return t_currentShard;
+}
+
+Result<int> ReactorGroup::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
+    if (handler == nullptr) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+    return addSubscription({port, context, handler, nullptr});
+}
+
+Result<int> ReactorGroup::subscribeBatch(uint16_t port, void* context, PacketBatchHandlerFn handler) {
+    if (handler == nullptr) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+    return addSubscription({port, context, nullptr, handler});
+}
+
+Result<int> ReactorGroup::addSubscription(Subscription sub) {
+    if (currentShard() >= 0) {
+        // Waiting for our own loop would never return
+        return std::error_code(EDEADLK, std::system_category());
+    }
+
+    if (m_started && !m_running) {
+        return std::error_code(EBUSY, std::system_category());
+    }
+
+    if (sub.port == 0) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    for (const auto& existing : m_subscriptions) {
+        if (existing.port == sub.port) {
+            return std::error_code(EADDRINUSE, std::system_category());
+        }
+    }
+
+    m_subscriptions.push_back(sub);
+    if (!m_started) {
+        return static_cast<int>(sub.port);
+    }
+
+    // Shard by shard, so the reuseport group keeps socket order == shard order
+    std::error_code ec;
+    size_t opened = 0;
+    while (opened < m_shards.size()) {
+        Shard& shard = m_shards[opened];
+        if ((ec = runOnShard(shard, [&]() { return openOnShard(shard, sub); }))) {
+            break;
+        }
+        ++opened;
+    }
+
+    if (!ec && m_config.steerByCpu) {
+        if (auto res = attachSteering(m_subscriptions.size() - 1); !res) {
+            ec = res.error();
+        }
+    }
+
+    if (ec) {
+        for (size_t i = 0; i < opened; ++i) {
+            Shard& shard = m_shards[i];
+            runOnShard(shard, [&]() {
+                shard.fds.pop_back();
+                (void)shard.receiver->unsubscribe(sub.port);
+                return std::error_code{};
+            });
+        }
+        m_subscriptions.pop_back();
+        return ec;
+    }
+
+    return static_cast<int>(sub.port);
+}
+
+Result<void> ReactorGroup::unsubscribe(uint16_t port) {
+    if (currentShard() >= 0) {
+        return std::error_code(EDEADLK, std::system_category());
+    }
+
+    size_t index = 0;
+    while (index < m_subscriptions.size() && m_subscriptions[index].port != port) {
+        ++index;
+    }
+    if (index == m_subscriptions.size()) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+
+    if (m_running) {
+        for (auto& shard : m_shards) {
+            runOnShard(shard, [&]() {
+                shard.fds.erase(shard.fds.begin() + static_cast<std::ptrdiff_t>(index));
+                auto res = shard.receiver->unsubscribe(port);
+                return res ? std::error_code{} : res.error();
+            });
+        }
+    }
+
+    m_subscriptions.erase(m_subscriptions.begin() + static_cast<std::ptrdiff_t>(index));
+    return Result<void>::success();
+}
+
+Result<void> ReactorGroup::start() {
+    if (m_started) {
+        return std::error_code(EALREADY, std::system_category());
+    }
+    m_started = true;
+    m_running = true;
+
+    // One shard at a time: socket order in each reuseport group == shard order
+    for (size_t i = 0; i < m_shards.size(); ++i) {
+        std::promise<std::error_code> ready;
+        auto readyFuture = ready.get_future();
+
+        m_shards[i].thread = std::thread(&ReactorGroup::runShard, this, i, std::move(ready));
+
+        if (std::error_code ec = readyFuture.get()) {
+            stop();
+            return ec;
+        }
+    }
+
+    if (m_config.steerByCpu) {
+        for (size_t i = 0; i < m_subscriptions.size(); ++i) {
+            if (auto res = attachSteering(i); !res) {
+                stop();
+                return res;
+            }
+        }
+    }
+
+    return Result<void>::success();
+}
+
+void ReactorGroup::stop() {
+    m_running = false;
+
+    for (auto& shard : m_shards) {
+        // The flag is set on the shard thread, so its loop is alive until then
+        if (shard.loop) {
+            shard.loop->post([&shard]() { shard.stopping = true; });
+        }
+        if (shard.thread.joinable()) {
+            shard.thread.join();
+        }
+        shard.loop = nullptr;
+        shard.receiver = nullptr;
+        shard.fds.clear();
+    }
+}
+
+std::error_code ReactorGroup::runOnShard(Shard& shard, const std::function<std::error_code()>& fn) {
+    std::promise<std::error_code> done;
+    auto result = done.get_future();
+
+    shard.loop->post([&]() { done.set_value(fn()); });
+    return result.get();
+}
+
+std::error_code ReactorGroup::openOnShard(Shard& shard, const Subscription& sub) {
+    auto res = sub.handler
+        ? shard.receiver->subscribe(sub.port, sub.context, sub.handler)
+        : shard.receiver->subscribeBatch(sub.port, sub.context, sub.batchHandler);
+    if (!res) {
+        return res.error();
+    }
+
+    int fd = shard.receiver->getFd(sub.port);
+
+    // Hint for the kernel's own reuseport selection
+    int cpu = shard.cpu;
+    ::setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+
+    shard.fds.push_back(fd);
+    return {};
+}
+
+void ReactorGroup::runShard(size_t index, std::promise<std::error_code> ready) {
+    t_currentShard = static_cast<int>(index);
+    Shard& shard = m_shards[index];
+
+    // Pin first, so the loop and packet buffer are allocated on the local node
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(shard.cpu, &cpuSet);
+    if (int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet); rc != 0) {
+        ready.set_value(std::error_code(rc, std::system_category()));
+        return;
+    }
+
+    std::unique_ptr<EventLoop> loop;
+    std::unique_ptr<UDPReceiver> receiver;
+    try {
+        loop = std::make_unique<EventLoop>();
+        if (auto res = loop->setPollPolicy(m_config.poll); !res) {
+            ready.set_value(res.error());
+            return;
+        }
+        receiver = std::make_unique<UDPReceiver>(*loop, m_config.receiver);
+    } catch (const std::exception&) {
+        ready.set_value(std::error_code(ENOMEM, std::system_category()));
+        return;
+    }
+
+    shard.receiver = receiver.get();
+    for (const auto& sub : m_subscriptions) {
+        if (std::error_code ec = openOnShard(shard, sub)) {
+            shard.receiver = nullptr;
+            ready.set_value(ec);
+            return;
+        }
+    }
+
+    // Published by the promise: from here on the control thread may post()
+    shard.loop = loop.get();
+    ready.set_value({});
+
+    while (!shard.stopping) {
+        (void)loop->runOnce(m_config.pollTimeoutMs);
+    }
+
+    // Receiver before loop: it removes its sources on destruction
+    receiver.reset();
+    loop.reset();
+}
+
+Result<void> ReactorGroup::attachSteering(size_t subscription) {
+    const uint32_t shardCount = static_cast<uint32_t>(m_shards.size());
+
+    // A = CPU that processed the packet; return the shard pinned to it
+    std::vector<struct sock_filter> code;
+    code.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)));
+    for (uint32_t i = 0; i < shardCount; ++i) {
+        code.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, static_cast<uint32_t>(m_shards[i].cpu), 0, 1));
+        code.push_back(BPF_STMT(BPF_RET | BPF_K, i));
+    }
+
+    // CPU without a shard: spread deterministically
+    code.push_back(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, shardCount));
+    code.push_back(BPF_STMT(BPF_RET | BPF_A, 0));
+
+    struct sock_fprog prog{};
+    prog.len = static_cast<unsigned short>(code.size());
+    prog.filter = code.data();
+
+    // The program belongs to the reuseport group: attaching through shard 0 is enough
+    int fd = m_shards[0].fds[subscription];
+    if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    return Result<void>::success();
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
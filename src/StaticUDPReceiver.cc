@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/StaticUDPReceiver.h>
+
+// System headers
+#include <sys/epoll.h>
+
+// Library headers
+#include "UdpSocket.h"
+
+namespace atu_reactor {
+
+StaticReceiverBase::StaticReceiverBase(EventLoop& loop, ReceiverConfig config)
+        : PacketReceiver(loop, config)
+{
+}
+
+StaticReceiverBase::~StaticReceiverBase() = default;
+
+Result<int> StaticReceiverBase::addSocket(uint16_t port, const SubscribeOptions& options,
+        EventCallbackFn onReadable) {
+    if (auto res = checkSubscribe(port); !res) {
+        return res.error();
+    }
+
+    ScopedFd udp_socket;
+    auto openRes = detail::openUdpSocket(port, udp_socket, options, m_config.timestamps);
+    if (!openRes) {
+        return openRes.error();
+    }
+    if (auto res = detail::configureBusyPoll(udp_socket, m_config); !res) {
+        return res.error();
+    }
+    if (auto res = detail::configureTimestamps(udp_socket, m_config); !res) {
+        return res.error();
+    }
+
+    const uint16_t localPort = openRes.value();
+    auto sock = std::make_unique<Socket>(Socket{this, static_cast<int>(udp_socket), localPort, options.weight});
+
+    const uint32_t events = m_config.edgeTriggered ? (EPOLLIN | EPOLLET) : EPOLLIN;
+    auto regResult = m_loop.addSource(udp_socket, events, CallbackTag{onReadable, sock.get()},
+            options.priority);
+    if (!regResult) {
+        return regResult.error();
+    }
+
+    m_sockets.emplace(localPort, std::move(sock));
+    m_port_to_fd_map.emplace(localPort, std::move(udp_socket));
+    return {static_cast<int>(localPort)};
+}
+
+void StaticReceiverBase::rearm(int fd) {
+    (void)m_loop.modifySource(fd, EPOLLIN | EPOLLET);
+}
+
+Result<void> StaticReceiverBase::unsubscribe(uint16_t port) {
+    ++m_epoch;
+    auto res = PacketReceiver::unsubscribe(port);
+    m_sockets.erase(port);
+    return res;
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include "TimerWheel.h"
+
+// System headers
+#include <algorithm>
+#include <limits>
+
+namespace atu_reactor::detail {
+
+TimerWheel::TimerWheel(Timestamp epoch) : m_epoch(epoch) {
+    for (auto& level : m_heads) level.fill(NIL);
+    for (auto& level : m_tails) level.fill(NIL);
+}
+
+TimerId TimerWheel::add(Timestamp when, Duration interval, Callback cb) {
+    // Round up so a timer never fires before its deadline
+    auto tick = static_cast<uint64_t>(std::chrono::ceil<Duration>(when - m_epoch).count());
+    if (tick <= m_current) tick = m_current + 1;
+
+    uint32_t index = allocate();
+    Node& n = node(index);
+    n.callback = std::move(cb);
+    n.expires = tick;
+    n.interval = static_cast<uint64_t>(interval.count());
+    n.seq = m_nextSeq++;
+    n.state = State::LINKED;
+    link(index);
+
+    // Index is biased by one so that no valid id is ever zero
+    return (static_cast<TimerId>(n.generation & GENERATION_MASK) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    auto low = static_cast<uint32_t>(id);
+    if (low == 0 || low > m_chunks.size() * CHUNK_SIZE) [[unlikely]] return false;
+
+    uint32_t index = low - 1;
+    Node& n = node(index);
+    if ((n.generation & GENERATION_MASK) != static_cast<uint32_t>(id >> 32)) return false;
+
+    switch (n.state) {
+        case State::LINKED:
+            unlink(index);
+            release(index);
+            return true;
+        case State::RUNNING:
+            // Either in the current expired batch or inside its own callback:
+            // advance() releases it once it is safe to destroy the callback.
+            n.state = State::CANCELLED;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void TimerWheel::advance(Timestamp now) {
+    auto nowTick = static_cast<uint64_t>(std::chrono::floor<Duration>(now - m_epoch).count());
+
+    // Jump straight from one tick with work to the next; empty ticks cost nothing
+    for (uint64_t tick = nextEventTick(); tick <= nowTick; tick = nextEventTick()) {
+        processTick(tick);
+    }
+
+    // No slot is due before nowTick, so every node keeps its placement
+    if (nowTick > m_current) m_current = nowTick;
+}
+
+bool TimerWheel::nextWakeup(Timestamp& when) const {
+    uint64_t tick = nextEventTick();
+    if (tick == std::numeric_limits<uint64_t>::max()) return false;
+
+    when = m_epoch + Duration(static_cast<Duration::rep>(tick));
+    return true;
+}
+
+uint32_t TimerWheel::allocate() {
+    if (m_freeList == NIL) [[unlikely]] {
+        auto base = static_cast<uint32_t>(m_chunks.size() * CHUNK_SIZE);
+        m_chunks.push_back(std::make_unique<Node[]>(CHUNK_SIZE));
+
+        // Chain the new chunk so that lower indexes are handed out first
+        for (uint32_t i = CHUNK_SIZE; i-- > 0;) {
+            node(base + i).next = m_freeList;
+            m_freeList = base + i;
+        }
+    }
+
+    uint32_t index = m_freeList;
+    m_freeList = node(index).next;
+    return index;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& n = node(index);
+    n.callback = nullptr;
+    n.state = State::FREE;
+    n.generation++;   // Invalidates every TimerId handed out for this node
+    n.prev = NIL;
+    n.next = m_freeList;
+    m_freeList = index;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& n = node(index);
+
+    uint64_t diff = n.expires ^ m_current;
+    int level = diff ? (63 - __builtin_clzll(diff)) / LEVEL_BITS : 0;
+    int slot = 0;
+    if (level >= LEVELS) [[unlikely]] {
+        level = LEVELS;     // Beyond the current block: overflow list
+    } else {
+        slot = static_cast<int>((n.expires >> (level * LEVEL_BITS)) & (SLOTS - 1));
+    }
+
+    n.level = static_cast<uint8_t>(level);
+    n.slot = static_cast<uint8_t>(slot);
+    n.next = NIL;
+    n.prev = m_tails[level][slot];
+
+    if (n.prev == NIL) {
+        m_heads[level][slot] = index;
+        m_occupied[level] |= 1ULL << slot;
+    } else {
+        node(n.prev).next = index;
+    }
+    m_tails[level][slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& n = node(index);
+
+    if (n.prev == NIL) m_heads[n.level][n.slot] = n.next;
+    else node(n.prev).next = n.next;
+
+    if (n.next == NIL) m_tails[n.level][n.slot] = n.prev;
+    else node(n.next).prev = n.prev;
+
+    if (m_heads[n.level][n.slot] == NIL) {
+        m_occupied[n.level] &= ~(1ULL << n.slot);
+    }
+}
+
+void TimerWheel::detachSlot(int level, int slot, uint32_t& head) {
+    head = m_heads[level][slot];
+    m_heads[level][slot] = NIL;
+    m_tails[level][slot] = NIL;
+    m_occupied[level] &= ~(1ULL << slot);
+}
+
+uint64_t TimerWheel::nextEventTick() const {
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = level * LEVEL_BITS;
+        auto group = static_cast<int>((m_current >> shift) & (SLOTS - 1));
+
+        // Only slots after the current one can be occupied on each level
+        uint64_t pending = m_occupied[level] & ~((2ULL << group) - 1);
+        if (pending) {
+            auto slot = static_cast<uint64_t>(__builtin_ctzll(pending));
+            uint64_t block = (m_current >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS);
+            return block | (slot << shift);
+        }
+    }
+
+    // Nothing left in this block: the overflow list is due at the next one
+    if (m_occupied[LEVELS]) [[unlikely]] return (m_current | MAX_SPAN) + 1;
+    return std::numeric_limits<uint64_t>::max();
+}
+
+void TimerWheel::processTick(uint64_t tick) {
+    m_current = tick;
+
+    // Entering a new block: pull in the overflow expiries that now fit
+    if ((tick & MAX_SPAN) == 0 && m_occupied[LEVELS]) [[unlikely]] {
+        uint32_t index;
+        detachSlot(LEVELS, 0, index);
+        while (index != NIL) {
+            uint32_t next = node(index).next;
+            link(index);
+            index = next;
+        }
+    }
+
+    // Cascade from the top so that nodes falling through several levels
+    // during the same tick are re-distributed by the level below
+    for (int level = LEVELS - 1; level > 0; --level) {
+        int shift = level * LEVEL_BITS;
+        if (tick & ((1ULL << shift) - 1)) continue;
+
+        auto slot = static_cast<int>((tick >> shift) & (SLOTS - 1));
+        if (!(m_occupied[level] & (1ULL << slot))) continue;
+
+        uint32_t index;
+        detachSlot(level, slot, index);
+        while (index != NIL) {
+            uint32_t next = node(index).next;
+            link(index);
+            index = next;
+        }
+    }
+
+    auto slot = static_cast<int>(tick & (SLOTS - 1));
+    if (!(m_occupied[0] & (1ULL << slot))) return;
+
+    m_expired.clear();
+    uint32_t index;
+    detachSlot(0, slot, index);
+    while (index != NIL) {
+        Node& n = node(index);
+        n.state = State::RUNNING;
+        m_expired.push_back({n.seq, index});
+        index = n.next;
+    }
+
+    // Cascades interleave nodes, restore creation order within the tick
+    if (m_expired.size() > 1) {
+        std::sort(m_expired.begin(), m_expired.end(),
+            [](const Expired& a, const Expired& b) { return a.seq < b.seq; });
+    }
+
+    // Callbacks may add or cancel timers. Chunks never move, so the
+    // references below stay valid even if the pool grows meanwhile.
+    for (const Expired& e : m_expired) {
+        Node& n = node(e.index);
+
+        if (n.state == State::RUNNING && n.callback) {
+            n.callback();
+        }
+
+        if (n.state == State::CANCELLED || n.interval == 0) {
+            release(e.index);
+            continue;
+        }
+
+        // Drift-free rescheduling; catch up immediately if we fell behind
+        n.state = State::LINKED;
+        n.expires += n.interval;
+        if (n.expires <= m_current) n.expires = m_current + 1;
+        link(e.index);
+    }
+    m_expired.clear();
+}
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Library headers
+#include <atu_reactor/EventLoop.h>
+
+namespace atu_reactor::detail {
+
+/**
+ * @class TimerWheel
+ * @brief Hashed hierarchical timer wheel with 1ms ticks.
+ * Six levels of 64 slots cover ~2^36 ms. A timer lives on the level of
+ * the highest 6-bit group where its expiry differs from the current tick,
+ * in the slot named by that group, and cascades one level down each time
+ * the wheel reaches the start of its slot. Expiries past the current
+ * 2^36 ms block wait on an overflow list, re-linked whenever the wheel
+ * enters a new block. A 64-bit occupancy mask per level finds the next
+ * tick that needs work without scanning empty slots.
+ *
+ * Nodes are pooled in fixed chunks and linked intrusively by index, so
+ * add/cancel are O(1) and allocation-free once the pool has grown to the
+ * working set.
+ */
+class TimerWheel {
+    public:
+        using Callback = std::function<void()>;
+
+        explicit TimerWheel(Timestamp epoch);
+
+        /**
+         * @brief Schedules cb at when (rounded up to the next tick).
+         * @param interval Zero for one-shot timers.
+         */
+        TimerId add(Timestamp when, Duration interval, Callback cb);
+
+        /**
+         * @brief Cancels a pending timer. Safe to call from any timer callback.
+         * @return false if the id is unknown or the timer already fired.
+         */
+        bool cancel(TimerId id);
+
+        /**
+         * @brief Runs every timer due at now, in expiry then creation order.
+         */
+        void advance(Timestamp now);
+
+        /**
+         * @brief Earliest time advance() has work to do.
+         * @return false if no timer is pending.
+         */
+        bool nextWakeup(Timestamp& when) const;
+
+    private:
+        static constexpr int LEVEL_BITS = 6;
+        static constexpr int SLOTS = 1 << LEVEL_BITS;
+        static constexpr int LEVELS = 6;
+        static constexpr uint64_t MAX_SPAN = (1ULL << (LEVEL_BITS * LEVELS)) - 1;
+
+        static constexpr uint32_t NIL = ~0u;
+
+        // The top id bit marks PreciseTimers ids
+        static constexpr uint32_t GENERATION_MASK = 0x7FFFFFFF;
+        static constexpr uint32_t CHUNK_BITS = 8;
+        static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+
+        enum class State : uint8_t { FREE, LINKED, RUNNING, CANCELLED };
+
+        struct Node {
+            Callback callback;
+            uint64_t expires = 0;   // Absolute tick
+            uint64_t interval = 0;  // Ticks, zero if one-shot
+            uint64_t seq = 0;       // Creation order for equal expiries
+            uint32_t prev = NIL;
+            uint32_t next = NIL;
+            uint32_t generation = 0;
+            uint8_t level = 0;
+            uint8_t slot = 0;
+            State state = State::FREE;
+        };
+
+        struct Expired {
+            uint64_t seq;
+            uint32_t index;
+        };
+
+        Node& node(uint32_t index) {
+            return m_chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+        }
+
+        uint32_t allocate();
+        void release(uint32_t index);
+        void link(uint32_t index);
+        void unlink(uint32_t index);
+        uint64_t nextEventTick() const;
+        void detachSlot(int level, int slot, uint32_t& head);
+        void processTick(uint64_t tick);
+
+        Timestamp m_epoch;
+        uint64_t m_current = 0;     // Last tick processed
+        uint64_t m_nextSeq = 0;
+
+        // The extra level holds the overflow list, always in slot 0
+        std::array<std::array<uint32_t, SLOTS>, LEVELS + 1> m_heads;
+        std::array<std::array<uint32_t, SLOTS>, LEVELS + 1> m_tails;
+        std::array<uint64_t, LEVELS + 1> m_occupied{};
+
+        std::vector<std::unique_ptr<Node[]>> m_chunks;
+        uint32_t m_freeList = NIL;
+
+        // Reused between ticks so firing never allocates in steady state
+        std::vector<Expired> m_expired;
+};
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
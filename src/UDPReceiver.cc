@@ -19,18 +19,56 @@
 #include <atu_reactor/UDPReceiver.h>
 
 // System headers
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
+#include <netinet/udp.h>
 #include <sys/epoll.h>
 
+// Library headers
+#include "Numa.h"
+#include "UdpSocket.h"
+
+// Fallbacks for older libc headers
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 namespace atu_reactor {
 
+ReceiverConfig UDPReceiver::bufferLayout(ReceiverConfig config) {
+    // A coalesced datagram must fit a single slot
+    if (config.enableGro && config.bufferSize < GRO_BUFFER_SIZE) {
+        config.bufferSize = GRO_BUFFER_SIZE;
+    }
+    return config;
+}
+
 UDPReceiver::UDPReceiver(EventLoop& loopRef, ReceiverConfig config)
-        : PacketReceiver(loopRef, config),
-        // Allocate ONE big chunk of memory for all packets
-        m_msgHeaders(config.batchSize),
-        m_senderAddrs(config.batchSize),
-        m_controlBuffers(config.batchSize)
+        : PacketReceiver(loopRef, bufferLayout(config)),
+        m_wantControl(config.enableGro || config.enableStats || config.timestamps != TimestampSource::NONE)
 {
+    {
+        // The arrays recvmmsg walks live on the same node as the packet buffer
+        detail::NodeAllocScope local(m_numaNode);
+        const auto batch = static_cast<size_t>(config.batchSize);
+        m_msgHeaders.resize(batch);
+        m_senderAddrs.resize(batch);
+        m_controlBuffers.resize(batch);
+        m_metadata.resize(config.enableGro ? batch * GRO_MAX_SEGMENTS : batch);
+        if (config.poolSlots > 0) {
+            m_slots.assign(batch, BufferPool::NO_SLOT);
+        }
+    }
+
+    if (config.poolSlots > 0) {
+        m_pool = std::make_shared<BufferPool>(static_cast<size_t>(config.poolSlots), m_alignedBufferSize,
+                m_numaNode, config.prefault);
+    }
+
     // Initialize iovecs using the aligned stride
     for (int i = 0; i < m_config.batchSize; ++i) {
         // Reset the header structure
@@ -46,91 +84,114 @@ UDPReceiver::UDPReceiver(EventLoop& loopRef, ReceiverConfig config)
         h.msg_name = &m_senderAddrs[i];
 
         // Ancillary Data: Control buffers for HW timestamps/metadata
-        h.msg_control = m_controlBuffers[i].data();
+        h.msg_control = m_wantControl ? m_controlBuffers[i].data() : nullptr;
     }
 }
 
-Result<int> UDPReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
-    if (auto baseRes = PacketReceiver::subscribe(port, context, handler); !baseRes.has_value()) {
-        return Result<int>(baseRes.error());
+UDPReceiver::~UDPReceiver() {
+    // Leases may keep their slots (and the pool) alive past this point
+    for (uint32_t slot : m_slots) {
+        if (slot != BufferPool::NO_SLOT) m_pool->release(slot);
     }
+}
 
-    // Attempt IPv6 Dual-Stack Socket
-    int raw_fd = ::socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
-    bool isV6 = true;
-
-    if (raw_fd < 0 && errno == EAFNOSUPPORT) {
-        // Fallback to IPv4 if IPv6 is disabled in the kernel
-        isV6 = false;
-        raw_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+Result<uint16_t> UDPReceiver::openSocket(uint16_t port, const SubscribeOptions& options, ScopedFd& sock) {
+    ScopedFd udp_socket;
+    auto openRes = detail::openUdpSocket(port, udp_socket, options, m_config.timestamps);
+    if (!openRes) {
+        return openRes.error();
     }
 
-    if (raw_fd < 0) {
-        // Here the OS will naturally return EMFILE if the real limit is hit
-        return std::error_code(errno, std::system_category());
+    if (m_config.enableGro) {
+        int on = 1;
+        if (::setsockopt(udp_socket, SOL_UDP, UDP_GRO, &on, sizeof(on)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
     }
 
-    // Immediately wrap in your ScopedFd for RAII safety
-    ScopedFd udp_socket(raw_fd);
+    if (auto res = detail::configureBusyPoll(udp_socket, m_config); !res) {
+        return res.error();
+    }
 
-    // Reuse Address: Allows immediate restart of the application
-    if (int optval = 1; setsockopt(udp_socket, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
-        return std::error_code(errno, std::system_category());
+    if (auto res = detail::configureTimestamps(udp_socket, m_config); !res) {
+        return res.error();
     }
 
-    if (int reusePort = 1; setsockopt(udp_socket, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) < 0) {
-        return std::error_code(errno, std::system_category());
+    sock = std::move(udp_socket);
+    return openRes.value();
+}
+
+Result<PortStats*> UDPReceiver::attachStats(uint16_t port, int fd) {
+    if (!m_config.enableStats) [[likely]] {
+        return static_cast<PortStats*>(nullptr);
     }
 
-    if (int enabled = 1; setsockopt(udp_socket, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) < 0) {
+    // The kernel then reports the socket's cumulative queue drops with every datagram
+    if (int on = 1; ::setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on)) < 0) {
         return std::error_code(errno, std::system_category());
     }
 
-    if (isV6) {
-        // Allow IPv4 packets on this IPv6 socket
-        int off = 0;
-        setsockopt(udp_socket, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    auto stats = std::make_shared<PortStats>();
+    PortStats* raw = stats.get();
+    m_portStats[port] = std::move(stats);
+    return raw;
+}
 
-        struct sockaddr_in6 addr6{};
-        addr6.sin6_family = AF_INET6;
-        addr6.sin6_port = htons(port);
-        addr6.sin6_addr = in6addr_any;
+uint32_t UDPReceiver::sourceEvents() const {
+    return m_config.edgeTriggered ? (EPOLLIN | EPOLLET) : EPOLLIN;
+}
 
-        if (::bind(udp_socket, reinterpret_cast<struct sockaddr*>(&addr6), sizeof(addr6)) == -1) {
-            return std::error_code(errno, std::system_category());
-        }
-    } else {
-        struct sockaddr_in addr4{};
-        addr4.sin_family = AF_INET;
-        addr4.sin_port = htons(port);
-        addr4.sin_addr.s_addr = INADDR_ANY; // Listen on all available interfaces
+Result<void> UDPReceiver::unsubscribe(uint16_t port) {
+    ++m_epoch;
+    auto res = PacketReceiver::unsubscribe(port);
+    m_portStats.erase(port);
+    return res;
+}
 
-        if (::bind(udp_socket, reinterpret_cast<struct sockaddr*>(&addr4), sizeof(addr4)) == -1) {
-            return std::error_code(errno, std::system_category());
-        }
+std::shared_ptr<const PortStats> UDPReceiver::portStats(uint16_t port) const {
+    checkThread();
+
+    auto it = m_portStats.find(port);
+    return (it != m_portStats.end()) ? it->second : nullptr;
+}
+
+Result<int> UDPReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
+    return subscribe(port, SubscribeOptions{}, context, handler);
+}
+
+Result<int> UDPReceiver::subscribe(uint16_t port, const SubscribeOptions& options,
+        void* context, PacketHandlerFn handler) {
+    if (auto baseRes = PacketReceiver::subscribe(port, context, handler); !baseRes.has_value()) {
+        return Result<int>(baseRes.error());
     }
 
-    // Resolve the actual port (Crucial for port 0)
-    struct sockaddr_storage ss;
-    if (socklen_t len = sizeof(ss); getsockname(udp_socket, reinterpret_cast<struct sockaddr*>(&ss), &len) == -1) {
-        return std::error_code(errno, std::system_category());
+    ScopedFd udp_socket;
+    auto openRes = openSocket(port, options, udp_socket);
+    if (!openRes) {
+        return openRes.error();
     }
 
-    uint16_t localPort = (ss.ss_family == AF_INET6)
-        ? ntohs(reinterpret_cast<struct sockaddr_in6*>(&ss)->sin6_port)
-        : ntohs(reinterpret_cast<struct sockaddr_in*>(&ss)->sin_port);
+    uint16_t localPort = openRes.value();
+
+    auto statsRes = attachStats(localPort, udp_socket);
+    if (!statsRes) {
+        return statsRes.error();
+    }
 
     // Register with the EventLoop using your custom Tag
-    auto regResult = m_loop.addSource(udp_socket, EPOLLIN, UDPReceiverTag{
+    auto regResult = m_loop.addSource(udp_socket, sourceEvents(), UDPReceiverTag{
         this,
         (int)udp_socket,
         context,
-        handler
-    });
+        handler,
+        statsRes.value(),
+        options.weight
+    }, options.priority);
 
     if (!regResult) {
         // If epoll registration fails, ScopedFd will automatically close the socket
         // when we return the error here.
+        m_portStats.erase(localPort);
         return regResult.error();
     }
 
@@ -140,24 +201,130 @@ Result<int> UDPReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn
     return {static_cast<int>(localPort)};
 }
 
-// NOTE: handleRead assumes exclusive access to m_flatBuffer.
+Result<int> UDPReceiver::subscribeBatch(uint16_t port, void* context, PacketBatchHandlerFn handler) {
+    return subscribeBatch(port, SubscribeOptions{}, context, handler);
+}
+
+Result<int> UDPReceiver::subscribeBatch(uint16_t port, const SubscribeOptions& options,
+        void* context, PacketBatchHandlerFn handler) {
+    checkThread();
+
+    if (handler == nullptr) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    if (auto res = checkSubscribe(port); !res) {
+        return res.error();
+    }
+
+    ScopedFd udp_socket;
+    auto openRes = openSocket(port, options, udp_socket);
+    if (!openRes) {
+        return openRes.error();
+    }
+
+    uint16_t localPort = openRes.value();
+
+    auto statsRes = attachStats(localPort, udp_socket);
+    if (!statsRes) {
+        return statsRes.error();
+    }
+
+    auto regResult = m_loop.addSource(udp_socket, sourceEvents(), UDPBatchReceiverTag{
+        this,
+        (int)udp_socket,
+        localPort,
+        context,
+        handler,
+        statsRes.value(),
+        options.weight
+    }, options.priority);
+
+    if (!regResult) {
+        m_portStats.erase(localPort);
+        return regResult.error();
+    }
+
+    m_port_to_fd_map.emplace(localPort, std::move(udp_socket));
+
+    return {static_cast<int>(localPort)};
+}
+
+int UDPReceiver::armSlots() {
+    int armed = 0;
+    for (int k = 0; k < m_config.batchSize; ++k) {
+        uint32_t slot = m_slots[k];
+
+        // Only the last read reached the handlers, so only its slots can be leased
+        if (slot != BufferPool::NO_SLOT && k < m_slotsUsed && m_pool->refCount(slot) > 1) {
+            m_pool->release(slot);
+            slot = BufferPool::NO_SLOT;
+        }
+
+        if (slot == BufferPool::NO_SLOT) {
+            slot = m_pool->acquire();
+            if (slot == BufferPool::NO_SLOT) [[unlikely]] continue;
+        }
+
+        m_slots[armed] = slot;
+        m_ioVectors[armed].iov_base = m_pool->slotData(slot);
+        ++armed;
+    }
+
+    std::fill(m_slots.begin() + armed, m_slots.end(), BufferPool::NO_SLOT);
+    m_slotsUsed = 0;
+    return armed;
+}
+
+// NOTE: receiveBatch assumes exclusive access to m_flatBuffer.
 // If multiple threads trigger handleRead simultaneously via different
 // EventLoops, data corruption will occur.
-void UDPReceiver::handleRead(int fd, void* context, PacketHandlerFn handler) {
+int UDPReceiver::receiveBatch(int fd, uint16_t port, PortStats* stats) {
     checkThread();
 
     // Initialize m_msgHeaders to point to these control buffers
     for (int i = 0; i < m_config.batchSize; ++i) {
         m_msgHeaders[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
-        m_msgHeaders[i].msg_hdr.msg_controllen = m_controlBuffers[i].size();
+        m_msgHeaders[i].msg_hdr.msg_controllen = m_wantControl ? m_controlBuffers[i].size() : 0;
+    }
+
+    // With every pool slot leased the datagrams wait in the socket queue
+    unsigned int slots = static_cast<unsigned int>(m_config.batchSize);
+    if (m_pool) {
+        slots = static_cast<unsigned int>(armSlots());
+        if (slots == 0) [[unlikely]] {
+            m_lastRead = 0;
+            m_drained = false;
+            return 0;
+        }
     }
 
     // recvmmsg allows us to grab up to BATCH_SIZE packets in one go.
     // MSG_DONTWAIT ensures we don't block if the buffer was emptied by a race condition.
     int numPackets = recvmmsg(
-            fd, m_msgHeaders.data(), m_config.batchSize,
+            fd, m_msgHeaders.data(), slots,
             MSG_DONTWAIT, nullptr);
-    if (numPackets < 0) return;
+    if (numPackets < 0) {
+        if (stats) [[unlikely]] m_stats.batchFill[0]++;
+        m_lastRead = 0;
+        m_drained = (errno == EAGAIN || errno == EWOULDBLOCK);
+        return 0;
+    }
+    m_lastRead = numPackets;
+    m_drained = static_cast<unsigned int>(numPackets) < slots;
+
+    // One clock read per batch for the timestamp-to-dispatch latency
+    struct timespec batchTime = {0, 0};
+    if (stats) [[unlikely]] {
+        clock_gettime(CLOCK_REALTIME, &batchTime);
+        m_stats.batches++;
+        m_stats.packets += static_cast<uint64_t>(numPackets);
+        m_stats.batchFill[static_cast<size_t>(ReceiverStats::fillBucket(numPackets))]++;
+    }
+
+    m_batchSplit = false;
+    m_slotsUsed = numPackets;
+    int entries = 0;
 
     // Iterate through only the number of packets actually received
     for (int k = 0; k < numPackets; ++k) {
@@ -169,25 +336,136 @@ void UDPReceiver::handleRead(int fd, void* context, PacketHandlerFn handler) {
         }
 
         struct timespec packetTime = {0, 0};
+        struct timespec hwTime = {0, 0};
+        int gsoSize = 0;
 
-        // Extract timestamp from control messages
-        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&m_msgHeaders[k].msg_hdr);
+        // Extract timestamps (and GRO segment size) from control messages
+        for (struct cmsghdr* cmsg = m_wantControl ? CMSG_FIRSTHDR(&m_msgHeaders[k].msg_hdr) : nullptr;
              cmsg != nullptr;
              cmsg = CMSG_NXTHDR(&m_msgHeaders[k].msg_hdr, cmsg)) {
 
-            if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPNS)) {
-                packetTime = *(struct timespec*)CMSG_DATA(cmsg);
-                break;
+            if (cmsg->cmsg_level == SOL_SOCKET) {
+                if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    std::memcpy(&packetTime, CMSG_DATA(cmsg), sizeof(packetTime));
+                } else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                    // ts[0] software, ts[1] deprecated, ts[2] raw hardware
+                    struct timespec stamps[3];
+                    std::memcpy(stamps, CMSG_DATA(cmsg), sizeof(stamps));
+                    packetTime = stamps[0];
+                    if (stamps[2].tv_sec != 0 || stamps[2].tv_nsec != 0) {
+                        hwTime = stamps[2];
+                        status |= PacketStatus::HW_TIMESTAMP;
+                    }
+                } else if (cmsg->cmsg_type == SO_RXQ_OVFL && stats) {
+                    uint32_t drops;
+                    std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                    stats->kernelDrops.set(drops);
+                }
+            } else if ((cmsg->cmsg_level == SOL_UDP) && (cmsg->cmsg_type == UDP_GRO)) {
+                std::memcpy(&gsoSize, CMSG_DATA(cmsg), sizeof(gsoSize));
             }
         }
 
-        if (size_t len = m_msgHeaders[k].msg_len; len > 0) {
-            // Data is at the specific offset in the flat buffer
-            uint8_t* packetData = m_cachedBasePtr + (k * m_alignedBufferSize);
-            // Dispatch the packet to the user-defined handler
-            handler(context, packetData, len, status, packetTime);
+        const size_t len = m_msgHeaders[k].msg_len;
+
+        if (stats) [[unlikely]] {
+            stats->packets++;
+            stats->bytes += len;
+            if (status & PacketStatus::TRUNCATED) stats->truncated++;
+
+            if (packetTime.tv_sec != 0) {
+                int64_t ns = (static_cast<int64_t>(batchTime.tv_sec) - packetTime.tv_sec) * 1'000'000'000
+                    + (batchTime.tv_nsec - packetTime.tv_nsec);
+                m_stats.latency.record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+            }
         }
+
+        const uint8_t* packetData = static_cast<const uint8_t*>(m_ioVectors[k].iov_base);
+
+        // A single datagram, or one segment per gso_size bytes. The kernel may
+        // coalesce more segments than there are entries: the datagrams still to
+        // come keep one entry each, and the last entry left takes the unsplit
+        // remainder, flagged TRUNCATED
+        const size_t segment = (gsoSize > 0 && len > static_cast<size_t>(gsoSize))
+                ? static_cast<size_t>(gsoSize) : len;
+        size_t room = m_metadata.size() - static_cast<size_t>(entries) - static_cast<size_t>(numPackets - k - 1);
+        size_t offset = 0;
+        do {
+            size_t part = std::min(segment, len - offset);
+            uint32_t partStatus = status;
+            if (--room == 0 && offset + part < len) [[unlikely]] {
+                part = len - offset;
+                partStatus |= PacketStatus::TRUNCATED;
+                if (stats) stats->truncated++;
+            }
+
+            PacketMetadata& meta = m_metadata[entries++];
+            meta.ts = packetTime;
+            meta.len = part;
+            meta.destPort = port;
+            meta.status = partStatus;
+            meta.sender = &m_senderAddrs[k];
+            meta.data = packetData + offset;
+            meta.hwTs = hwTime;
+            offset += part;
+        } while (offset < len);
+
+        m_batchSplit |= (segment != len);
+    }
+
+    return entries;
+}
+
+void UDPReceiver::handleRead(int fd, void* context, PacketHandlerFn handler) {
+    handleRead(fd, context, handler, nullptr);
+}
+
+bool UDPReceiver::readAgain(int fd, int& budget, int& rounds, uint64_t epoch) noexcept {
+    // Level-triggered sockets are reported again while data is queued: only
+    // weighted subscriptions read more than once per wakeup
+    if (!m_config.edgeTriggered) [[likely]] {
+        return --rounds > 0 && m_lastRead > 0 && !m_drained && epoch == m_epoch;
+    }
+
+    // Drained, or a handler unsubscribed (possibly this very socket)
+    if (m_drained || epoch != m_epoch) return false;
+
+    if (m_lastRead > 0 && (m_config.readBudget <= 0 || (budget -= m_lastRead) > 0)) {
+        return true;
     }
+
+    // Budget spent (or no pool slot free): no new edge will come for what is
+    // already queued, so re-arm to be reported again by the next epoll_wait
+    (void)m_loop.modifySource(fd, EPOLLIN | EPOLLET);
+    return false;
+}
+
+void UDPReceiver::handleRead(int fd, void* context, PacketHandlerFn handler, PortStats* stats,
+        uint16_t weight) {
+    int budget = m_config.readBudget * weight;
+    int rounds = weight;
+    const uint64_t epoch = m_epoch;
+    do {
+        // The per-packet path does not track the port of the socket
+        int numPackets = receiveBatch(fd, 0, stats);
+
+        // Dispatch every packet to the user-defined handler
+        dispatch(numPackets, m_metadata.data(), handler, context);
+    } while (readAgain(fd, budget, rounds, epoch));
+}
+
+void UDPReceiver::handleReadBatch(int fd, uint16_t port, void* context, PacketBatchHandlerFn handler,
+        PortStats* stats, uint16_t weight) {
+    int budget = m_config.readBudget * weight;
+    int rounds = weight;
+    const uint64_t epoch = m_epoch;
+    do {
+        if (int numPackets = receiveBatch(fd, port, stats); numPackets > 0) {
+            // One indirect call for the whole batch
+            handler(context, numPackets, m_metadata.data(),
+                    (m_batchSplit || m_pool) ? nullptr : m_cachedBasePtr, m_alignedBufferSize);
+        }
+    } while (readAgain(fd, budget, rounds, epoch));
 }
 
 } // namespace atu_reactor
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/UDPSender.h>
+
+// System headers
+#include <cerrno>
+#include <cstring>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+
+// Library headers
+#include "HugePages.h"
+
+// Fallbacks for older libc headers
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef SO_TXTIME
+#define SO_TXTIME 61
+#define SCM_TXTIME SO_TXTIME
+#endif
+
+namespace atu_reactor {
+
+namespace {
+
+// Kernel limit on segments per GSO super-datagram (UDP_MAX_SEGMENTS)
+constexpr int MAX_GSO_SEGMENTS = 64;
+
+// Largest UDP payload that fits an IPv4 datagram
+constexpr size_t MAX_GSO_BYTES = 65507;
+
+} // namespace
+
+UDPSender::UDPSender(EventLoop& loopRef, SenderConfig config)
+        : m_loop(loopRef),
+        m_config(config),
+        m_gso(config.enableGso),
+        m_slots(config.ringSize),
+        m_ioVectors(config.ringSize),
+        m_msgHeaders(config.batchSize),
+        m_msgSegments(config.batchSize),
+        m_controlBuffers(config.batchSize)
+{
+    if (m_config.ringSize <= 0 || m_config.batchSize <= 0 || m_config.bufferSize <= 0) {
+        throw std::runtime_error("Invalid UDPSender configuration");
+    }
+
+    // 1. Unbound dual-stack socket, IPv4 only if IPv6 is disabled
+    m_fd.reset(::socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (m_fd < 0 && errno == EAFNOSUPPORT) {
+        m_isV6 = false;
+        m_fd.reset(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    }
+    if (m_fd < 0) {
+        throw std::runtime_error("Failed to create UDP send socket");
+    }
+
+    if (m_isV6) {
+        int off = 0;
+        ::setsockopt(m_fd, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    }
+
+    // Launch times are an optimization: without them datagrams leave on flush
+    if (m_config.enableTxTime) {
+        struct sock_txtime txtime{};
+        txtime.clockid = m_config.txClock;
+        m_txTime = ::setsockopt(m_fd, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)) == 0;
+    }
+
+    // 2. Payload ring, same layout as the PacketReceiver flat buffer
+    m_alignedBufferSize = (m_config.bufferSize + 63) & ~63;
+    m_buffer = detail::mapHugeBuffer(m_config.ringSize * m_alignedBufferSize, m_mappedSize);
+    if (m_buffer == nullptr) {
+        throw std::runtime_error("Failed to allocate send buffer via mmap");
+    }
+
+    for (int i = 0; i < m_config.ringSize; ++i) {
+        m_ioVectors[i].iov_base = m_buffer + (i * m_alignedBufferSize);
+        m_ioVectors[i].iov_len = 0;
+    }
+
+    // 3. Registered with no events: EPOLLOUT is only armed on backpressure
+    m_loop.addSource(m_fd, 0, UDPSenderTag{this, m_fd}).value();
+    m_loop.addFlushHook(this, &UDPSender::onFlushHook);
+}
+
+UDPSender::~UDPSender() {
+    m_loop.removeFlushHook(this);
+
+    // Best effort: whatever the kernel does not take now is lost
+    if (!m_blocked) {
+        (void)flush();
+    }
+
+    m_loop.removeSource(m_fd);
+
+    if (m_buffer != nullptr) {
+        ::munmap(m_buffer, m_mappedSize);
+    }
+}
+
+Result<void> UDPSender::send(const struct sockaddr* dest, socklen_t destLen,
+        const uint8_t* data, size_t len) {
+    return send(dest, destLen, data, len, 0);
+}
+
+Result<void> UDPSender::send(const struct sockaddr* dest, socklen_t destLen,
+        const uint8_t* data, size_t len, uint64_t txTimeNs) {
+    if (len > static_cast<size_t>(m_config.bufferSize)) [[unlikely]] {
+        return std::error_code(EMSGSIZE, std::system_category());
+    }
+
+    if (pending() >= static_cast<size_t>(m_config.ringSize)) [[unlikely]] {
+        return std::error_code(ENOBUFS, std::system_category());
+    }
+
+    const size_t index = m_tail % m_config.ringSize;
+    Slot& slot = m_slots[index];
+    std::memset(&slot.dest, 0, sizeof(slot.dest));
+
+    // Normalize the destination to the socket family
+    if (dest->sa_family == AF_INET && destLen >= sizeof(struct sockaddr_in)) {
+        const auto* in = reinterpret_cast<const struct sockaddr_in*>(dest);
+        if (m_isV6) {
+            // IPv4-mapped IPv6 address (::ffff:a.b.c.d)
+            slot.dest.v6.sin6_family = AF_INET6;
+            slot.dest.v6.sin6_port = in->sin_port;
+            slot.dest.v6.sin6_addr.s6_addr[10] = 0xff;
+            slot.dest.v6.sin6_addr.s6_addr[11] = 0xff;
+            std::memcpy(&slot.dest.v6.sin6_addr.s6_addr[12], &in->sin_addr, sizeof(in->sin_addr));
+            slot.destLen = sizeof(struct sockaddr_in6);
+        } else {
+            slot.dest.v4 = *in;
+            slot.destLen = sizeof(struct sockaddr_in);
+        }
+    } else if (dest->sa_family == AF_INET6 && m_isV6 && destLen >= sizeof(struct sockaddr_in6)) {
+        slot.dest.v6 = *reinterpret_cast<const struct sockaddr_in6*>(dest);
+        slot.destLen = sizeof(struct sockaddr_in6);
+    } else {
+        return std::error_code(EAFNOSUPPORT, std::system_category());
+    }
+
+    slot.txTime = m_txTime ? txTimeNs : 0;
+    std::memcpy(m_ioVectors[index].iov_base, data, len);
+    m_ioVectors[index].iov_len = len;
+    ++m_tail;
+
+    return Result<void>::success();
+}
+
+int UDPSender::buildBatch(int& segments) {
+    segments = 0;
+
+    int msgCount = 0;
+    uint64_t seq = m_head;
+
+    while (msgCount < m_config.batchSize && seq != m_tail) {
+        const size_t index = seq % m_config.ringSize;
+        const Slot& first = m_slots[index];
+        const size_t segSize = m_ioVectors[index].iov_len;
+
+        // Grow a GSO run: same destination, same size (the last may be shorter),
+        // and contiguous in m_ioVectors (no wrap-around)
+        int run = 1;
+        if (m_gso) {
+            size_t total = segSize;
+            while (run < MAX_GSO_SEGMENTS && seq + run != m_tail) {
+                const size_t next = index + run;
+                if (next >= static_cast<size_t>(m_config.ringSize)) break;
+
+                const size_t nextLen = m_ioVectors[next].iov_len;
+                if (nextLen > segSize || (total + nextLen) > MAX_GSO_BYTES) break;
+                if (m_slots[next].destLen != first.destLen ||
+                        std::memcmp(&m_slots[next].dest, &first.dest, first.destLen) != 0) break;
+                if (m_slots[next].txTime != first.txTime) break;    // One launch time per message
+
+                total += nextLen;
+                ++run;
+
+                // A shorter segment can only be the last one
+                if (nextLen < segSize) break;
+            }
+        }
+
+        struct msghdr& h = m_msgHeaders[msgCount].msg_hdr;
+        h.msg_name = const_cast<Destination*>(&first.dest);
+        h.msg_namelen = first.destLen;
+        h.msg_iov = &m_ioVectors[index];
+        h.msg_iovlen = static_cast<size_t>(run);
+        h.msg_flags = 0;
+
+        if (run > 1 || first.txTime != 0) {
+            h.msg_control = m_controlBuffers[msgCount].data();
+            h.msg_controllen = m_controlBuffers[msgCount].size();
+
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&h);
+            size_t used = 0;
+            if (run > 1) {
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const uint16_t gsoSize = static_cast<uint16_t>(segSize);
+                std::memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(gsoSize));
+                used += CMSG_SPACE(sizeof(uint16_t));
+                cmsg = reinterpret_cast<struct cmsghdr*>(m_controlBuffers[msgCount].data() + used);
+            }
+            if (first.txTime != 0) {
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_TXTIME;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+                std::memcpy(CMSG_DATA(cmsg), &first.txTime, sizeof(first.txTime));
+                used += CMSG_SPACE(sizeof(uint64_t));
+            }
+            h.msg_controllen = used;
+        } else {
+            h.msg_control = nullptr;
+            h.msg_controllen = 0;
+        }
+
+        m_msgSegments[msgCount] = run;
+        segments += run;
+        seq += run;
+        ++msgCount;
+    }
+
+    return msgCount;
+}
+
+Result<void> UDPSender::flush() {
+    // Backpressure: wait for EPOLLOUT instead of spinning on EAGAIN
+    if (m_blocked) {
+        return Result<void>::success();
+    }
+
+    std::error_code lastError;
+
+    while (m_head != m_tail) {
+        int segments = 0;
+        const int msgCount = buildBatch(segments);
+
+        int sent = ::sendmmsg(m_fd, m_msgHeaders.data(), static_cast<unsigned int>(msgCount), MSG_DONTWAIT);
+
+        if (sent < 0) [[unlikely]] {
+            if (errno == EINTR) continue;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Socket buffer full: resume when the kernel drains it
+                m_blocked = true;
+                m_loop.modifySource(m_fd, EPOLLOUT);
+                break;
+            }
+
+            if (m_msgSegments[0] > 1 && (errno == EIO || errno == EINVAL)) {
+                // Segmentation refused (device or path): fall back to plain batching
+                m_gso = false;
+                continue;
+            }
+
+            // The first message was rejected (e.g. unreachable): drop it
+            lastError = std::error_code(errno, std::system_category());
+            m_errors += static_cast<uint64_t>(m_msgSegments[0]);
+            m_head += static_cast<uint64_t>(m_msgSegments[0]);
+            continue;
+        }
+
+        for (int k = 0; k < sent; ++k) {
+            m_head += static_cast<uint64_t>(m_msgSegments[k]);
+        }
+        // A short count means the next message failed: the next round reports why
+    }
+
+    if (lastError) {
+        return lastError;
+    }
+    return Result<void>::success();
+}
+
+void UDPSender::handleWrite() {
+    m_blocked = false;
+    m_loop.modifySource(m_fd, 0);
+    (void)flush();
+}
+
+void UDPSender::onFlushHook(void* context) {
+    auto* self = static_cast<UDPSender*>(context);
+    if (self->m_head != self->m_tail) {
+        (void)self->flush();
+    }
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
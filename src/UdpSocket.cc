@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include "UdpSocket.h"
+
+// System headers
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+namespace atu_reactor::detail {
+
+namespace {
+
+// Parses an IPv4 or IPv6 literal; IPv4 is mapped (::ffff:a.b.c.d) for dual-stack sockets
+bool parseAddress(const std::string& text, bool isV6, uint16_t port, struct sockaddr_storage& out, socklen_t& len) {
+    std::memset(&out, 0, sizeof(out));
+
+    struct in_addr v4;
+    struct in6_addr v6;
+    if (::inet_pton(AF_INET, text.c_str(), &v4) == 1) {
+        if (!isV6) {
+            auto* addr = reinterpret_cast<struct sockaddr_in*>(&out);
+            addr->sin_family = AF_INET;
+            addr->sin_port = htons(port);
+            addr->sin_addr = v4;
+            len = sizeof(*addr);
+            return true;
+        }
+
+        auto* addr = reinterpret_cast<struct sockaddr_in6*>(&out);
+        addr->sin6_family = AF_INET6;
+        addr->sin6_port = htons(port);
+        addr->sin6_addr.s6_addr[10] = 0xff;
+        addr->sin6_addr.s6_addr[11] = 0xff;
+        std::memcpy(&addr->sin6_addr.s6_addr[12], &v4, sizeof(v4));
+        len = sizeof(*addr);
+        return true;
+    }
+
+    if (isV6 && ::inet_pton(AF_INET6, text.c_str(), &v6) == 1) {
+        auto* addr = reinterpret_cast<struct sockaddr_in6*>(&out);
+        addr->sin6_family = AF_INET6;
+        addr->sin6_port = htons(port);
+        addr->sin6_addr = v6;
+        len = sizeof(*addr);
+        return true;
+    }
+
+    return false;
+}
+
+// Group and source in their native family, as MCAST_JOIN_* expects
+bool parseNative(const std::string& text, struct sockaddr_storage& out) {
+    std::memset(&out, 0, sizeof(out));
+
+    if (::inet_pton(AF_INET, text.c_str(), &reinterpret_cast<struct sockaddr_in*>(&out)->sin_addr) == 1) {
+        out.ss_family = AF_INET;
+        return true;
+    }
+    if (::inet_pton(AF_INET6, text.c_str(), &reinterpret_cast<struct sockaddr_in6*>(&out)->sin6_addr) == 1) {
+        out.ss_family = AF_INET6;
+        return true;
+    }
+    return false;
+}
+
+Result<void> joinGroup(int fd, const MulticastJoin& join, uint32_t ifindex) {
+    struct sockaddr_storage group;
+    if (!parseNative(join.group, group)) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    // IPv4 memberships are handled by the IPv4 layer, even on a dual-stack socket
+    const int level = (group.ss_family == AF_INET) ? IPPROTO_IP : IPPROTO_IPV6;
+
+    if (join.source.empty()) {
+        struct group_req req{};
+        req.gr_interface = ifindex;
+        req.gr_group = group;
+        if (::setsockopt(fd, level, MCAST_JOIN_GROUP, &req, sizeof(req)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+        return Result<void>::success();
+    }
+
+    struct group_source_req req{};
+    req.gsr_interface = ifindex;
+    req.gsr_group = group;
+    if (!parseNative(join.source, req.gsr_source) || req.gsr_source.ss_family != group.ss_family) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+    if (::setsockopt(fd, level, MCAST_JOIN_SOURCE_GROUP, &req, sizeof(req)) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+    return Result<void>::success();
+}
+
+} // namespace
+
+Result<uint16_t> openUdpSocket(uint16_t port, ScopedFd& sock, const SubscribeOptions& options,
+        TimestampSource timestamps) {
+    // A zero weight would never read the socket
+    if (options.weight == 0) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    // Attempt IPv6 Dual-Stack Socket
+    int raw_fd = ::socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    bool isV6 = true;
+
+    if (raw_fd < 0 && errno == EAFNOSUPPORT) {
+        // Fallback to IPv4 if IPv6 is disabled in the kernel
+        isV6 = false;
+        raw_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    }
+
+    if (raw_fd < 0) {
+        // Here the OS will naturally return EMFILE if the real limit is hit
+        return std::error_code(errno, std::system_category());
+    }
+
+    // Immediately wrap in your ScopedFd for RAII safety
+    ScopedFd udp_socket(raw_fd);
+
+    // Reuse Address: Allows immediate restart of the application
+    if (int optval = 1; setsockopt(udp_socket, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    if (int reusePort = 1; setsockopt(udp_socket, SOL_SOCKET, SO_REUSEPORT, &reusePort, sizeof(reusePort)) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    // Only ever switched on: dropping the kernel's net-timestamp count to zero
+    // and back leaves the first datagrams unstamped while it re-enables lazily
+    if (timestamps == TimestampSource::SOFTWARE) {
+        if (int enabled = 1; setsockopt(udp_socket, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    // Before bind, so that nothing unfiltered is ever queued
+    if (!options.filter.empty()) {
+        struct sock_fprog prog{};
+        prog.len = static_cast<unsigned short>(options.filter.size());
+        prog.filter = const_cast<struct sock_filter*>(options.filter.data());
+        if (setsockopt(udp_socket, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    if (options.rcvbuf > 0) {
+        int size = options.rcvbuf;
+        int opt = options.forceRcvbuf ? SO_RCVBUFFORCE : SO_RCVBUF;
+        if (setsockopt(udp_socket, SOL_SOCKET, opt, &size, sizeof(size)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    uint32_t ifindex = 0;
+    if (!options.interface.empty()) {
+        ifindex = ::if_nametoindex(options.interface.c_str());
+        if (ifindex == 0) {
+            return std::error_code(errno, std::system_category());
+        }
+        if (setsockopt(udp_socket, SOL_SOCKET, SO_BINDTODEVICE, options.interface.c_str(),
+                    static_cast<socklen_t>(options.interface.size())) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    if (isV6) {
+        // Allow IPv4 packets on this IPv6 socket
+        int off = 0;
+        setsockopt(udp_socket, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+    }
+
+    struct sockaddr_storage bindAddr{};
+    socklen_t bindLen;
+    if (!options.bindAddress.empty()) {
+        if (!parseAddress(options.bindAddress, isV6, port, bindAddr, bindLen)) {
+            return std::error_code(EINVAL, std::system_category());
+        }
+    } else if (isV6) {
+        auto* addr6 = reinterpret_cast<struct sockaddr_in6*>(&bindAddr);
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = htons(port);
+        addr6->sin6_addr = in6addr_any;
+        bindLen = sizeof(*addr6);
+    } else {
+        auto* addr4 = reinterpret_cast<struct sockaddr_in*>(&bindAddr);
+        addr4->sin_family = AF_INET;
+        addr4->sin_port = htons(port);
+        addr4->sin_addr.s_addr = INADDR_ANY; // Listen on all available interfaces
+        bindLen = sizeof(*addr4);
+    }
+
+    if (::bind(udp_socket, reinterpret_cast<struct sockaddr*>(&bindAddr), bindLen) == -1) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    for (const auto& join : options.joins) {
+        if (auto res = joinGroup(udp_socket, join, ifindex); !res) {
+            return res.error();
+        }
+    }
+
+    // Resolve the actual port (Crucial for port 0)
+    struct sockaddr_storage ss;
+    if (socklen_t len = sizeof(ss); getsockname(udp_socket, reinterpret_cast<struct sockaddr*>(&ss), &len) == -1) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    uint16_t localPort = (ss.ss_family == AF_INET6)
+        ? ntohs(reinterpret_cast<struct sockaddr_in6*>(&ss)->sin6_port)
+        : ntohs(reinterpret_cast<struct sockaddr_in*>(&ss)->sin_port);
+
+    sock = std::move(udp_socket);
+    return localPort;
+}
+
+Result<void> configureBusyPoll(int fd, const ReceiverConfig& config) {
+    if (config.busyPollUs > 0) {
+        int usecs = config.busyPollUs;
+        if (::setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    if (config.preferBusyPoll) {
+        int on = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &on, sizeof(on)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    if (config.busyPollBudget > 0) {
+        int budget = config.busyPollBudget;
+        if (::setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget, sizeof(budget)) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    return Result<void>::success();
+}
+
+Result<void> configureTimestamps(int fd, const ReceiverConfig& config) {
+    if (config.timestamps != TimestampSource::HARDWARE) {
+        return Result<void>::success();     // openUdpSocket already did SOFTWARE
+    }
+
+    if (!config.hwTimestampInterface.empty()) {
+        struct ifreq ifr{};
+        if (config.hwTimestampInterface.size() >= sizeof(ifr.ifr_name)) {
+            return std::error_code(ENAMETOOLONG, std::system_category());
+        }
+        std::memcpy(ifr.ifr_name, config.hwTimestampInterface.c_str(), config.hwTimestampInterface.size());
+
+        struct hwtstamp_config hwConfig{};
+        hwConfig.tx_type = HWTSTAMP_TX_OFF;
+        hwConfig.rx_filter = HWTSTAMP_FILTER_ALL;
+        ifr.ifr_data = reinterpret_cast<char*>(&hwConfig);
+
+        if (::ioctl(fd, SIOCSHWTSTAMP, &ifr) < 0) {
+            return std::error_code(errno, std::system_category());
+        }
+    }
+
+    int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+        SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    return Result<void>::success();
+}
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
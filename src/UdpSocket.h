@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// System headers
+#include <cstdint>
+
+// Library headers
+#include <atu_reactor/PacketReceiver.h>
+#include <atu_reactor/Result.h>
+#include <atu_reactor/ScopedFd.h>
+#include <atu_reactor/SubscribeOptions.h>
+
+namespace atu_reactor::detail {
+
+/**
+ * @brief Creates a non-blocking dual-stack UDP socket bound to port.
+ * Falls back to IPv4 if IPv6 is disabled in the kernel. The socket has
+ * SO_REUSEADDR and SO_REUSEPORT enabled, plus SO_TIMESTAMPNS for SOFTWARE.
+ * @param sock Receives ownership of the socket on success.
+ * @param options Bind address, device, multicast joins, buffer size and filter.
+ * @param timestamps NONE and HARDWARE leave SO_TIMESTAMPNS off, so that
+ * configureTimestamps never has to toggle it.
+ * @return The local port actually bound (resolves port 0).
+ */
+Result<uint16_t> openUdpSocket(uint16_t port, ScopedFd& sock, const SubscribeOptions& options = {},
+        TimestampSource timestamps = TimestampSource::SOFTWARE);
+
+/**
+ * @brief Applies the SO_BUSY_POLL family from config; a no-op when all are off.
+ * Raising SO_BUSY_POLL above net.core.busy_read needs CAP_NET_ADMIN.
+ */
+Result<void> configureBusyPoll(int fd, const ReceiverConfig& config);
+
+/**
+ * @brief Enables SO_TIMESTAMPING when config.timestamps is HARDWARE; a no-op otherwise.
+ * HARDWARE also enables RX stamping on hwTimestampInterface through
+ * SIOCSHWTSTAMP, which needs CAP_NET_ADMIN and a capable driver.
+ */
+Result<void> configureTimestamps(int fd, const ReceiverConfig& config);
+
+} // namespace atu_reactor::detail
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
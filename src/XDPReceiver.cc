@@ -0,0 +1,556 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Own interface
+#include <atu_reactor/XDPReceiver.h>
+
+// System headers
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+#ifndef ETHERTYPE_VLAN
+#define ETHERTYPE_VLAN 0x8100
+#endif
+
+#ifndef ETHERTYPE_IPV6
+#define ETHERTYPE_IPV6 0x86dd
+#endif
+
+namespace atu_reactor {
+
+namespace {
+
+int bpfCall(int cmd, union bpf_attr& attr) {
+    return static_cast<int>(::syscall(__NR_bpf, cmd, &attr, sizeof(attr)));
+}
+
+int createMap(uint32_t type, uint32_t keySize, uint32_t valueSize, uint32_t maxEntries) {
+    union bpf_attr attr{};
+    attr.map_type = type;
+    attr.key_size = keySize;
+    attr.value_size = valueSize;
+    attr.max_entries = maxEntries;
+    return bpfCall(BPF_MAP_CREATE, attr);
+}
+
+/**
+ * @brief Minimal eBPF assembler for the built-in filter program.
+ * Jumps are emitted against labels and patched once every label is known.
+ */
+class BpfProgram {
+    public:
+        enum Label { PASS, IPV6, LOOKUP, LABEL_COUNT };
+
+        void emit(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+            struct bpf_insn insn{};
+            insn.code = code;
+            insn.dst_reg = dst & 0x0f;
+            insn.src_reg = src & 0x0f;
+            insn.off = off;
+            insn.imm = imm;
+            m_insns.push_back(insn);
+        }
+
+        void jump(uint8_t code, uint8_t dst, uint8_t src, int32_t imm, Label target) {
+            m_fixups.push_back({m_insns.size(), target});
+            emit(BPF_JMP | code, dst, src, 0, imm);
+        }
+
+        void loadMapFd(uint8_t dst, int fd) {
+            emit(BPF_LD | BPF_DW | BPF_IMM, dst, BPF_PSEUDO_MAP_FD, 0, fd);
+            emit(0, 0, 0, 0, 0);
+        }
+
+        void bind(Label label) { m_labels[label] = m_insns.size(); }
+
+        const std::vector<struct bpf_insn>& finish() {
+            for (const auto& f : m_fixups) {
+                m_insns[f.first].off = static_cast<int16_t>(m_labels[f.second] - f.first - 1);
+            }
+            return m_insns;
+        }
+
+    private:
+        std::vector<struct bpf_insn> m_insns;
+        std::vector<std::pair<size_t, Label>> m_fixups;
+        size_t m_labels[LABEL_COUNT] = {};
+};
+
+constexpr uint32_t ETH_HEADER_LEN = 14;
+
+} // namespace
+
+ReceiverConfig XDPReceiver::umemLayout(const XDPConfig& config) {
+    // The packet buffer of the base class becomes the UMEM: one slot per frame
+    ReceiverConfig layout = config;
+    layout.batchSize = static_cast<int>(config.frameCount);
+    return layout;
+}
+
+XDPReceiver::XDPReceiver(EventLoop& loopRef, XDPConfig config)
+        : PacketReceiver(loopRef, umemLayout(config)),
+        m_xdpConfig(config),
+        m_portTable(std::make_unique<Subscription[]>(65536))
+{
+    m_spareFrames.reserve(m_xdpConfig.frameCount);
+    m_recycled.reserve(m_xdpConfig.batchSize);
+}
+
+XDPReceiver::~XDPReceiver() {
+    close();
+}
+
+void XDPReceiver::close() {
+    if (m_xskFd >= 0) {
+        m_loop.removeSource(m_xskFd);
+    }
+
+    // Closing the link detaches the program from the interface
+    m_linkFd.reset();
+    m_progFd.reset();
+    m_xskMapFd.reset();
+    m_portMapFd.reset();
+
+    for (Ring* ring : {&m_fill, &m_completion, &m_rx}) {
+        if (ring->map != nullptr) {
+            ::munmap(ring->map, ring->mapSize);
+        }
+        *ring = Ring{};
+    }
+
+    m_xskFd.reset();
+    m_spareFrames.clear();
+}
+
+Result<void> XDPReceiver::mapRing(Ring& ring, size_t descSize, uint64_t pgoff,
+        const struct xdp_ring_offset& off) {
+    ring.mapSize = off.desc + m_xdpConfig.ringSize * descSize;
+    void* map = ::mmap(nullptr, ring.mapSize, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, m_xskFd, static_cast<off_t>(pgoff));
+    if (map == MAP_FAILED) {
+        ring.mapSize = 0;
+        return std::error_code(errno, std::system_category());
+    }
+
+    auto* base = static_cast<uint8_t*>(map);
+    ring.map = map;
+    ring.producer = reinterpret_cast<uint32_t*>(base + off.producer);
+    ring.consumer = reinterpret_cast<uint32_t*>(base + off.consumer);
+    ring.flags = reinterpret_cast<uint32_t*>(base + off.flags);
+    ring.descs = base + off.desc;
+    ring.mask = m_xdpConfig.ringSize - 1;
+    return Result<void>::success();
+}
+
+Result<void> XDPReceiver::open(const std::string& interface, uint32_t queueId) {
+    checkThread();
+
+    if (m_xskFd >= 0) {
+        return std::error_code(EALREADY, std::system_category());
+    }
+
+    const uint32_t frameSize = static_cast<uint32_t>(m_alignedBufferSize);
+    const uint32_t ringSize = m_xdpConfig.ringSize;
+    if ((frameSize != 2048 && frameSize != 4096) ||
+            ringSize == 0 || (ringSize & (ringSize - 1)) != 0 ||
+            m_xdpConfig.frameCount < ringSize) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    int ifindex = static_cast<int>(if_nametoindex(interface.c_str()));
+    if (ifindex == 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    m_xskFd.reset(::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0));
+    if (m_xskFd < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    auto fail = [this](int err) {
+        close();
+        return std::error_code(err, std::system_category());
+    };
+
+    // 1. Register the flat buffer as UMEM
+    struct xdp_umem_reg umem{};
+    umem.addr = reinterpret_cast<uint64_t>(m_hugeBuffer);
+    umem.len = static_cast<uint64_t>(m_xdpConfig.frameCount) * frameSize;
+    umem.chunk_size = frameSize;
+    umem.headroom = 0;
+    if (setsockopt(m_xskFd, SOL_XDP, XDP_UMEM_REG, &umem, sizeof(umem)) < 0) {
+        return fail(errno);
+    }
+
+    // 2. Size the rings. The completion ring is unused (RX only) but the
+    // kernel refuses to bind a UMEM without one.
+    for (int opt : {XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING}) {
+        if (setsockopt(m_xskFd, SOL_XDP, opt, &ringSize, sizeof(ringSize)) < 0) {
+            return fail(errno);
+        }
+    }
+
+    struct xdp_mmap_offsets off{};
+    if (socklen_t optlen = sizeof(off); getsockopt(m_xskFd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) {
+        return fail(errno);
+    }
+
+    if (auto res = mapRing(m_fill, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING, off.fr); !res) {
+        return fail(res.error().value());
+    }
+    if (auto res = mapRing(m_completion, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING, off.cr); !res) {
+        return fail(res.error().value());
+    }
+    if (auto res = mapRing(m_rx, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING, off.rx); !res) {
+        return fail(res.error().value());
+    }
+
+    // 3. Hand every frame to the kernel (or keep it aside if the fill ring is full)
+    m_spareFrames.clear();
+    for (uint32_t i = 0; i < m_xdpConfig.frameCount; ++i) {
+        m_spareFrames.push_back(static_cast<uint64_t>(i) * frameSize);
+    }
+    refill(nullptr, 0);
+
+    // 4. Bind to the queue
+    struct sockaddr_xdp sxdp{};
+    sxdp.sxdp_family = AF_XDP;
+    sxdp.sxdp_ifindex = static_cast<uint32_t>(ifindex);
+    sxdp.sxdp_queue_id = queueId;
+    sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP;
+    if (m_xdpConfig.bindMode == XDPBindMode::COPY) {
+        sxdp.sxdp_flags |= XDP_COPY;
+    } else if (m_xdpConfig.bindMode == XDPBindMode::ZEROCOPY) {
+        sxdp.sxdp_flags |= XDP_ZEROCOPY;
+    }
+
+    if (::bind(m_xskFd, reinterpret_cast<struct sockaddr*>(&sxdp), sizeof(sxdp)) < 0) {
+        return fail(errno);
+    }
+
+    // 5. Steer the subscribed ports to this socket
+    if (m_xdpConfig.attachProgram) {
+        if (auto res = loadProgram(ifindex, queueId); !res) {
+            return fail(res.error().value());
+        }
+    }
+
+    // 6. Register with the EventLoop
+    if (auto res = m_loop.addSource(m_xskFd, EPOLLIN, XDPReceiverTag{this, m_xskFd}); !res) {
+        return fail(res.error().value());
+    }
+
+    return Result<void>::success();
+}
+
+Result<void> XDPReceiver::loadProgram(int ifindex, uint32_t queueId) {
+    // Port map: key is the port as found on the wire, value is 1 when subscribed
+    m_portMapFd.reset(createMap(BPF_MAP_TYPE_ARRAY, sizeof(uint32_t), sizeof(uint8_t), 65536));
+    if (m_portMapFd < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    m_xskMapFd.reset(createMap(BPF_MAP_TYPE_XSKMAP, sizeof(uint32_t), sizeof(int),
+                std::max<uint32_t>(queueId + 1, 64)));
+    if (m_xskMapFd < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    // Ports subscribed before open()
+    for (uint32_t netPort = 0; netPort < 65536; ++netPort) {
+        if (m_portTable[netPort].handler) {
+            updatePortMap(ntohs(static_cast<uint16_t>(netPort)), true);
+        }
+    }
+
+    // Packet loads are done in host order, so compare against htons() constants.
+    // R6 = ctx, R2 = data, R3 = data_end, R5 = scratch
+    BpfProgram p;
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_X, 6, 1, 0, 0);
+    p.emit(BPF_LDX | BPF_W | BPF_MEM, 2, 6, offsetof(struct xdp_md, data), 0);
+    p.emit(BPF_LDX | BPF_W | BPF_MEM, 3, 6, offsetof(struct xdp_md, data_end), 0);
+
+    // Ethernet + IPv4 (no options) + UDP must be in the frame
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0);
+    p.emit(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, ETH_HEADER_LEN + 20 + 8);
+    p.jump(BPF_JGT | BPF_X, 4, 3, 0, BpfProgram::PASS);
+
+    p.emit(BPF_LDX | BPF_H | BPF_MEM, 5, 2, 12, 0);
+    p.jump(BPF_JEQ | BPF_K, 5, 0, htons(ETHERTYPE_IPV6), BpfProgram::IPV6);
+    p.jump(BPF_JNE | BPF_K, 5, 0, htons(ETHERTYPE_IP), BpfProgram::PASS);
+
+    // IPv4: version 4, IHL 5, not a fragment, protocol UDP
+    p.emit(BPF_LDX | BPF_B | BPF_MEM, 5, 2, ETH_HEADER_LEN, 0);
+    p.jump(BPF_JNE | BPF_K, 5, 0, 0x45, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_H | BPF_MEM, 5, 2, ETH_HEADER_LEN + 6, 0);
+    p.emit(BPF_ALU64 | BPF_AND | BPF_K, 5, 0, 0, htons(0x3fff));
+    p.jump(BPF_JNE | BPF_K, 5, 0, 0, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_B | BPF_MEM, 5, 2, ETH_HEADER_LEN + 9, 0);
+    p.jump(BPF_JNE | BPF_K, 5, 0, IPPROTO_UDP, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_H | BPF_MEM, 5, 2, ETH_HEADER_LEN + 20 + 2, 0);
+    p.jump(BPF_JA, 0, 0, 0, BpfProgram::LOOKUP);
+
+    // IPv6: UDP directly after the fixed header
+    p.bind(BpfProgram::IPV6);
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_X, 4, 2, 0, 0);
+    p.emit(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, ETH_HEADER_LEN + 40 + 8);
+    p.jump(BPF_JGT | BPF_X, 4, 3, 0, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_B | BPF_MEM, 5, 2, ETH_HEADER_LEN + 6, 0);
+    p.jump(BPF_JNE | BPF_K, 5, 0, IPPROTO_UDP, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_H | BPF_MEM, 5, 2, ETH_HEADER_LEN + 40 + 2, 0);
+
+    // Port lookup, then redirect to the socket bound to this RX queue
+    p.bind(BpfProgram::LOOKUP);
+    p.emit(BPF_STX | BPF_W | BPF_MEM, 10, 5, -4, 0);
+    p.loadMapFd(1, m_portMapFd);
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_X, 2, 10, 0, 0);
+    p.emit(BPF_ALU64 | BPF_ADD | BPF_K, 2, 0, 0, -4);
+    p.emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_map_lookup_elem);
+    p.jump(BPF_JEQ | BPF_K, 0, 0, 0, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_B | BPF_MEM, 1, 0, 0, 0);
+    p.jump(BPF_JEQ | BPF_K, 1, 0, 0, BpfProgram::PASS);
+    p.emit(BPF_LDX | BPF_W | BPF_MEM, 2, 6, offsetof(struct xdp_md, rx_queue_index), 0);
+    p.loadMapFd(1, m_xskMapFd);
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS); // Fallback if no socket
+    p.emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map);
+    p.emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+    p.bind(BpfProgram::PASS);
+    p.emit(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS);
+    p.emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+    const auto& insns = p.finish();
+    static const char license[] = "GPL";
+
+    union bpf_attr attr{};
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = reinterpret_cast<uint64_t>(insns.data());
+    attr.insn_cnt = static_cast<uint32_t>(insns.size());
+    attr.license = reinterpret_cast<uint64_t>(license);
+    m_progFd.reset(bpfCall(BPF_PROG_LOAD, attr));
+    if (m_progFd < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    // Register the socket for its queue
+    int xsk = m_xskFd;
+    attr = {};
+    attr.map_fd = static_cast<uint32_t>(m_xskMapFd.fd);
+    attr.key = reinterpret_cast<uint64_t>(&queueId);
+    attr.value = reinterpret_cast<uint64_t>(&xsk);
+    if (bpfCall(BPF_MAP_UPDATE_ELEM, attr) < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    // Attach through a BPF link so the program goes away with the receiver
+    attr = {};
+    attr.link_create.prog_fd = static_cast<uint32_t>(m_progFd.fd);
+    attr.link_create.target_ifindex = static_cast<uint32_t>(ifindex);
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = m_xdpConfig.genericXdp ? XDP_FLAGS_SKB_MODE : 0;
+    m_linkFd.reset(bpfCall(BPF_LINK_CREATE, attr));
+    if (m_linkFd < 0) {
+        return std::error_code(errno, std::system_category());
+    }
+
+    return Result<void>::success();
+}
+
+void XDPReceiver::updatePortMap(uint16_t port, bool enabled) {
+    if (m_portMapFd < 0) return;
+
+    uint32_t key = htons(port);
+    uint8_t value = enabled ? 1 : 0;
+
+    union bpf_attr attr{};
+    attr.map_fd = static_cast<uint32_t>(m_portMapFd.fd);
+    attr.key = reinterpret_cast<uint64_t>(&key);
+    attr.value = reinterpret_cast<uint64_t>(&value);
+    bpfCall(BPF_MAP_UPDATE_ELEM, attr);
+}
+
+Result<int> XDPReceiver::subscribe(uint16_t port, void* context, PacketHandlerFn handler) {
+    // Call base class for checkThread and standard bookkeeping
+    auto baseRes = PacketReceiver::subscribe(port, context, handler);
+    if (!baseRes) {
+        return baseRes;
+    }
+
+    if (port == 0) {
+        return std::error_code(EINVAL, std::system_category());
+    }
+
+    auto& sub = m_portTable[htons(port)];
+    if (sub.handler) {
+        return std::error_code(EADDRINUSE, std::system_category());
+    }
+
+    sub = {context, handler};
+    updatePortMap(port, true);
+
+    return static_cast<int>(port);
+}
+
+Result<void> XDPReceiver::unsubscribe(uint16_t port) {
+    checkThread();
+
+    auto& sub = m_portTable[htons(port)];
+    if (!sub.handler) {
+        return std::error_code(ENOENT, std::system_category());
+    }
+
+    updatePortMap(port, false);
+    sub = {};
+    return Result<void>::success();
+}
+
+void XDPReceiver::refill(const uint64_t* frames, uint32_t n) {
+    auto* addrs = static_cast<uint64_t*>(m_fill.descs);
+    uint32_t prod = *m_fill.producer;
+    uint32_t cons = __atomic_load_n(m_fill.consumer, __ATOMIC_ACQUIRE);
+    uint32_t space = m_xdpConfig.ringSize - (prod - cons);
+
+    // Recycled frames first, then any frame we kept aside
+    uint32_t i = 0;
+    for (; i < n && space > 0; ++i, --space) {
+        addrs[prod++ & m_fill.mask] = frames[i];
+    }
+    for (; i < n; ++i) {
+        m_spareFrames.push_back(frames[i]);
+    }
+    while (space > 0 && !m_spareFrames.empty()) {
+        addrs[prod++ & m_fill.mask] = m_spareFrames.back();
+        m_spareFrames.pop_back();
+        --space;
+    }
+
+    __atomic_store_n(m_fill.producer, prod, __ATOMIC_RELEASE);
+}
+
+void XDPReceiver::handleRead(int fd, void*, PacketHandlerFn) {
+    checkThread();
+
+    const uint32_t prod = __atomic_load_n(m_rx.producer, __ATOMIC_ACQUIRE);
+    const uint32_t cons = *m_rx.consumer;
+    const uint32_t n = std::min<uint32_t>(prod - cons, static_cast<uint32_t>(m_xdpConfig.batchSize));
+
+    if (n > 0) [[likely]] {
+        // AF_XDP carries no kernel timestamp: stamp the whole batch once
+        struct timespec packetTime;
+        clock_gettime(CLOCK_REALTIME, &packetTime);
+
+        const auto* descs = static_cast<const struct xdp_desc*>(m_rx.descs);
+        const uint64_t frameMask = ~static_cast<uint64_t>(m_alignedBufferSize - 1);
+        m_recycled.clear();
+
+        for (uint32_t k = 0; k < n; ++k) {
+            const struct xdp_desc& desc = descs[(cons + k) & m_rx.mask];
+            const uint8_t* frame = m_cachedBasePtr + desc.addr;
+            uint32_t remaining = desc.len;
+            m_recycled.push_back(desc.addr & frameMask);
+
+            if (k + 1 < n) {
+                __builtin_prefetch(m_cachedBasePtr + descs[(cons + k + 1) & m_rx.mask].addr, 0, 3);
+            }
+
+            // --- Layer 2 ---
+            if (remaining < ETH_HEADER_LEN) [[unlikely]] continue;
+            uint16_t proto = static_cast<uint16_t>((frame[12] << 8) | frame[13]);
+            const uint8_t* ptr = frame + ETH_HEADER_LEN;
+            remaining -= ETH_HEADER_LEN;
+
+            if (proto == ETHERTYPE_VLAN) {
+                if (remaining < 4) [[unlikely]] continue;
+                proto = static_cast<uint16_t>((ptr[2] << 8) | ptr[3]);
+                ptr += 4;
+                remaining -= 4;
+            }
+
+            // --- Layer 3 ---
+            uint32_t ipLen;
+            if (proto == ETHERTYPE_IP) [[likely]] {
+                if (remaining < 20 || ptr[9] != IPPROTO_UDP) continue;
+                // Fragments are not reassembled: MF or a fragment offset, same mask as the program
+                if ((((ptr[6] << 8) | ptr[7]) & 0x3FFF) != 0) [[unlikely]] continue;
+                ipLen = (ptr[0] & 0x0F) << 2;
+                if (ipLen < 20) [[unlikely]] continue;
+            } else if (proto == ETHERTYPE_IPV6) {
+                if (remaining < 40 || ptr[6] != IPPROTO_UDP) continue;
+                ipLen = 40;
+            } else {
+                continue;
+            }
+
+            if (remaining < ipLen + 8) [[unlikely]] continue;
+            ptr += ipLen;
+            remaining -= ipLen + 8;
+
+            // --- Layer 4 ---
+            uint16_t dstPortNet;
+            std::memcpy(&dstPortNet, ptr + 2, sizeof(dstPortNet));
+            const Subscription& sub = m_portTable[dstPortNet];
+            if (!sub.handler) [[unlikely]] continue;
+
+            uint16_t udpLen = static_cast<uint16_t>((ptr[4] << 8) | ptr[5]);
+            if (udpLen < 8) [[unlikely]] continue;
+
+            size_t payloadLen = udpLen - 8u;
+            uint32_t status = PacketStatus::OK;
+            if (payloadLen > remaining) [[unlikely]] {
+                payloadLen = remaining;
+                status |= PacketStatus::TRUNCATED;
+            }
+
+            sub.handler(sub.context, ptr + 8, payloadLen, status, packetTime);
+        }
+
+        __atomic_store_n(m_rx.consumer, cons + n, __ATOMIC_RELEASE);
+        refill(m_recycled.data(), n);
+    }
+
+    // In need-wakeup mode the driver sleeps until we kick it
+    if (__atomic_load_n(m_fill.flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP) {
+        ::recvfrom(fd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+    }
+}
+
+} // namespace atu_reactor
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/BufferPool.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t TEST_PORT = 12500;
+
+// Keeps every payload it sees without copying it
+struct Retainer {
+    BufferPool* pool = nullptr;
+    std::vector<PacketLease> leases;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec) {
+        auto* self = static_cast<Retainer*>(context);
+        self->leases.push_back(self->pool->lease(data, len));
+    }
+};
+
+} // namespace
+
+TEST(BufferPoolTest, SlotsAreAlignedAndExhaustible) {
+    BufferPool pool(4, 100);
+    EXPECT_EQ(pool.slotSize(), 128u);
+
+    std::vector<uint32_t> slots;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t slot = pool.acquire();
+        ASSERT_NE(slot, BufferPool::NO_SLOT);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.slotData(slot)) % 64, 0u);
+        EXPECT_EQ(pool.refCount(slot), 1u);
+        slots.push_back(slot);
+    }
+    EXPECT_EQ(pool.acquire(), BufferPool::NO_SLOT);
+
+    // The returned slot is found again once the free list runs dry
+    pool.release(slots[2]);
+    EXPECT_EQ(pool.acquire(), slots[2]);
+}
+
+TEST(BufferPoolTest, LeaseKeepsSlotUntilLastReference) {
+    BufferPool pool(1, 64);
+    uint32_t slot = pool.acquire();
+    uint8_t* data = pool.slotData(slot);
+    std::memcpy(data, "abc", 3);
+
+    PacketLease lease = pool.lease(data + 1, 2);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease.data(), data + 1);
+    EXPECT_EQ(lease.size(), 2u);
+
+    PacketLease copy = lease.share();
+    PacketLease moved = std::move(lease);
+    EXPECT_FALSE(lease);
+    EXPECT_EQ(pool.refCount(slot), 3u);
+
+    pool.release(slot);
+    copy.reset();
+    EXPECT_EQ(pool.acquire(), BufferPool::NO_SLOT);
+
+    moved.reset();
+    EXPECT_EQ(pool.acquire(), slot);
+
+    uint8_t outside = 0;
+    EXPECT_FALSE(pool.lease(&outside, 1));
+}
+
+// Workers drop their leases concurrently while the owner keeps acquiring
+TEST(BufferPoolTest, CrossThreadReleaseIsLockFree) {
+    constexpr int SLOTS = 64;
+    constexpr int ROUNDS = 2000;
+    BufferPool pool(SLOTS, 64);
+
+    for (int round = 0; round < ROUNDS; ++round) {
+        std::vector<PacketLease> a;
+        std::vector<PacketLease> b;
+        for (int i = 0; i < SLOTS; ++i) {
+            uint32_t slot = pool.acquire();
+            ASSERT_NE(slot, BufferPool::NO_SLOT) << "slot leaked in round " << round;
+            (i % 2 ? a : b).push_back(pool.lease(pool.slotData(slot), 1));
+            pool.release(slot);
+        }
+
+        std::thread t1([&] { a.clear(); });
+        std::thread t2([&] { b.clear(); });
+        t1.join();
+        t2.join();
+    }
+}
+
+// Retained payloads survive later reads; their slots go back once released
+TEST(BufferPoolTest, ReceiverHandsOutRetainablePayloads) {
+    EventLoop loop;
+    ReceiverConfig config;
+    config.batchSize = 4;
+    config.poolSlots = 8;
+    UDPReceiver receiver(loop, config);
+    ASSERT_NE(receiver.bufferPool(), nullptr);
+
+    Retainer retainer;
+    retainer.pool = receiver.bufferPool().get();
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &retainer, &Retainer::onPacket).has_value());
+
+    for (uint8_t i = 0; i < 6; ++i) {
+        sendLoopback(TEST_PORT, {i, i, i});
+        loop.runOnce(100);
+    }
+
+    ASSERT_EQ(retainer.leases.size(), 6u);
+    for (uint8_t i = 0; i < 6; ++i) {
+        ASSERT_TRUE(retainer.leases[i]);
+        EXPECT_EQ(retainer.leases[i].size(), 3u);
+        EXPECT_EQ(retainer.leases[i].data()[0], i) << "payload " << int(i) << " was overwritten";
+    }
+
+    // 6 leased + 2 armed: the third datagram stays queued in the socket
+    for (int v : {42, 43, 44}) sendLoopback(TEST_PORT, {static_cast<uint8_t>(v)});
+    for (int i = 0; i < 5; ++i) loop.runOnce(10);
+    ASSERT_EQ(retainer.leases.size(), 8u);
+    EXPECT_EQ(retainer.leases[7].data()[0], 43);
+
+    // Releasing from another thread makes room again
+    std::thread worker([&] { retainer.leases.clear(); });
+    worker.join();
+
+    sendLoopback(TEST_PORT, {7});
+    for (int i = 0; i < 5 && retainer.leases.size() < 2; ++i) loop.runOnce(100);
+    ASSERT_EQ(retainer.leases.size(), 2u);
+    EXPECT_EQ(retainer.leases[0].data()[0], 44);
+    EXPECT_EQ(retainer.leases[1].data()[0], 7);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/FeedArbiter.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+// Payload: 32-bit big endian sequence number, then a line tag
+std::vector<uint8_t> message(uint32_t seq, uint8_t line) {
+    return {static_cast<uint8_t>(seq >> 24), static_cast<uint8_t>(seq >> 16),
+            static_cast<uint8_t>(seq >> 8), static_cast<uint8_t>(seq), line};
+}
+
+struct Collector {
+    std::vector<uint32_t> sequences;
+    std::vector<uint8_t> lines;
+    std::vector<int> batches;
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+
+    void record(const uint8_t* data, size_t len) {
+        uint64_t seq = 0;
+        sequences.push_back(sequenceAt<uint32_t, 0>(nullptr, data, len, seq) ? static_cast<uint32_t>(seq) : 0);
+        lines.push_back(len > 4 ? data[4] : 0);
+    }
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec) {
+        static_cast<Collector*>(context)->record(data, len);
+    }
+
+    static void onBatch(void* context, int n, const PacketMetadata* meta, const uint8_t*, size_t) {
+        auto* self = static_cast<Collector*>(context);
+        self->batches.push_back(n);
+        for (int i = 0; i < n; ++i) {
+            self->record(meta[i].data, meta[i].len);
+        }
+    }
+
+    static void onGap(void* context, uint64_t first, uint64_t count) {
+        static_cast<Collector*>(context)->gaps.emplace_back(first, count);
+    }
+};
+
+// One receiver batch of messages on a line
+class Batch {
+    public:
+        Batch(const std::vector<uint32_t>& sequences, uint8_t line) {
+            for (uint32_t seq : sequences) {
+                m_payloads.push_back(message(seq, line));
+            }
+            for (const auto& p : m_payloads) {
+                PacketMetadata meta{};
+                meta.len = p.size();
+                meta.data = p.data();
+                m_meta.push_back(meta);
+            }
+        }
+
+        void feed(FeedArbiter& arbiter, int line) const {
+            FeedArbiter::onBatch(arbiter.lineContext(line), static_cast<int>(m_meta.size()), m_meta.data(), nullptr, 0);
+        }
+
+    private:
+        std::vector<std::vector<uint8_t>> m_payloads;
+        std::vector<PacketMetadata> m_meta;
+};
+
+ArbiterConfig config(uint32_t window = 64) {
+    ArbiterConfig config;
+    config.sequence = &sequenceAt<uint32_t, 0>;
+    config.window = window;
+    return config;
+}
+
+} // namespace
+
+class FeedArbiterTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            ASSERT_EQ(arbiter.addLine().value(), 0);
+            ASSERT_EQ(arbiter.addLine().value(), 1);
+            arbiter.setHandler(&out, &Collector::onPacket);
+            arbiter.setGapHandler(&out, &Collector::onGap);
+        }
+
+        FeedArbiter arbiter{config()};
+        Collector out;
+};
+
+TEST(FeedArbiterConfigTest, RejectsBadConfig) {
+    EXPECT_THROW(FeedArbiter(ArbiterConfig{}), std::invalid_argument);
+    EXPECT_THROW(FeedArbiter(config(100)), std::invalid_argument);
+    EXPECT_THROW(FeedArbiter(config(32)), std::invalid_argument);
+    EXPECT_NO_THROW(FeedArbiter(config(1024)));
+}
+
+TEST(FeedArbiterConfigTest, SequenceAtReadsByteOrder) {
+    const uint8_t data[] = {0xAA, 0x01, 0x02, 0x03, 0x04};
+    uint64_t seq = 0;
+    ASSERT_TRUE((sequenceAt<uint32_t, 1>(nullptr, data, sizeof(data), seq)));
+    EXPECT_EQ(seq, 0x01020304u);
+    ASSERT_TRUE((sequenceAt<uint16_t, 1, false>(nullptr, data, sizeof(data), seq)));
+    EXPECT_EQ(seq, 0x0201u);
+    EXPECT_FALSE((sequenceAt<uint32_t, 2>(nullptr, data, sizeof(data), seq)));
+}
+
+TEST_F(FeedArbiterTest, ForwardsFirstCopyOnly) {
+    Batch({1, 2, 3}, 'A').feed(arbiter, 0);
+    Batch({1, 2, 3, 4}, 'B').feed(arbiter, 1);
+    Batch({4, 5}, 'A').feed(arbiter, 0);
+    Batch({5}, 'B').feed(arbiter, 1);
+
+    EXPECT_EQ(out.sequences, (std::vector<uint32_t>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(out.lines, (std::vector<uint8_t>{'A', 'A', 'A', 'B', 'A'}));
+
+    const auto& stats = arbiter.stats();
+    EXPECT_EQ(stats.lines[0].packets.load(), 5u);
+    EXPECT_EQ(stats.lines[0].wins.load(), 4u);
+    EXPECT_EQ(stats.lines[0].duplicates.load(), 1u);
+    EXPECT_EQ(stats.lines[1].wins.load(), 1u);
+    EXPECT_EQ(stats.lines[1].duplicates.load(), 4u);
+    EXPECT_EQ(stats.forwarded.load(), 5u);
+    EXPECT_DOUBLE_EQ(stats.winRate(0), 0.8);
+    EXPECT_DOUBLE_EQ(stats.winRate(1), 0.2);
+    EXPECT_TRUE(out.gaps.empty());
+}
+
+TEST_F(FeedArbiterTest, SlowLineFillsHoles) {
+    Batch({10, 11, 14, 15}, 'A').feed(arbiter, 0);
+    Batch({10, 11, 12, 13, 14}, 'B').feed(arbiter, 1);
+
+    EXPECT_EQ(out.sequences, (std::vector<uint32_t>{10, 11, 14, 15, 12, 13}));
+    EXPECT_EQ(arbiter.stats().lines[1].wins.load(), 2u);
+    EXPECT_EQ(arbiter.stats().missing.load(), 0u);
+}
+
+TEST_F(FeedArbiterTest, ReportsGapsLeavingTheWindow) {
+    // 103-105 are lost on both lines
+    std::vector<uint32_t> sequences;
+    for (uint32_t seq = 100; seq < 100 + 64; ++seq) {
+        if (seq < 103 || seq > 105) sequences.push_back(seq);
+    }
+    Batch(sequences, 'A').feed(arbiter, 0);
+    EXPECT_TRUE(out.gaps.empty());  // B may still deliver them
+
+    Batch({164, 172}, 'B').feed(arbiter, 1);
+    EXPECT_EQ(out.gaps, (std::vector<std::pair<uint64_t, uint64_t>>{{103, 3}}));
+    EXPECT_EQ(arbiter.stats().missing.load(), 3u);
+    EXPECT_EQ(arbiter.stats().gaps.load(), 1u);
+
+    // Too late to be told apart from a duplicate
+    Batch({104, 107}, 'B').feed(arbiter, 1);
+    EXPECT_EQ(arbiter.stats().lines[1].stale.load(), 2u);
+    EXPECT_EQ(out.sequences.size(), sequences.size() + 2);
+}
+
+TEST_F(FeedArbiterTest, JumpPastWindowCountsSkippedNumbers) {
+    Batch({1}, 'A').feed(arbiter, 0);
+    Batch({1000}, 'A').feed(arbiter, 0);
+
+    // Numbers still in the window behind 1000 may yet arrive
+    EXPECT_EQ(arbiter.stats().missing.load(), 935u);
+    uint64_t next = 2;
+    for (const auto& [first, count] : out.gaps) {
+        EXPECT_EQ(first, next);
+        next = first + count;
+    }
+    EXPECT_EQ(next, 1000u - 64 + 1);
+
+    // Numbers before the first one are not missing
+    arbiter.reset();
+    out.gaps.clear();
+    Batch({5000}, 'A').feed(arbiter, 0);
+    Batch({4990, 5100}, 'B').feed(arbiter, 1);
+    EXPECT_EQ(out.gaps, (std::vector<std::pair<uint64_t, uint64_t>>{{5001, 36}}));
+}
+
+TEST_F(FeedArbiterTest, ForwardsUnsequencedAndRunsOfBatch) {
+    arbiter.setBatchHandler(&out, &Collector::onBatch);
+
+    Batch({1, 2}, 'A').feed(arbiter, 0);
+    Batch({1, 2, 3, 4, 5}, 'B').feed(arbiter, 1);
+    Batch({3, 6, 7, 4, 8}, 'A').feed(arbiter, 0);
+    EXPECT_EQ(out.batches, (std::vector<int>{2, 3, 2, 1}));
+    EXPECT_EQ(out.sequences, (std::vector<uint32_t>{1, 2, 3, 4, 5, 6, 7, 8}));
+
+    // A heartbeat without a sequence number goes through from every line
+    const uint8_t heartbeat[] = {0};
+    PacketMetadata meta{};
+    meta.len = sizeof(heartbeat);
+    meta.data = heartbeat;
+    FeedArbiter::onBatch(arbiter.lineContext(0), 1, &meta, nullptr, 0);
+    FeedArbiter::onBatch(arbiter.lineContext(1), 1, &meta, nullptr, 0);
+    EXPECT_EQ(arbiter.stats().unsequenced.load(), 2u);
+    EXPECT_EQ(arbiter.stats().forwarded.load(), 10u);
+}
+
+TEST(FeedArbiterUdpTest, ArbitratesTwoSockets) {
+    constexpr uint16_t LINE_A = 12900;
+    constexpr uint16_t LINE_B = 12901;
+
+    EventLoop loop;
+    UDPReceiver receiver(loop);
+    Collector out;
+    {
+        FeedArbiter arbiter(config());
+        arbiter.setHandler(&out, &Collector::onPacket);
+        for (uint16_t port : {LINE_A, LINE_B}) {
+            auto res = arbiter.addLine(receiver, port);
+            ASSERT_TRUE(res.has_value()) << res.error().message();
+        }
+        ASSERT_EQ(arbiter.addLine().value(), 2);
+        ASSERT_EQ(arbiter.addLine().value(), 3);
+        EXPECT_FALSE(arbiter.addLine().has_value());
+
+        auto send = [](uint16_t port, uint32_t seq, uint8_t line) {
+            ASSERT_TRUE(sendLoopback(port, message(seq, line)));
+        };
+        for (uint32_t seq = 1; seq <= 20; ++seq) {
+            if (seq != 7) send(LINE_A, seq, 'A');
+            send(LINE_B, seq, 'B');
+        }
+
+        for (int i = 0; i < 20 && arbiter.stats().lines[1].packets.load() < 20; ++i) {
+            ASSERT_TRUE(loop.runOnce(10).has_value());
+        }
+        EXPECT_EQ(arbiter.stats().forwarded.load(), 20u);
+        EXPECT_EQ(arbiter.stats().lines[0].wins.load() + arbiter.stats().lines[1].wins.load(), 20u);
+        EXPECT_GE(arbiter.stats().lines[1].wins.load(), 1u);    // 7 only came on B
+    }
+
+    // The arbiter gave its ports back
+    EXPECT_TRUE(receiver.subscribe(LINE_A, &out, &Collector::onPacket).has_value());
+
+    std::vector<uint32_t> expected;
+    for (uint32_t seq = 1; seq <= 20; ++seq) expected.push_back(seq);
+    std::sort(out.sequences.begin(), out.sequences.end());
+    EXPECT_EQ(out.sequences, expected);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/IoUringUDPReceiver.h>
+#include <atu_reactor/EventLoop.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+struct Collector {
+    std::vector<std::string> payloads;
+    std::vector<uint32_t> statuses;
+    struct timespec lastTs = {0, 0};
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t status, struct timespec ts) {
+        auto* self = static_cast<Collector*>(context);
+        self->payloads.emplace_back(reinterpret_cast<const char*>(data), len);
+        self->statuses.push_back(status);
+        self->lastTs = ts;
+    }
+};
+
+} // namespace
+
+class IoUringUDPReceiverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        try {
+            receiver = std::make_unique<IoUringUDPReceiver>(loop, config);
+        } catch (const std::runtime_error& e) {
+            GTEST_SKIP() << "io_uring unavailable: " << e.what();
+        }
+    }
+
+    // Run the loop until count packets arrived or the deadline expires
+    void pump(const Collector& c, size_t count) {
+        for (int i = 0; i < 20 && c.payloads.size() < count; ++i) {
+            loop.runOnce(10);
+        }
+    }
+
+    EventLoop loop;
+    IoUringConfig config;
+    std::unique_ptr<IoUringUDPReceiver> receiver;
+};
+
+TEST_F(IoUringUDPReceiverTest, ReceivesPacketWithTimestamp) {
+    Collector c;
+    auto res = receiver->subscribe(0, &c, &Collector::onPacket);
+    ASSERT_TRUE(res.has_value()) << res.error().message();
+    uint16_t port = static_cast<uint16_t>(res.value());
+
+    sendLoopback(port, "hello uring");
+    pump(c, 1);
+
+    ASSERT_EQ(c.payloads.size(), 1u);
+    EXPECT_EQ(c.payloads[0], "hello uring");
+    EXPECT_EQ(c.statuses[0], PacketStatus::OK);
+    EXPECT_GT(c.lastTs.tv_sec, 0);
+}
+
+TEST_F(IoUringUDPReceiverTest, HarvestsManyPortsFromOneRing) {
+    Collector a, b;
+    auto resA = receiver->subscribe(0, &a, &Collector::onPacket);
+    auto resB = receiver->subscribe(0, &b, &Collector::onPacket);
+    ASSERT_TRUE(resA.has_value());
+    ASSERT_TRUE(resB.has_value());
+
+    for (int i = 0; i < 10; ++i) {
+        sendLoopback(static_cast<uint16_t>(resA.value()), "A" + std::to_string(i));
+        sendLoopback(static_cast<uint16_t>(resB.value()), "B" + std::to_string(i));
+    }
+
+    for (int i = 0; i < 20 && (a.payloads.size() < 10 || b.payloads.size() < 10); ++i) {
+        loop.runOnce(10);
+    }
+
+    ASSERT_EQ(a.payloads.size(), 10u);
+    ASSERT_EQ(b.payloads.size(), 10u);
+    EXPECT_EQ(a.payloads[9], "A9");
+    EXPECT_EQ(b.payloads[0], "B0");
+}
+
+TEST_F(IoUringUDPReceiverTest, DetectsTruncatedPackets) {
+    receiver.reset();
+    config.bufferSize = 100;
+    receiver = std::make_unique<IoUringUDPReceiver>(loop, config);
+
+    Collector c;
+    auto res = receiver->subscribe(0, &c, &Collector::onPacket);
+    ASSERT_TRUE(res.has_value());
+
+    sendLoopback(static_cast<uint16_t>(res.value()), std::string(150, 'X'));
+    pump(c, 1);
+
+    ASSERT_EQ(c.payloads.size(), 1u);
+    EXPECT_EQ(c.payloads[0].size(), 100u);
+    EXPECT_TRUE(c.statuses[0] & PacketStatus::TRUNCATED);
+}
+
+TEST_F(IoUringUDPReceiverTest, UnsubscribeStopsDelivery) {
+    Collector c;
+    auto res = receiver->subscribe(0, &c, &Collector::onPacket);
+    ASSERT_TRUE(res.has_value());
+    uint16_t port = static_cast<uint16_t>(res.value());
+
+    EXPECT_TRUE(receiver->unsubscribe(port).has_value());
+    EXPECT_EQ(receiver->unsubscribe(port).error().value(), ENOENT);
+
+    sendLoopback(port, "late");
+    loop.runOnce(20);
+    EXPECT_TRUE(c.payloads.empty());
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <cstdint>
+#include <netinet/in.h>
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+// Sends one datagram to a local port over 127.0.0.1, or ::1 for AF_INET6.
+// Returns false if the host lacks the family or the datagram did not leave whole.
+inline bool sendLoopback(uint16_t port, const void* data, size_t len, int family = AF_INET) {
+    int sock = ::socket(family, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+
+    struct sockaddr_storage dest{};
+    socklen_t destLen;
+    if (family == AF_INET6) {
+        auto* sin6 = reinterpret_cast<struct sockaddr_in6*>(&dest);
+        sin6->sin6_family = AF_INET6;
+        sin6->sin6_port = htons(port);
+        inet_pton(AF_INET6, "::1", &sin6->sin6_addr);
+        destLen = sizeof(*sin6);
+    } else {
+        auto* sin = reinterpret_cast<struct sockaddr_in*>(&dest);
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &sin->sin_addr);
+        destLen = sizeof(*sin);
+    }
+
+    const ssize_t sent = ::sendto(sock, data, len, 0, reinterpret_cast<const struct sockaddr*>(&dest), destLen);
+    ::close(sock);
+    return sent == static_cast<ssize_t>(len);
+}
+
+inline bool sendLoopback(uint16_t port, const std::vector<uint8_t>& payload, int family = AF_INET) {
+    return sendLoopback(port, payload.data(), payload.size(), family);
+}
+
+inline bool sendLoopback(uint16_t port, std::string_view payload, int family = AF_INET) {
+    return sendLoopback(port, payload.data(), payload.size(), family);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
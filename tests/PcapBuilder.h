@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+
+// Writes small legacy or pcapng captures of Ethernet (optionally VLAN tagged) IPv4/IPv6 UDP frames
+class PcapBuilder {
+    public:
+        explicit PcapBuilder(bool pcapng) : m_pcapng(pcapng) {
+            if (m_pcapng) {
+                // Section header, then one Ethernet interface in microseconds
+                put32(atu_reactor::MAGIC_PCAPNG_SHB); put32(28); put32(atu_reactor::PCAPNG_BOM);
+                put16(1); put16(0); put32(0xFFFFFFFF); put32(0xFFFFFFFF); put32(28);
+                put32(atu_reactor::PCAPNG_IDB); put32(20); put16(1); put16(0); put32(65535); put32(20);
+            } else {
+                put32(atu_reactor::MAGIC_MICRO_BE); put16(2); put16(4);
+                put32(0); put32(0); put32(65535); put32(1);
+            }
+        }
+
+        // Layout of one frame: address family, VLAN tags (2 = QinQ), addresses ("" = zero),
+        // transport protocol and captured bytes (0 = the whole frame)
+        struct Frame {
+            bool ipv6 = false;
+            int vlanTags = 0;
+            std::string dst;
+            std::string src;
+            uint8_t protocol = IPPROTO_UDP;
+            uint32_t snapLen = 0;
+        };
+
+        void add(uint32_t sec, uint32_t usec, uint16_t port, const std::vector<uint8_t>& payload) {
+            add(sec, usec, port, payload, Frame{});
+        }
+
+        void add(uint32_t sec, uint32_t usec, uint16_t port, const std::vector<uint8_t>& payload,
+                const Frame& spec) {
+            std::vector<uint8_t> frame(12, 0);                  // MAC addresses
+            for (int t = 0; t < spec.vlanTags; ++t) {
+                const bool outer = spec.vlanTags == 2 && t == 0;
+                frame.push_back(outer ? 0x88 : 0x81);           // 802.1ad, then 802.1Q
+                frame.push_back(outer ? 0xa8 : 0x00);
+                frame.push_back(0x00);
+                frame.push_back(static_cast<uint8_t>(10 + t));  // VLAN id
+            }
+
+            const size_t ip = frame.size() + 2;
+            const size_t ipHeader = spec.ipv6 ? 40 : 20;
+            frame.push_back(spec.ipv6 ? 0x86 : 0x08);          // EtherType
+            frame.push_back(spec.ipv6 ? 0xdd : 0x00);
+            frame.resize(ip + ipHeader + 8, 0);
+
+            const int family = spec.ipv6 ? AF_INET6 : AF_INET;
+            const size_t srcAt = ip + (spec.ipv6 ? 8 : 12);
+            const size_t dstAt = ip + (spec.ipv6 ? 24 : 16);
+            if (!spec.src.empty()) {
+                EXPECT_EQ(inet_pton(family, spec.src.c_str(), &frame[srcAt]), 1);
+            }
+            if (!spec.dst.empty()) {
+                EXPECT_EQ(inet_pton(family, spec.dst.c_str(), &frame[dstAt]), 1);
+            }
+
+            if (spec.ipv6) {
+                frame[ip] = 0x60;                               // Version 6
+                const uint16_t plen = htons(static_cast<uint16_t>(8 + payload.size()));
+                std::memcpy(&frame[ip + 4], &plen, 2);
+                frame[ip + 6] = spec.protocol;                  // Next header
+                frame[ip + 7] = 64;
+            } else {
+                frame[ip] = 0x45;                               // Version 4, IHL 5
+                const uint16_t ipLen = htons(static_cast<uint16_t>(28 + payload.size()));
+                std::memcpy(&frame[ip + 2], &ipLen, 2);
+                frame[ip + 8] = 64;
+                frame[ip + 9] = spec.protocol;
+            }
+
+            const size_t udp = ip + ipHeader;
+            const uint16_t dport = htons(port);
+            const uint16_t udpLen = htons(static_cast<uint16_t>(8 + payload.size()));
+            std::memcpy(&frame[udp + 2], &dport, 2);
+            std::memcpy(&frame[udp + 4], &udpLen, 2);
+            frame.insert(frame.end(), payload.begin(), payload.end());
+
+            const auto len = static_cast<uint32_t>(frame.size());
+            if (spec.snapLen != 0 && spec.snapLen < len) {
+                frame.resize(spec.snapLen);
+            }
+            const auto caplen = static_cast<uint32_t>(frame.size());
+            if (m_pcapng) {
+                const uint32_t padded = (caplen + 3) & ~3u;
+                const uint64_t ts = static_cast<uint64_t>(sec) * 1000000 + usec;
+                put32(atu_reactor::PCAPNG_EPB); put32(32 + padded);
+                put32(0); put32(static_cast<uint32_t>(ts >> 32)); put32(static_cast<uint32_t>(ts));
+                put32(caplen); put32(len);
+                m_data.insert(m_data.end(), frame.begin(), frame.end());
+                m_data.resize(m_data.size() + (padded - caplen), 0);
+                put32(32 + padded);
+            } else {
+                put32(sec); put32(usec); put32(caplen); put32(len);
+                m_data.insert(m_data.end(), frame.begin(), frame.end());
+            }
+        }
+
+        std::string write(const std::string& name) const {
+            std::string path = ::testing::TempDir() + name;
+            FILE* f = std::fopen(path.c_str(), "wb");
+            EXPECT_NE(f, nullptr);
+            std::fwrite(m_data.data(), 1, m_data.size(), f);
+            std::fclose(f);
+            return path;
+        }
+
+    private:
+        void put16(uint16_t v) { append(&v, 2); }
+        void put32(uint32_t v) { append(&v, 4); }
+        void append(const void* p, size_t n) {
+            auto* b = static_cast<const uint8_t*>(p);
+            m_data.insert(m_data.end(), b, b + n);
+        }
+
+        bool m_pcapng;
+        std::vector<uint8_t> m_data;
+};
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
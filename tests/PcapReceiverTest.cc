@@ -0,0 +1,796 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/MultiPcapReceiver.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <arpa/inet.h>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "PcapBuilder.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t TEST_PORT = 12700;
+
+struct Collector {
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<struct timespec> stamps;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec ts) {
+        auto* self = static_cast<Collector*>(context);
+        self->payloads.emplace_back(data, data + len);
+        self->stamps.push_back(ts);
+    }
+};
+
+// Payload i is i+1 bytes of value i, so records of every size cross the window edges
+std::vector<uint8_t> payloadOf(int i) {
+    return std::vector<uint8_t>(static_cast<size_t>(i % 1500 + 1), static_cast<uint8_t>(i));
+}
+
+std::vector<std::vector<uint8_t>> replay(const std::string& path, PcapConfig config) {
+    EventLoop loop;
+    config.mode = ReplayMode::STEP;
+    PcapReceiver reader(loop, config);
+    EXPECT_TRUE(reader.open(path).has_value());
+
+    Collector collector;
+    EXPECT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+    while (!reader.isFinished()) reader.step();
+    return collector.payloads;
+}
+
+} // namespace
+
+class PcapStreamingTest : public ::testing::TestWithParam<bool> {};
+
+// A 4KB window slides hundreds of times; every record must come out whole
+TEST_P(PcapStreamingTest, WindowedReplayMatchesFullMapping) {
+    constexpr int COUNT = 600;
+    PcapBuilder builder(GetParam());
+    for (int i = 0; i < COUNT; ++i) {
+        builder.add(1000, static_cast<uint32_t>(i), TEST_PORT, payloadOf(i));
+    }
+    const std::string path = builder.write(GetParam() ? "stream.pcapng" : "stream.pcap");
+
+    PcapConfig streaming;
+    streaming.streamWindow = 4096;
+    auto windowed = replay(path, streaming);
+    auto full = replay(path, PcapConfig{});
+
+    ASSERT_EQ(windowed.size(), static_cast<size_t>(COUNT));
+    EXPECT_EQ(windowed, full);
+    for (int i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(windowed[i], payloadOf(i)) << "record " << i;
+    }
+    ::unlink(path.c_str());
+}
+
+TEST_P(PcapStreamingTest, RewindRemapsTheFirstWindow) {
+    PcapBuilder builder(GetParam());
+    for (int i = 0; i < 200; ++i) builder.add(1, 0, TEST_PORT, payloadOf(i));
+    const std::string path = builder.write("rewind.cap");
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    config.streamWindow = 4096;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector collector;
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+    while (!reader.isFinished()) reader.step();
+    reader.rewind();
+    while (!reader.isFinished()) reader.step();
+
+    ASSERT_EQ(collector.payloads.size(), 400u);
+    EXPECT_EQ(collector.payloads[200], payloadOf(0));
+    EXPECT_EQ(collector.payloads[399], payloadOf(199));
+    ::unlink(path.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, PcapStreamingTest, ::testing::Values(false, true),
+    [](const ::testing::TestParamInfo<bool>& param) { return param.param ? "PcapNg" : "Legacy"; });
+
+class PcapIndexTest : public ::testing::TestWithParam<bool> {
+    protected:
+        // Packet i is stamped 1000s + 10us * i, so seeking to 10us * i - 5us must land on packet i
+        std::string writeCapture(const std::string& name, int count) {
+            PcapBuilder builder(GetParam());
+            for (int i = 0; i < count; ++i) {
+                const uint32_t usec = static_cast<uint32_t>(i) * 10;
+                builder.add(1000 + usec / 1000000, usec % 1000000, TEST_PORT, payloadOf(i));
+            }
+            return builder.write(GetParam() ? name + ".pcapng" : name + ".pcap");
+        }
+
+        static struct timespec stampOf(int i, long offsetNs = 0) {
+            const long ns = static_cast<long>(i) * 10000 + offsetNs;
+            return {1000 + ns / 1000000000L, ns % 1000000000L};
+        }
+};
+
+TEST_P(PcapIndexTest, SeekLandsOnFirstPacketAtOrAfter) {
+    constexpr int COUNT = 2000;
+    const std::string path = writeCapture("seek", COUNT);
+    const std::string indexPath = path + ".idx";
+
+    for (size_t window : {size_t{0}, size_t{4096}}) {
+        EventLoop loop;
+        PcapConfig config;
+        config.mode = ReplayMode::STEP;
+        config.streamWindow = window;
+        PcapReceiver reader(loop, config);
+        ASSERT_TRUE(reader.open(path).has_value());
+        ASSERT_TRUE(reader.loadIndex(indexPath, 16).has_value());
+
+        Collector collector;
+        ASSERT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+
+        for (int target : {1537, 3, 0, 1999, 800, 16, 15}) {
+            collector.payloads.clear();
+            ASSERT_TRUE(reader.seek(stampOf(target, -5000)).has_value());
+            ASSERT_TRUE(reader.step());
+            ASSERT_EQ(collector.payloads.size(), 1u);
+            EXPECT_EQ(collector.payloads[0], payloadOf(target)) << "window " << window;
+
+            // Exact stamps match too
+            collector.payloads.clear();
+            ASSERT_TRUE(reader.seek(stampOf(target)).has_value());
+            ASSERT_TRUE(reader.step());
+            EXPECT_EQ(collector.payloads[0], payloadOf(target)) << "window " << window;
+        }
+
+        // The replay continues normally from the seek point
+        collector.payloads.clear();
+        ASSERT_TRUE(reader.seek(stampOf(1990)).has_value());
+        while (!reader.isFinished()) reader.step();
+        EXPECT_EQ(collector.payloads.size(), 10u);
+
+        auto late = reader.seek(stampOf(COUNT));
+        ASSERT_FALSE(late.has_value());
+        EXPECT_EQ(late.error().value(), ENOENT);
+        EXPECT_TRUE(reader.isFinished());
+    }
+    ::unlink(indexPath.c_str());
+    ::unlink(path.c_str());
+}
+
+TEST_P(PcapIndexTest, SeekWithoutIndexScansFromStart) {
+    const std::string path = writeCapture("noindex", 300);
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector collector;
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+    ASSERT_TRUE(reader.seek(stampOf(250, -1)).has_value());
+    ASSERT_TRUE(reader.step());
+    EXPECT_EQ(collector.payloads[0], payloadOf(250));
+    ::unlink(path.c_str());
+}
+
+// The sidecar is reused by a fresh reader (pcapng interfaces included) and
+// rebuilt once the capture changes under it
+TEST_P(PcapIndexTest, IndexFileIsReusedAndRebuiltWhenStale) {
+    std::string path = writeCapture("sidecar", 500);
+    const std::string indexPath = path + ".idx";
+    ::unlink(indexPath.c_str());
+
+    auto seekAndStep = [&](int target) {
+        EventLoop loop;
+        PcapConfig config;
+        config.mode = ReplayMode::STEP;
+        PcapReceiver reader(loop, config);
+        EXPECT_TRUE(reader.open(path).has_value());
+        EXPECT_TRUE(reader.loadIndex().has_value());
+
+        Collector collector;
+        EXPECT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+        EXPECT_TRUE(reader.seek(stampOf(target)).has_value());
+        reader.step();
+        return collector.payloads;
+    };
+
+    auto first = seekAndStep(321);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0], payloadOf(321));
+    ASSERT_EQ(::access(indexPath.c_str(), R_OK), 0);
+
+    auto again = seekAndStep(42);
+    ASSERT_EQ(again.size(), 1u);
+    EXPECT_EQ(again[0], payloadOf(42));
+
+    // A longer capture with the same name: the saved offsets no longer apply
+    path = writeCapture("sidecar", 3000);
+    auto rebuilt = seekAndStep(2500);
+    ASSERT_EQ(rebuilt.size(), 1u);
+    EXPECT_EQ(rebuilt[0], payloadOf(2500));
+
+    ::unlink(indexPath.c_str());
+    ::unlink(path.c_str());
+}
+
+// A corrupt sidecar is rebuilt instead of trusted
+TEST_P(PcapIndexTest, CorruptIndexFileIsRebuilt) {
+    const std::string path = writeCapture("corrupt", 500);
+    const std::string indexPath = path + ".idx";
+
+    // Header: magic[8], version, interval, fileSize, mtimeNs, interfaceCount...
+    // then the interfaces: linkType, reserved, tsResolutionDivisor
+    constexpr off_t INTERFACE_COUNT = 32;
+    constexpr off_t FIRST_DIVISOR = 48 + 8;
+    const uint32_t hugeCount = 0xFFFFFFFFu;
+    const uint64_t zeroDivisor = 0;
+
+    auto corrupt = [&](off_t offset, const void* value, size_t len) {
+        {
+            EventLoop loop;
+            PcapReceiver reader(loop);
+            ASSERT_TRUE(reader.open(path).has_value());
+            ASSERT_TRUE(reader.loadIndex(indexPath, 16).has_value());
+        }
+        int fd = ::open(indexPath.c_str(), O_WRONLY);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(::pwrite(fd, value, len, offset), static_cast<ssize_t>(len));
+        ::close(fd);
+    };
+
+    auto seekAndStep = [&](int target) {
+        EventLoop loop;
+        PcapConfig config;
+        config.mode = ReplayMode::STEP;
+        PcapReceiver reader(loop, config);
+        EXPECT_TRUE(reader.open(path).has_value());
+        EXPECT_TRUE(reader.loadIndex(indexPath, 16).has_value());
+
+        Collector collector;
+        EXPECT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+        EXPECT_TRUE(reader.seek(stampOf(target)).has_value());
+        reader.step();
+        return collector.payloads;
+    };
+
+    corrupt(INTERFACE_COUNT, &hugeCount, sizeof(hugeCount));
+    auto afterCount = seekAndStep(321);
+    ASSERT_EQ(afterCount.size(), 1u);
+    EXPECT_EQ(afterCount[0], payloadOf(321));
+
+    if (GetParam()) {
+        corrupt(FIRST_DIVISOR, &zeroDivisor, sizeof(zeroDivisor));
+        auto afterDivisor = seekAndStep(123);
+        ASSERT_EQ(afterDivisor.size(), 1u);
+        EXPECT_EQ(afterDivisor[0], payloadOf(123));
+    }
+    ::unlink(indexPath.c_str());
+    ::unlink(path.c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, PcapIndexTest, ::testing::Values(false, true),
+    [](const ::testing::TestParamInfo<bool>& param) { return param.param ? "PcapNg" : "Legacy"; });
+
+namespace {
+
+// Three feeds: A (legacy) on even microseconds, B (pcapng) on odd ones, C
+// (legacy) colliding with A every 10us. Payload bytes carry the feed and sequence.
+std::vector<std::string> writeFeeds(int perFeed) {
+    PcapBuilder a(false), b(true), c(false);
+    for (int i = 0; i < perFeed; ++i) {
+        const auto seq = static_cast<uint8_t>(i);
+        a.add(2000, static_cast<uint32_t>(2 * i), TEST_PORT, {'A', seq});
+        b.add(2000, static_cast<uint32_t>(2 * i + 1), TEST_PORT, {'B', seq});
+        c.add(2000, static_cast<uint32_t>(10 * i), TEST_PORT + 1, {'C', seq});
+    }
+    return {a.write("feedA.pcap"), b.write("feedB.pcapng"), c.write("feedC.pcap")};
+}
+
+void removeAll(const std::vector<std::string>& paths) {
+    for (const auto& path : paths) ::unlink(path.c_str());
+}
+
+struct MergedBatches {
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<struct timespec> stamps;
+    int calls = 0;
+
+    static void onBatch(void* context, int n, const PacketMetadata* meta, const uint8_t*, size_t) {
+        auto* self = static_cast<MergedBatches*>(context);
+        self->calls++;
+        for (int i = 0; i < n; ++i) {
+            self->payloads.emplace_back(meta[i].data, meta[i].data + meta[i].len);
+            self->stamps.push_back(meta[i].ts);
+        }
+    }
+};
+
+bool notAfter(const struct timespec& a, const struct timespec& b) {
+    return a.tv_sec < b.tv_sec || (a.tv_sec == b.tv_sec && a.tv_nsec <= b.tv_nsec);
+}
+
+} // namespace
+
+TEST(MultiPcapReceiverTest, MergesFilesByTimestamp) {
+    constexpr int PER_FEED = 200;
+    const auto paths = writeFeeds(PER_FEED);
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    MultiPcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(paths).has_value());
+    EXPECT_EQ(reader.fileCount(), 3u);
+
+    Collector ab, c;
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &ab, &Collector::onPacket).has_value());
+    ASSERT_TRUE(reader.subscribe(TEST_PORT + 1, &c, &Collector::onPacket).has_value());
+    EXPECT_FALSE(reader.subscribe(TEST_PORT, &ab, &Collector::onPacket).has_value());
+    while (!reader.isFinished()) reader.step();
+
+    // A and B interleave exactly
+    ASSERT_EQ(ab.payloads.size(), static_cast<size_t>(2 * PER_FEED));
+    for (int i = 0; i < 2 * PER_FEED; ++i) {
+        const std::vector<uint8_t> expected{static_cast<uint8_t>(i % 2 ? 'B' : 'A'), static_cast<uint8_t>(i / 2)};
+        EXPECT_EQ(ab.payloads[i], expected) << "record " << i;
+    }
+    ASSERT_EQ(c.payloads.size(), static_cast<size_t>(PER_FEED));
+    EXPECT_EQ(c.payloads.back(), (std::vector<uint8_t>{'C', PER_FEED - 1}));
+    removeAll(paths);
+}
+
+// One batch spans records from several files, in timestamp order
+TEST(MultiPcapReceiverTest, FloodBatchesStayOrderedAcrossFiles) {
+    constexpr int PER_FEED = 300;
+    const auto paths = writeFeeds(PER_FEED);
+
+    for (size_t window : {size_t{0}, size_t{4096}}) {
+        EventLoop loop;
+        PcapConfig config;
+        config.mode = ReplayMode::FLOOD;
+        config.batchSize = 16;
+        config.streamWindow = window;
+        MultiPcapReceiver reader(loop, config);
+        ASSERT_TRUE(reader.open(paths).has_value());
+
+        MergedBatches ab;
+        ASSERT_TRUE(reader.subscribeBatch(TEST_PORT, &ab, &MergedBatches::onBatch).has_value());
+        reader.start();
+        while (!reader.isFinished()) {
+            ASSERT_TRUE(loop.runOnce(0).has_value());
+        }
+
+        ASSERT_EQ(ab.payloads.size(), static_cast<size_t>(2 * PER_FEED));
+        for (size_t i = 1; i < ab.stamps.size(); ++i) {
+            EXPECT_TRUE(notAfter(ab.stamps[i - 1], ab.stamps[i])) << "record " << i;
+        }
+        EXPECT_EQ(ab.payloads[1], (std::vector<uint8_t>{'B', 0}));
+
+        // C's packets interleave but go to no handler, so A/B batches fill up
+        // (a sliding window also hands the batch over before unmapping)
+        if (window == 0) {
+            EXPECT_LE(ab.calls, 2 * PER_FEED / 16 + 1);
+        }
+    }
+    removeAll(paths);
+}
+
+TEST(MultiPcapReceiverTest, SeekAndRewindRepositionEveryFile) {
+    constexpr int PER_FEED = 400;
+    const auto paths = writeFeeds(PER_FEED);
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    MultiPcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(paths).has_value());
+    ASSERT_TRUE(reader.loadIndex(32).has_value());
+
+    Collector ab;
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &ab, &Collector::onPacket).has_value());
+
+    // 2000s + 501us: B's record 250 comes first, then A's 251
+    ASSERT_TRUE(reader.seek({2000, 501000}).has_value());
+    ASSERT_TRUE(reader.step());
+    ASSERT_TRUE(reader.step());
+    ASSERT_EQ(ab.payloads.size(), 2u);
+    EXPECT_EQ(ab.payloads[0], (std::vector<uint8_t>{'B', 250}));
+    EXPECT_EQ(ab.payloads[1], (std::vector<uint8_t>{'A', 251}));
+
+    // Past the last record of A and B only C remains
+    ab.payloads.clear();
+    ASSERT_TRUE(reader.seek({2000, 900000}).has_value());
+    while (!reader.isFinished()) reader.step();
+    EXPECT_TRUE(ab.payloads.empty());
+
+    auto late = reader.seek({2001, 0});
+    ASSERT_FALSE(late.has_value());
+    EXPECT_EQ(late.error().value(), ENOENT);
+
+    reader.rewind();
+    ASSERT_FALSE(reader.isFinished());
+    ASSERT_TRUE(reader.step());
+    EXPECT_EQ(ab.payloads[0], (std::vector<uint8_t>{'A', 0}));
+
+    for (const auto& path : paths) ::unlink((path + ".idx").c_str());
+    removeAll(paths);
+}
+
+namespace {
+
+// Per-port sequence check for the parallel FLOOD: payload byte 0 is the
+// sequence within the port. One instance per port, so no locking needed.
+struct PortOrder {
+    std::vector<int> seen;
+    std::thread::id thread;
+    bool oneThread = true;
+
+    void record(const uint8_t* data) {
+        if (seen.empty()) thread = std::this_thread::get_id();
+        oneThread = oneThread && thread == std::this_thread::get_id();
+        seen.push_back(data[0] | (data[1] << 8));
+    }
+
+    static void onPacket(void* context, const uint8_t* data, size_t, uint32_t, struct timespec) {
+        static_cast<PortOrder*>(context)->record(data);
+    }
+
+    static void onBatch(void* context, int n, const PacketMetadata* meta, const uint8_t*, size_t) {
+        for (int i = 0; i < n; ++i) static_cast<PortOrder*>(context)->record(meta[i].data);
+    }
+};
+
+} // namespace
+
+TEST(PcapParallelFloodTest, KeepsPerPortOrder) {
+    constexpr int PORTS = 6;
+    constexpr int COUNT = 3000;
+    for (bool pcapng : {false, true}) {
+        PcapBuilder builder(pcapng);
+        int next[PORTS] = {};
+        for (int i = 0; i < COUNT; ++i) {
+            const int port = (i * 7) % PORTS;
+            const int seq = next[port]++;
+            std::vector<uint8_t> payload(static_cast<size_t>(2 + i % 300), 0);
+            payload[0] = static_cast<uint8_t>(seq);
+            payload[1] = static_cast<uint8_t>(seq >> 8);
+            builder.add(3000, static_cast<uint32_t>(i), static_cast<uint16_t>(TEST_PORT + port), payload);
+        }
+        const std::string path = builder.write(pcapng ? "parallel.pcapng" : "parallel.pcap");
+
+        for (bool indexed : {false, true}) {
+            EventLoop loop;
+            PcapConfig config;
+            config.mode = ReplayMode::FLOOD;
+            config.batchSize = 8;
+            PcapReceiver reader(loop, config);
+            ASSERT_TRUE(reader.open(path).has_value());
+            if (indexed) {
+                ASSERT_TRUE(reader.loadIndex(path + ".idx", 64).has_value());
+            }
+
+            PortOrder order[PORTS];
+            for (int p = 0; p < PORTS; ++p) {
+                const auto port = static_cast<uint16_t>(TEST_PORT + p);
+                auto res = p % 2
+                    ? reader.subscribe(port, &order[p], &PortOrder::onPacket)
+                    : reader.subscribeBatch(port, &order[p], &PortOrder::onBatch);
+                ASSERT_TRUE(res.has_value());
+            }
+
+            auto delivered = reader.floodParallel(4);
+            ASSERT_TRUE(delivered.has_value());
+            EXPECT_EQ(delivered.value(), static_cast<uint64_t>(COUNT));
+            EXPECT_TRUE(reader.isFinished());
+
+            for (int p = 0; p < PORTS; ++p) {
+                ASSERT_EQ(order[p].seen.size(), static_cast<size_t>(next[p])) << "port " << p;
+                for (int k = 0; k < next[p]; ++k) {
+                    ASSERT_EQ(order[p].seen[k], k) << "port " << p << (indexed ? " indexed" : "");
+                }
+                EXPECT_TRUE(order[p].oneThread);
+            }
+        }
+        ::unlink((path + ".idx").c_str());
+        ::unlink(path.c_str());
+    }
+}
+
+TEST(PcapParallelFloodTest, PerWorkerContexts) {
+    PcapBuilder builder(false);
+    for (int i = 0; i < 400; ++i) {
+        builder.add(1, static_cast<uint32_t>(i), static_cast<uint16_t>(TEST_PORT + i % 4), {0, 0});
+    }
+    const std::string path = builder.write("parallel_ctx.pcap");
+
+    EventLoop loop;
+    PcapReceiver reader(loop);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    int unused = 0;
+    for (int p = 0; p < 4; ++p) {
+        ASSERT_TRUE(reader.subscribe(static_cast<uint16_t>(TEST_PORT + p), &unused,
+            [](void* context, const uint8_t*, size_t, uint32_t, struct timespec) {
+                ++*static_cast<int*>(context);
+            }).has_value());
+    }
+
+    int perWorker[2] = {0, 0};
+    auto delivered = reader.floodParallel(2, {&perWorker[0], &perWorker[1]});
+    ASSERT_TRUE(delivered.has_value());
+    EXPECT_EQ(unused, 0);
+    // Ports 12700 and 12702 are even: worker 0; the odd ones go to worker 1
+    EXPECT_EQ(perWorker[0], 200);
+    EXPECT_EQ(perWorker[1], 200);
+
+    EXPECT_FALSE(reader.floodParallel(3, {&unused}).has_value());
+    ::unlink(path.c_str());
+}
+
+TEST(PcapParallelFloodTest, RejectsStreamingWindow) {
+    PcapBuilder builder(false);
+    builder.add(1, 0, TEST_PORT, {1});
+    const std::string path = builder.write("parallel_stream.pcap");
+
+    EventLoop loop;
+    PcapConfig config;
+    config.streamWindow = 4096;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+    auto res = reader.floodParallel(2);
+    ASSERT_FALSE(res.has_value());
+    EXPECT_EQ(res.error().value(), EOPNOTSUPP);
+    ::unlink(path.c_str());
+}
+
+// A handler rewinding the replay restarts every file, not the heap head it came from
+TEST(MultiPcapReceiverTest, HandlerMayRewindMidStep) {
+    constexpr int PER_FEED = 50;
+    constexpr size_t REWIND_AT = 5;
+    const auto paths = writeFeeds(PER_FEED);
+
+    struct Rewinder {
+        MultiPcapReceiver* reader;
+        std::vector<std::vector<uint8_t>> payloads;
+
+        static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec) {
+            auto* self = static_cast<Rewinder*>(context);
+            self->payloads.emplace_back(data, data + len);
+            if (self->payloads.size() == REWIND_AT) self->reader->rewind();
+        }
+    };
+
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    MultiPcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(paths).has_value());
+
+    Rewinder ab{&reader, {}};
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &ab, &Rewinder::onPacket).has_value());
+    while (!reader.isFinished()) reader.step();
+
+    ASSERT_EQ(ab.payloads.size(), REWIND_AT + 2 * PER_FEED);
+    for (size_t i = 0; i < ab.payloads.size(); ++i) {
+        const size_t n = i < REWIND_AT ? i : i - REWIND_AT;
+        const std::vector<uint8_t> expected{static_cast<uint8_t>(n % 2 ? 'B' : 'A'), static_cast<uint8_t>(n / 2)};
+        EXPECT_EQ(ab.payloads[i], expected) << "record " << i;
+    }
+    removeAll(paths);
+}
+
+TEST(MultiPcapReceiverTest, OpenReportsTheFailingFile) {
+    EventLoop loop;
+    MultiPcapReceiver reader(loop);
+    auto res = reader.open({::testing::TempDir() + "no-such-capture.pcap"});
+    ASSERT_FALSE(res.has_value());
+    EXPECT_EQ(res.error().value(), ENOENT);
+    EXPECT_TRUE(reader.isFinished());
+    EXPECT_EQ(reader.fileCount(), 0u);
+}
+
+
+namespace {
+
+// Every frame shape the fast paths know, all to the same port
+std::string writeMultiGroupCapture(bool pcapng) {
+    PcapBuilder builder(pcapng);
+    uint32_t usec = 0;
+    for (int i = 0; i < 10; ++i) {
+        const auto tag = static_cast<uint8_t>(i);
+        builder.add(1, usec++, TEST_PORT, {1, tag}, {false, 0, "239.1.1.1", "10.0.0.1"});
+        builder.add(1, usec++, TEST_PORT, {2, tag}, {false, 1, "239.1.1.2", "10.0.0.1"});
+        builder.add(1, usec++, TEST_PORT, {3, tag}, {true, 0, "ff15::1", "fe80::1"});
+        builder.add(1, usec++, TEST_PORT, {4, tag}, {true, 2, "ff15::2", "fe80::1"});
+        builder.add(1, usec++, TEST_PORT, {5, tag}, {false, 2, "239.1.1.1", "10.0.0.2"});
+    }
+    return builder.write(pcapng ? "flows.pcapng" : "flows.pcap");
+}
+
+} // namespace
+
+TEST(PcapFlowTest, RoutesByAddressAcrossVlanAndIPv6) {
+    for (bool pcapng : {false, true}) {
+        const std::string path = writeMultiGroupCapture(pcapng);
+        EventLoop loop;
+        PcapConfig config;
+        config.mode = ReplayMode::STEP;
+        PcapReceiver reader(loop, config);
+        ASSERT_TRUE(reader.open(path).has_value());
+
+        Collector groupA, groupB, groupV6, publisher, rest;
+        ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "239.1.1.1", ""}, &groupA, &Collector::onPacket).has_value());
+        ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "239.1.1.2", ""}, &groupB, &Collector::onPacket).has_value());
+        ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "ff15::1", ""}, &groupV6, &Collector::onPacket).has_value());
+        // More specific than groupA for the second publisher
+        ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "239.1.1.1", "10.0.0.2"}, &publisher,
+                    &Collector::onPacket).has_value());
+        ASSERT_TRUE(reader.subscribe(TEST_PORT, &rest, &Collector::onPacket).has_value());
+
+        while (!reader.isFinished()) reader.step();
+
+        auto allKind = [](const Collector& c, uint8_t kind) {
+            for (const auto& p : c.payloads) {
+                if (p.size() != 2 || p[0] != kind) return false;
+            }
+            return c.payloads.size() == 10;
+        };
+        EXPECT_TRUE(allKind(groupA, 1));
+        EXPECT_TRUE(allKind(groupB, 2));       // 802.1Q
+        EXPECT_TRUE(allKind(groupV6, 3));      // IPv6
+        EXPECT_TRUE(allKind(rest, 4));         // QinQ IPv6, no flow for ff15::2
+        EXPECT_TRUE(allKind(publisher, 5));    // QinQ IPv4
+        ::unlink(path.c_str());
+    }
+}
+
+TEST(PcapFlowTest, SubscribeAndUnsubscribeFlows) {
+    const std::string path = writeMultiGroupCapture(false);
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::STEP;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector groupA, rest;
+    auto bad = reader.subscribeFlow({TEST_PORT, "239.1.1", ""}, &groupA, &Collector::onPacket);
+    ASSERT_FALSE(bad.has_value());
+    EXPECT_EQ(bad.error().value(), EINVAL);
+
+    ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "239.1.1.1", ""}, &groupA, &Collector::onPacket).has_value());
+    auto dup = reader.subscribeFlow({TEST_PORT, "239.1.1.1", ""}, &rest, &Collector::onPacket);
+    ASSERT_FALSE(dup.has_value());
+    EXPECT_EQ(dup.error().value(), EADDRINUSE);
+    ASSERT_TRUE(reader.subscribe(TEST_PORT, &rest, &Collector::onPacket).has_value());
+
+    // First round of five frames: kinds 1 and 5 are 239.1.1.1
+    for (int i = 0; i < 5; ++i) reader.step();
+    EXPECT_EQ(groupA.payloads.size(), 2u);
+    EXPECT_EQ(rest.payloads.size(), 3u);
+
+    // The port-wide subscription takes over the group
+    ASSERT_TRUE(reader.unsubscribeFlow({TEST_PORT, "239.1.1.1", ""}).has_value());
+    EXPECT_FALSE(reader.unsubscribeFlow({TEST_PORT, "239.1.1.1", ""}).has_value());
+    for (int i = 0; i < 5; ++i) reader.step();
+    EXPECT_EQ(groupA.payloads.size(), 2u);
+    EXPECT_EQ(rest.payloads.size(), 8u);
+
+    // unsubscribe(port) drops every flow of the port
+    ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "ff15::1", ""}, &groupA, &Collector::onPacket).has_value());
+    ASSERT_TRUE(reader.unsubscribe(TEST_PORT).has_value());
+    EXPECT_FALSE(reader.unsubscribe(TEST_PORT).has_value());
+    for (int i = 0; i < 5; ++i) reader.step();
+    EXPECT_EQ(groupA.payloads.size(), 2u);
+    EXPECT_EQ(rest.payloads.size(), 8u);
+    ::unlink(path.c_str());
+}
+
+TEST(PcapFlowTest, ParallelFloodHonoursFlows) {
+    const std::string path = writeMultiGroupCapture(true);
+    EventLoop loop;
+    PcapConfig config;
+    config.mode = ReplayMode::FLOOD;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector groupV6;
+    ASSERT_TRUE(reader.subscribeFlow({TEST_PORT, "ff15::1", ""}, &groupV6, &Collector::onPacket).has_value());
+    auto delivered = reader.floodParallel(2);
+    ASSERT_TRUE(delivered.has_value());
+    EXPECT_EQ(delivered.value(), 10u);
+    EXPECT_EQ(groupV6.payloads.size(), 10u);
+    ::unlink(path.c_str());
+}
+
+namespace {
+
+// Seven frame shapes in turn: three delivered, then TCP, another port,
+// a truncated capture and a delivered one of growing size
+std::string writeMixedCapture(bool pcapng, int count) {
+    PcapBuilder builder(pcapng);
+    for (int i = 0; i < count; ++i) {
+        const auto usec = static_cast<uint32_t>(i);
+        std::vector<uint8_t> payload{static_cast<uint8_t>(i % 7), static_cast<uint8_t>(i),
+            static_cast<uint8_t>(i >> 8)};
+        PcapBuilder::Frame frame;
+        uint16_t port = TEST_PORT;
+        switch (i % 7) {
+            case 1: frame.ipv6 = true; frame.vlanTags = 1; break;
+            case 2: frame.vlanTags = 2; break;
+            case 3: frame.protocol = IPPROTO_TCP; break;
+            case 4: port = TEST_PORT + 1; break;
+            case 5: frame.snapLen = 40; break;
+            case 6: payload.resize(static_cast<size_t>(3 + i % 200), 0xAB); break;
+            default: break;
+        }
+        builder.add(1, usec, port, payload, frame);
+    }
+    return builder.write(pcapng ? "mixed.pcapng" : "mixed.pcap");
+}
+
+} // namespace
+
+// The block FLOOD must deliver exactly what the scalar STEP path does, in order,
+// with blocks cut by window edges
+TEST(PcapFloodBlockTest, MatchesStepReplayOnMixedFrames) {
+    constexpr int COUNT = 701;
+    for (bool pcapng : {false, true}) {
+        const std::string path = writeMixedCapture(pcapng, COUNT);
+        const auto expected = replay(path, PcapConfig{});
+        ASSERT_EQ(expected.size(), static_cast<size_t>(COUNT / 7 * 4 + 1));
+
+        for (size_t window : {size_t{0}, size_t{4096}}) {
+            EventLoop loop;
+            PcapConfig config;
+            config.mode = ReplayMode::FLOOD;
+            config.streamWindow = window;
+            PcapReceiver reader(loop, config);
+            ASSERT_TRUE(reader.open(path).has_value());
+
+            Collector collector;
+            ASSERT_TRUE(reader.subscribe(TEST_PORT, &collector, &Collector::onPacket).has_value());
+            reader.start();
+            while (!reader.isFinished()) {
+                ASSERT_TRUE(loop.runOnce(0).has_value());
+            }
+            EXPECT_EQ(collector.payloads, expected) << (pcapng ? "pcapng" : "pcap") << " window " << window;
+        }
+        ::unlink(path.c_str());
+    }
+}
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
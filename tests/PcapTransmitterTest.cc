@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <atu_reactor/PcapTransmitter.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <arpa/inet.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "PcapBuilder.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t CAPTURE_PORT = 12800;
+
+struct Collector {
+    std::vector<std::vector<uint8_t>> payloads;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec) {
+        static_cast<Collector*>(context)->payloads.emplace_back(data, data + len);
+    }
+};
+
+std::vector<uint8_t> payloadOf(int i) {
+    return std::vector<uint8_t>(static_cast<size_t>(i % 200 + 1), static_cast<uint8_t>(i));
+}
+
+} // namespace
+
+class PcapTransmitterTest : public ::testing::Test {
+    protected:
+        // Captured on CAPTURE_PORT and CAPTURE_PORT + 1, gapUs apart
+        std::string writeCapture(const std::string& name, int count, uint32_t gapUs) {
+            PcapBuilder builder(false);
+            for (int i = 0; i < count; ++i) {
+                const uint32_t usec = static_cast<uint32_t>(i) * gapUs;
+                builder.add(100 + usec / 1000000, usec % 1000000,
+                        static_cast<uint16_t>(CAPTURE_PORT + i % 2), payloadOf(i));
+            }
+            return builder.write(name);
+        }
+
+        // Local socket standing in for the wire
+        struct sockaddr_in listen(Collector& collector) {
+            auto res = receiver.subscribe(0, &collector, &Collector::onPacket);
+            EXPECT_TRUE(res.has_value());
+            struct sockaddr_in dest{};
+            dest.sin_family = AF_INET;
+            dest.sin_port = htons(static_cast<uint16_t>(res.value()));
+            inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+            return dest;
+        }
+
+        void replay(PcapReceiver& reader, const Collector& a, const Collector& b, size_t expected) {
+            reader.start();
+            for (int i = 0; i < 2000 && !reader.isFinished(); ++i) {
+                ASSERT_TRUE(loop.runOnce(1).has_value());
+            }
+            for (int i = 0; i < 50 && a.payloads.size() + b.payloads.size() < expected; ++i) {
+                ASSERT_TRUE(loop.runOnce(10).has_value());
+            }
+        }
+
+        EventLoop loop;
+        UDPReceiver receiver{loop};
+};
+
+// Both capture ports are rewritten to their own local destination
+TEST_F(PcapTransmitterTest, TimedReplayReachesTheWire) {
+    constexpr int COUNT = 40;
+    const std::string path = writeCapture("transmit_timed.pcap", COUNT, 500);
+
+    PcapConfig config;
+    config.mode = ReplayMode::TIMED;
+    config.batchSize = 8;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector even, odd;
+    auto evenDest = listen(even);
+    auto oddDest = listen(odd);
+
+    PcapTransmitter transmitter(loop, reader);
+    ASSERT_TRUE(transmitter.route(CAPTURE_PORT, reinterpret_cast<const sockaddr*>(&evenDest), sizeof(evenDest)).has_value());
+    ASSERT_TRUE(transmitter.route(CAPTURE_PORT + 1, reinterpret_cast<const sockaddr*>(&oddDest), sizeof(oddDest)).has_value());
+    EXPECT_FALSE(transmitter.route(CAPTURE_PORT, reinterpret_cast<const sockaddr*>(&evenDest), sizeof(evenDest)).has_value());
+
+    replay(reader, even, odd, COUNT);
+
+    ASSERT_EQ(even.payloads.size(), static_cast<size_t>(COUNT / 2));
+    ASSERT_EQ(odd.payloads.size(), static_cast<size_t>(COUNT / 2));
+    for (int i = 0; i < COUNT / 2; ++i) {
+        EXPECT_EQ(even.payloads[i], payloadOf(2 * i));
+        EXPECT_EQ(odd.payloads[i], payloadOf(2 * i + 1));
+    }
+
+    const auto& stats = transmitter.stats();
+    EXPECT_EQ(stats.packets.load(), static_cast<uint64_t>(COUNT));
+    EXPECT_EQ(stats.dropped.load(), 0u);
+    EXPECT_EQ(stats.lateness.count(), static_cast<uint64_t>(COUNT));
+
+    // 39 gaps of 500us: the capture asks for 2000 packets/s
+    EXPECT_NEAR(stats.targetRate(), 2000.0, 1.0);
+    EXPECT_GT(stats.achievedRate(), 0.0);
+    EXPECT_LT(stats.achievedRate(), 2000.0 * 1.5);
+    ::unlink(path.c_str());
+}
+
+TEST_F(PcapTransmitterTest, FloodHasNoTargetRate) {
+    constexpr int COUNT = 3000;
+    const std::string path = writeCapture("transmit_flood.pcap", COUNT, 1000);
+
+    PcapConfig config;
+    config.mode = ReplayMode::FLOOD;
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector even, odd;
+    auto evenDest = listen(even);
+
+    // A small ring forces flushes from inside the batch
+    SenderConfig senderConfig;
+    senderConfig.ringSize = 64;
+    PcapTransmitter transmitter(loop, reader, senderConfig);
+    ASSERT_TRUE(transmitter.route(CAPTURE_PORT, reinterpret_cast<const sockaddr*>(&evenDest), sizeof(evenDest)).has_value());
+
+    replay(reader, even, odd, 1);
+
+    // The local receiver overflows; what counts is that the sender kept up
+    const auto& stats = transmitter.stats();
+    EXPECT_EQ(stats.packets.load() + stats.dropped.load(), static_cast<uint64_t>(COUNT / 2));
+    EXPECT_GT(stats.packets.load(), 64u);
+    EXPECT_GT(even.payloads.size(), 0u);
+    EXPECT_EQ(stats.targetRate(), 0.0);
+    EXPECT_EQ(stats.lateness.count(), 0u);
+
+    ASSERT_TRUE(transmitter.unroute(CAPTURE_PORT).has_value());
+    EXPECT_FALSE(transmitter.unroute(CAPTURE_PORT).has_value());
+    ::unlink(path.c_str());
+}
+
+// With a dispatch lead and launch times, packets are handed over early but
+// the gaps are kept by the kernel (or by the loop when SO_TXTIME is refused)
+TEST_F(PcapTransmitterTest, DispatchLeadWithTxTime) {
+    constexpr int COUNT = 10;
+    const std::string path = writeCapture("transmit_txtime.pcap", COUNT, 2000);
+
+    PcapConfig config;
+    config.mode = ReplayMode::TIMED;
+    config.dispatchLead = std::chrono::microseconds(500);
+    PcapReceiver reader(loop, config);
+    ASSERT_TRUE(reader.open(path).has_value());
+
+    Collector even, odd;
+    auto evenDest = listen(even);
+    auto oddDest = listen(odd);
+
+    SenderConfig senderConfig;
+    senderConfig.enableTxTime = true;
+    PcapTransmitter transmitter(loop, reader, senderConfig);
+    ASSERT_TRUE(transmitter.route(CAPTURE_PORT, reinterpret_cast<const sockaddr*>(&evenDest), sizeof(evenDest)).has_value());
+    ASSERT_TRUE(transmitter.route(CAPTURE_PORT + 1, reinterpret_cast<const sockaddr*>(&oddDest), sizeof(oddDest)).has_value());
+
+    replay(reader, even, odd, COUNT);
+    EXPECT_EQ(even.payloads.size() + odd.payloads.size(), static_cast<size_t>(COUNT));
+    EXPECT_EQ(transmitter.stats().packets.load(), static_cast<uint64_t>(COUNT));
+
+    // Handed over before their play time: nothing counts as late
+    EXPECT_LT(transmitter.stats().lateness.quantile(0.5), 500000u);
+    ::unlink(path.c_str());
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
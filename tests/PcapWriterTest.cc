@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/PcapReceiver.h>
+#include <atu_reactor/PcapWriter.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <ctime>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+struct Seen {
+    std::vector<std::vector<uint8_t>> payloads;
+    std::vector<int64_t> stamps;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec ts) {
+        auto* self = static_cast<Seen*>(context);
+        self->payloads.emplace_back(data, data + len);
+        self->stamps.push_back(static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec);
+    }
+
+    static void onBatch(void* context, int count, const PacketMetadata* packets, const uint8_t*, size_t) {
+        for (int i = 0; i < count; ++i) {
+            onPacket(context, packets[i].data, packets[i].len, packets[i].status, packets[i].ts);
+        }
+    }
+};
+
+std::vector<uint8_t> payloadOf(int i) {
+    return std::vector<uint8_t>(static_cast<size_t>(i * 7 % 300 + 1), static_cast<uint8_t>(i));
+}
+
+} // namespace
+
+class PcapWriterTest : public ::testing::Test {
+    protected:
+        void sendTo(uint16_t port, const std::vector<uint8_t>& payload) {
+            ASSERT_TRUE(sendLoopback(port, payload));
+        }
+
+        void pumpUntil(const Seen& seen, size_t expected) {
+            for (int i = 0; i < 200 && seen.payloads.size() < expected; ++i) {
+                ASSERT_TRUE(loop.runOnce(10).has_value());
+            }
+        }
+
+        Seen replay(const std::string& path, uint16_t port) {
+            Seen seen;
+            PcapConfig config;
+            config.mode = ReplayMode::FLOOD;
+            PcapReceiver reader(loop, config);
+            EXPECT_TRUE(reader.open(path).has_value());
+            EXPECT_TRUE(reader.subscribe(port, &seen, &Seen::onPacket).has_value());
+            reader.start();
+            for (int i = 0; i < 1000 && !reader.isFinished(); ++i) {
+                EXPECT_TRUE(loop.runOnce(1).has_value());
+            }
+            return seen;
+        }
+
+        EventLoop loop;
+        UDPReceiver receiver{loop};
+};
+
+// What the handler saw is what PcapReceiver replays, with its kernel stamps
+TEST_F(PcapWriterTest, RecordedTrafficReplays) {
+    constexpr int COUNT = 64;
+    const std::string path = "writer_replay.pcapng";
+
+    Seen live;
+    uint16_t port = 0;
+    {
+        PcapWriter writer(loop, path);
+        auto res = writer.tap(receiver, 0, &live, &Seen::onPacket);
+        ASSERT_TRUE(res.has_value());
+        port = static_cast<uint16_t>(res.value());
+
+        for (int i = 0; i < COUNT; ++i) {
+            sendTo(port, payloadOf(i));
+        }
+        pumpUntil(live, COUNT);
+        ASSERT_EQ(live.payloads.size(), static_cast<size_t>(COUNT));
+        EXPECT_EQ(writer.stats().staged.load(), static_cast<uint64_t>(COUNT));
+        EXPECT_EQ(writer.stats().dropped.load(), 0u);
+    }
+
+    Seen replayed = replay(path, port);
+    ASSERT_EQ(replayed.payloads.size(), static_cast<size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) {
+        EXPECT_EQ(replayed.payloads[i], payloadOf(i));
+        EXPECT_GT(live.stamps[i], 0);
+        EXPECT_EQ(replayed.stamps[i], live.stamps[i]);
+    }
+    ::unlink(path.c_str());
+}
+
+// Datagrams from IPv6 senders are recorded as IPv6 frames and replayed too
+TEST_F(PcapWriterTest, RecordedIpv6TrafficReplays) {
+    const std::string path = "writer_replay6.pcapng";
+
+    Seen live;
+    uint16_t port = 0;
+    {
+        PcapWriter writer(loop, path);
+        auto res = writer.tap(receiver, 0, &live, &Seen::onPacket);
+        ASSERT_TRUE(res.has_value());
+        port = static_cast<uint16_t>(res.value());
+
+        if (!sendLoopback(port, payloadOf(0), AF_INET6)) GTEST_SKIP() << "No IPv6 on this host";
+        for (int i = 1; i < 8; ++i) {
+            ASSERT_TRUE(sendLoopback(port, payloadOf(i), AF_INET6));
+        }
+        pumpUntil(live, 8);
+        if (live.payloads.empty()) GTEST_SKIP() << "No IPv6 loopback";
+        ASSERT_EQ(live.payloads.size(), 8u);
+    }
+
+    Seen replayed = replay(path, port);
+    EXPECT_EQ(replayed.payloads, live.payloads);
+    EXPECT_EQ(replayed.stamps, live.stamps);
+    ::unlink(path.c_str());
+}
+
+// flush() hands a partial half over while the writer stays open
+TEST_F(PcapWriterTest, FlushWritesWhileRecording) {
+    const std::string path = "writer_flush.pcapng";
+    WriterConfig config;
+    config.flushInterval = Duration(0);
+    PcapWriter writer(loop, path, config);
+
+    Seen live;
+    auto res = writer.tapBatch(receiver, 0, &live, &Seen::onBatch);
+    ASSERT_TRUE(res.has_value());
+    const auto port = static_cast<uint16_t>(res.value());
+
+    for (int i = 0; i < 10; ++i) {
+        sendTo(port, payloadOf(i));
+    }
+    pumpUntil(live, 10);
+    ASSERT_EQ(live.payloads.size(), 10u);
+
+    writer.flush();
+    for (int i = 0; i < 200 && writer.stats().written.load() < 10; ++i) {
+        ::usleep(1000);
+    }
+    EXPECT_EQ(writer.stats().written.load(), 10u);
+    EXPECT_EQ(writer.stats().writeErrors.load(), 0u);
+
+    Seen replayed = replay(path, port);
+    ASSERT_EQ(replayed.payloads.size(), 10u);
+    EXPECT_EQ(replayed.payloads[9], payloadOf(9));
+
+    ASSERT_TRUE(writer.untap(receiver, port).has_value());
+    EXPECT_FALSE(writer.untap(receiver, port).has_value());
+    ::unlink(path.c_str());
+}
+
+// Staging never blocks: what does not fit a free half is counted and dropped
+TEST_F(PcapWriterTest, OversizedAndOverflowingRecordsAreDropped) {
+    const std::string path = "writer_drop.pcapng";
+    constexpr int COUNT = 5000;
+    std::vector<uint8_t> payload(1000, 0xAB);
+    std::vector<uint8_t> huge(8192, 0xCD);
+
+    WriterConfig config;
+    config.stagingBytes = 4096;
+    config.flushInterval = Duration(0);
+    {
+        PcapWriter writer(loop, path, config);
+
+        PacketMetadata meta{};
+        meta.destPort = 14000;
+        meta.data = huge.data();
+        meta.len = huge.size();
+        writer.record(1, &meta);
+        EXPECT_EQ(writer.stats().staged.load(), 0u);
+        EXPECT_EQ(writer.stats().dropped.load(), 1u);
+
+        // Stamped at dispatch time: the metadata carries no timestamp
+        meta.data = payload.data();
+        meta.len = payload.size();
+        for (int i = 0; i < COUNT; ++i) {
+            writer.record(1, &meta);
+        }
+        EXPECT_EQ(writer.stats().staged.load() + writer.stats().dropped.load(),
+                static_cast<uint64_t>(COUNT + 1));
+    }
+
+    Seen replayed = replay(path, 14000);
+    EXPECT_GT(replayed.payloads.size(), 0u);
+    EXPECT_LE(replayed.payloads.size(), static_cast<size_t>(COUNT));
+    struct timespec now;
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    for (size_t i = 0; i < replayed.payloads.size(); ++i) {
+        EXPECT_EQ(replayed.payloads[i], payload);
+        EXPECT_GT(replayed.stamps[i], 0);
+        EXPECT_LE(replayed.stamps[i], static_cast<int64_t>(now.tv_sec) * 1000000000LL + now.tv_nsec);
+    }
+    ::unlink(path.c_str());
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/ReactorGroup.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t TEST_PORT = 12400;
+
+struct ShardCounters {
+    std::array<std::atomic<int>, 8> perShard{};
+
+    static void onPacket(void* context, const uint8_t*, size_t, uint32_t, struct timespec) {
+        auto* self = static_cast<ShardCounters*>(context);
+        self->perShard[static_cast<size_t>(ReactorGroup::currentShard())]++;
+    }
+
+    int total() const {
+        int sum = 0;
+        for (const auto& c : perShard) sum += c.load();
+        return sum;
+    }
+};
+
+// Every datagram from a fresh socket, i.e. a different flow
+void sendFlows(int count, uint16_t port) {
+    struct sockaddr_in destAddr{};
+    destAddr.sin_family = AF_INET;
+    destAddr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &destAddr.sin_addr);
+
+    for (int i = 0; i < count; ++i) {
+        int sock = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_GE(sock, 0);
+        std::string msg = "flow " + std::to_string(i);
+        sendto(sock, msg.data(), msg.size(), 0,
+               reinterpret_cast<struct sockaddr*>(&destAddr), sizeof(destAddr));
+        close(sock);
+    }
+}
+
+void waitFor(const ShardCounters& counters, int expected) {
+    for (int i = 0; i < 100 && counters.total() < expected; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+// CPU the calling thread is allowed to run on
+int firstAllowedCpu() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) return cpu;
+    }
+    return 0;
+}
+
+} // namespace
+
+TEST(ReactorGroupTest, RejectsSubscriptionsItCannotShard) {
+    ReactorGroupConfig config;
+    config.cpus = {firstAllowedCpu()};
+    ReactorGroup group(config);
+    ShardCounters counters;
+
+    auto zero = group.subscribe(0, &counters, &ShardCounters::onPacket);
+    ASSERT_FALSE(zero.has_value());
+    EXPECT_EQ(zero.error().value(), EINVAL);
+
+    ASSERT_TRUE(group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket).has_value());
+    auto dup = group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket);
+    ASSERT_FALSE(dup.has_value());
+    EXPECT_EQ(dup.error().value(), EADDRINUSE);
+
+    ASSERT_TRUE(group.start().has_value());
+    group.stop();
+    auto late = group.subscribe(TEST_PORT + 1, &counters, &ShardCounters::onPacket);
+    ASSERT_FALSE(late.has_value());
+    EXPECT_EQ(late.error().value(), EBUSY);
+}
+
+// Subscriptions made while running are applied on each shard thread,
+// steered like the initial ones, and stop() does not wait for the poll timeout
+TEST(ReactorGroupTest, RuntimeSubscribeAndPromptStop) {
+    const int cpu = firstAllowedCpu();
+
+    ReactorGroupConfig config;
+    config.cpus = {cpu, cpu};
+    config.pollTimeoutMs = 10000;
+    ReactorGroup group(config);
+    ShardCounters counters;
+
+    ASSERT_TRUE(group.start().has_value());
+    ASSERT_TRUE(group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket).has_value());
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    cpu_set_t previous;
+    sched_getaffinity(0, sizeof(previous), &previous);
+    sched_setaffinity(0, sizeof(set), &set);
+
+    sendFlows(20, TEST_PORT);
+    sched_setaffinity(0, sizeof(previous), &previous);
+
+    waitFor(counters, 20);
+    EXPECT_EQ(counters.perShard[0].load(), 20);
+
+    ASSERT_TRUE(group.unsubscribe(TEST_PORT).has_value());
+    EXPECT_FALSE(group.unsubscribe(TEST_PORT).has_value());
+
+    // The port can be taken again once every shard closed its socket
+    ASSERT_TRUE(group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket).has_value());
+
+    auto start = std::chrono::steady_clock::now();
+    group.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+// Loopback traffic is processed on the sending CPU: it must land on the
+// first shard pinned to that CPU, whatever the flow hash says.
+TEST(ReactorGroupTest, SteersFlowsToShardOfIncomingCpu) {
+    const int cpu = firstAllowedCpu();
+
+    ReactorGroupConfig config;
+    config.cpus = {cpu, cpu};
+    ReactorGroup group(config);
+    ShardCounters counters;
+
+    ASSERT_TRUE(group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket).has_value());
+    ASSERT_TRUE(group.start().has_value());
+    EXPECT_EQ(group.size(), 2u);
+
+    // Send from the same CPU
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    cpu_set_t previous;
+    sched_getaffinity(0, sizeof(previous), &previous);
+    sched_setaffinity(0, sizeof(set), &set);
+
+    sendFlows(50, TEST_PORT);
+    sched_setaffinity(0, sizeof(previous), &previous);
+
+    waitFor(counters, 50);
+    group.stop();
+
+    EXPECT_EQ(counters.total(), 50);
+    EXPECT_EQ(counters.perShard[0].load(), 50);
+    EXPECT_EQ(counters.perShard[1].load(), 0);
+}
+
+TEST(ReactorGroupTest, HashingWithoutSteeringLosesNothing) {
+    const int cpu = firstAllowedCpu();
+
+    ReactorGroupConfig config;
+    config.cpus = {cpu, cpu, cpu};
+    config.steerByCpu = false;
+    ReactorGroup group(config);
+    ShardCounters counters;
+
+    ASSERT_TRUE(group.subscribe(TEST_PORT, &counters, &ShardCounters::onPacket).has_value());
+    ASSERT_TRUE(group.start().has_value());
+
+    sendFlows(60, TEST_PORT);
+    waitFor(counters, 60);
+    group.stop();
+
+    EXPECT_EQ(counters.total(), 60);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
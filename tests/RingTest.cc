@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/PacketRing.h>
+#include <atu_reactor/Ring.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t TEST_PORT = 12600;
+
+} // namespace
+
+TEST(SpscRingTest, CapacityIsPowerOfTwoAndBounded) {
+    SpscRing<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+
+    int items[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(ring.pushBatch(items, 10), 8u);
+    EXPECT_FALSE(ring.tryPush(10));
+    EXPECT_EQ(ring.sizeApprox(), 8u);
+
+    int out[4];
+    EXPECT_EQ(ring.popBatch(out, 4), 4u);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[3], 3);
+
+    // Wraps around the end of the storage
+    EXPECT_EQ(ring.pushBatch(items, 4), 4u);
+    int value = -1;
+    for (int expected : {4, 5, 6, 7, 0, 1, 2, 3}) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST(SpscRingTest, PreservesOrderAcrossThreads) {
+    constexpr uint64_t COUNT = 50000;
+    SpscRing<uint64_t> ring(256);
+
+    std::thread producer([&] {
+        uint64_t next = 0;
+        while (next < COUNT) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(16, COUNT - next));
+            size_t pushed = ring.produce(n, [next](uint64_t& item, size_t i) { item = next + i; });
+            if (pushed == 0) std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < COUNT) {
+        if (ring.consume(32, [&](uint64_t& item) { ordered &= (item == expected++); }) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(ring.sizeApprox(), 0u);
+}
+
+TEST(MpmcRingTest, EveryItemIsDeliveredOnce) {
+    constexpr int PRODUCERS = 3;
+    constexpr int CONSUMERS = 3;
+    constexpr uint64_t PER_PRODUCER = 10000;
+    MpmcRing<uint64_t> ring(64);
+
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> received{0};
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!ring.tryPush(p * PER_PRODUCER + i)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&] {
+            uint64_t value;
+            while (received.load() < PRODUCERS * PER_PRODUCER) {
+                if (ring.tryPop(value)) {
+                    sum += value;
+                    received++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    const uint64_t total = PRODUCERS * PER_PRODUCER;
+    EXPECT_EQ(received.load(), total);
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+
+    uint64_t value;
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+// Socket -> pooled batch -> ring -> worker, no payload copy on the way
+TEST(RingPublisherTest, PublishesPooledBatchesToWorker) {
+    EventLoop loop;
+    ReceiverConfig config;
+    config.poolSlots = 256;
+    UDPReceiver receiver(loop, config);
+    BufferPool* pool = receiver.bufferPool().get();
+
+    SpscRing<PacketDescriptor> ring(128);
+    RingPublisher<SpscRing<PacketDescriptor>> publisher;
+    publisher.ring = &ring;
+    publisher.pool = pool;
+
+    ASSERT_TRUE(receiver.subscribeBatch(TEST_PORT, &publisher,
+                &RingPublisher<SpscRing<PacketDescriptor>>::onBatch).has_value());
+
+    constexpr int COUNT = 20;
+    std::vector<int> seen;
+    std::atomic<int> consumed{0};
+    std::atomic<bool> stop{false};
+    std::thread worker([&] {
+        while (!stop.load()) {
+            consumed += static_cast<int>(ring.consume(8, [&](PacketDescriptor& d) {
+                EXPECT_EQ(d.port, TEST_PORT);
+                EXPECT_EQ(d.len, 2u);
+                seen.push_back(d.data[0]);
+                pool->release(d.slot);
+            }));
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 0; i < COUNT; ++i) {
+        sendLoopback(TEST_PORT, {static_cast<uint8_t>(i), 0});
+        if (i % 5 == 4) (void)loop.runOnce(100);
+    }
+    for (int i = 0; i < 100 && consumed.load() < COUNT; ++i) {
+        (void)loop.runOnce(10);
+    }
+    stop = true;
+    worker.join();
+
+    EXPECT_EQ(publisher.dropped.load(), 0u);
+    ASSERT_EQ(seen.size(), static_cast<size_t>(COUNT));
+    for (int i = 0; i < COUNT; ++i) EXPECT_EQ(seen[i], i);
+}
+
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
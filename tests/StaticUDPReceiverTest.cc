@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/StaticUDPReceiver.h>
+#include <string>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+struct Collect {
+    std::vector<std::string>* payloads;
+    std::vector<PacketMetadata>* packets;
+
+    void operator()(const PacketMetadata& pkt) const {
+        payloads->emplace_back(reinterpret_cast<const char*>(pkt.data), pkt.len);
+        packets->push_back(pkt);
+    }
+};
+
+} // namespace
+
+class StaticUDPReceiverTest : public ::testing::Test {
+    protected:
+        void sendTo(int port, const std::string& payload) {
+            ASSERT_TRUE(sendLoopback(static_cast<uint16_t>(port), payload));
+        }
+
+        void pumpUntil(const std::vector<std::string>& seen, size_t expected) {
+            for (int i = 0; i < 200 && seen.size() < expected; ++i) {
+                ASSERT_TRUE(loop.runOnce(10).has_value());
+            }
+        }
+
+        EventLoop loop;
+        std::vector<std::string> payloads;
+        std::vector<PacketMetadata> packets;
+};
+
+// Batch of 4: a burst of 10 takes several recvmmsg rounds, in order
+TEST_F(StaticUDPReceiverTest, DeliversWithKernelTimestamps) {
+    StaticUDPReceiver<Collect, StaticReceiverConfig<4, 256>> receiver(loop, Collect{&payloads, &packets});
+    auto port = receiver.subscribe(0);
+    ASSERT_TRUE(port.has_value());
+
+    for (int i = 0; i < 10; ++i) {
+        sendTo(port.value(), "static-" + std::to_string(i));
+    }
+    pumpUntil(payloads, 10);
+
+    ASSERT_EQ(payloads.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(payloads[i], "static-" + std::to_string(i));
+        EXPECT_EQ(packets[i].destPort, port.value());
+        EXPECT_EQ(packets[i].status, PacketStatus::OK);
+        EXPECT_GT(packets[i].ts.tv_sec, 0);
+    }
+}
+
+// Datagrams longer than the compile-time buffer are flagged
+TEST_F(StaticUDPReceiverTest, TruncatesToBufferSize) {
+    StaticUDPReceiver<Collect, StaticReceiverConfig<8, 16, TimestampSource::NONE>> receiver(
+            loop, Collect{&payloads, &packets});
+    auto port = receiver.subscribe(0);
+    ASSERT_TRUE(port.has_value());
+
+    sendTo(port.value(), std::string(100, 'x'));
+    pumpUntil(payloads, 1);
+
+    ASSERT_EQ(payloads.size(), 1u);
+    EXPECT_EQ(payloads[0], std::string(16, 'x'));
+    EXPECT_TRUE(packets[0].status & PacketStatus::TRUNCATED);
+    EXPECT_EQ(packets[0].ts.tv_sec, 0);
+}
+
+// Lambdas work as handler types; ports behave like UDPReceiver subscriptions
+TEST_F(StaticUDPReceiverTest, LambdaHandlerAndUnsubscribe) {
+    int count = 0;
+    auto onPacket = [&count](const PacketMetadata&) { ++count; };
+    StaticUDPReceiver<decltype(onPacket)> receiver(loop, onPacket);
+
+    auto port = receiver.subscribe(0);
+    ASSERT_TRUE(port.has_value());
+    const auto bound = static_cast<uint16_t>(port.value());
+    EXPECT_GE(receiver.getFd(bound), 0);
+    EXPECT_FALSE(receiver.subscribe(bound).has_value());
+
+    sendTo(port.value(), "one");
+    for (int i = 0; i < 200 && count < 1; ++i) {
+        ASSERT_TRUE(loop.runOnce(10).has_value());
+    }
+    EXPECT_EQ(count, 1);
+
+    ASSERT_TRUE(receiver.unsubscribe(bound).has_value());
+    EXPECT_FALSE(receiver.unsubscribe(bound).has_value());
+    EXPECT_EQ(receiver.getFd(bound), -1);
+}
+
+
+// Edge-triggered: one wakeup reads up to the budget, the rest after re-arming
+TEST_F(StaticUDPReceiverTest, EdgeTriggeredBudget) {
+    ReceiverConfig config;
+    config.edgeTriggered = true;
+    config.readBudget = 16;
+    StaticUDPReceiver<Collect, StaticReceiverConfig<8, 256>> receiver(loop, Collect{&payloads, &packets}, config);
+    auto port = receiver.subscribe(0);
+    ASSERT_TRUE(port.has_value());
+
+    for (int i = 0; i < 40; ++i) {
+        sendTo(port.value(), std::to_string(i));
+    }
+    ASSERT_TRUE(loop.runOnce(100).has_value());
+    EXPECT_EQ(payloads.size(), 16u);
+
+    ASSERT_TRUE(loop.runOnce(0).has_value());
+    ASSERT_TRUE(loop.runOnce(0).has_value());
+    ASSERT_EQ(payloads.size(), 40u);
+    EXPECT_EQ(payloads[39], "39");
+}
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
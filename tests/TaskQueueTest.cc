@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/TaskQueue.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace atu_reactor;
+
+namespace {
+
+void appendSeven(void* context) {
+    static_cast<std::vector<int>*>(context)->push_back(7);
+}
+
+} // namespace
+
+// Tasks run in FIFO order; tasks queued while draining wait for the next drain
+TEST(TaskQueueTest, DrainIsDoubleBuffered) {
+    TaskQueue queue;
+    std::vector<int> order;
+
+    queue.push([&]() {
+        order.push_back(1);
+        queue.push([&]() { order.push_back(3); });
+    });
+    queue.push([&]() { order.push_back(2); });
+
+    queue.drain();
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    ASSERT_FALSE(queue.empty());
+
+    queue.drain();
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_TRUE(queue.empty());
+}
+
+// Raw function + context overload
+TEST(TaskQueueTest, RawFunctionOverload) {
+    TaskQueue queue;
+    std::vector<int> order;
+
+    queue.push(&appendSeven, &order);
+    queue.drain();
+
+    EXPECT_EQ(order, (std::vector<int>{7}));
+}
+
+// Non-trivial captures survive buffer growth and are destroyed after running
+TEST(TaskQueueTest, CapturesAreMovedAndReleased) {
+    TaskQueue queue;
+    auto token = std::make_shared<int>(0);
+
+    for (int i = 0; i < 100; ++i) {
+        queue.push([token]() { ++*token; });
+    }
+    EXPECT_EQ(token.use_count(), 101);
+
+    queue.drain();
+    EXPECT_EQ(*token, 100);
+    EXPECT_EQ(token.use_count(), 1);
+}
+
+// Callables larger than the inline buffer still work
+TEST(TaskQueueTest, OversizedCallableIsBoxed) {
+    TaskQueue queue;
+    std::array<int, 32> big{};
+    big[31] = 42;
+    int seen = 0;
+
+    queue.push([big, &seen]() { seen = big[31]; });
+    queue.drain();
+
+    EXPECT_EQ(seen, 42);
+}
+
+// runInLoop tasks run on the next iteration without blocking in epoll_wait
+TEST(TaskQueueTest, EventLoopRunsDeferredTasks) {
+    EventLoop loop;
+    std::vector<int> order;
+
+    loop.runInLoop([&]() { order.push_back(1); });
+    loop.runInLoop(&appendSeven, &order);
+
+    // Would block for a second if pending tasks did not force a zero timeout
+    auto start = std::chrono::steady_clock::now();
+    loop.runOnce(1000).value();
+
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    EXPECT_EQ(order, (std::vector<int>{1, 7}));
+}
+
+
+// Tasks posted from several threads all run on the loop thread, and a
+// loop blocked without timeout is woken up
+TEST(TaskQueueTest, PostWakesLoopFromOtherThreads) {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 1000;
+
+    EventLoop loop;
+    std::thread::id loopThread = std::this_thread::get_id();
+    int executed = 0;
+    std::atomic<bool> wrongThread{false};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&]() {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                loop.post([&]() {
+                    if (std::this_thread::get_id() != loopThread) wrongThread = true;
+                    executed++;
+                });
+            }
+        });
+    }
+
+    while (executed < PRODUCERS * PER_PRODUCER) {
+        loop.runOnce(-1).value();
+    }
+    for (auto& t : producers) t.join();
+
+    EXPECT_EQ(executed, PRODUCERS * PER_PRODUCER);
+    EXPECT_FALSE(wrongThread);
+}
+
+// Raw overload from another thread
+TEST(TaskQueueTest, PostRawFunction) {
+    EventLoop loop;
+    std::vector<int> order;
+
+    std::thread producer([&]() { loop.post(&appendSeven, &order); });
+    producer.join();
+
+    loop.runOnce(1000).value();
+    EXPECT_EQ(order, (std::vector<int>{7}));
+}
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
@@ -16,8 +16,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atu_reactor/EventLoop.h>
 #include <chrono>
+#include <functional>
 #include <thread>
 #include <atomic>
 
@@ -126,3 +128,175 @@ TEST_F(TimerTest, OutOfOrderTimers) {
     EXPECT_EQ(executionOrder[1], 100);
     EXPECT_EQ(executionOrder[2], 200);
 }
+
+// Test 5: Many timers spread over both wheel levels fire in deadline order
+TEST_F(TimerTest, ManyTimersFireInDeadlineOrder) {
+    constexpr int COUNT = 1000;
+    std::vector<int> fired;
+    fired.reserve(COUNT);
+
+    for (int i = 0; i < COUNT; ++i) {
+        int delay = (i * 37) % 150 + 1;
+        loop.runAfter(std::chrono::milliseconds(delay),
+            [&fired, delay]() { fired.push_back(delay); }).value();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (fired.size() < COUNT &&
+           std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000)) {
+        loop.runOnce(10).value();
+    }
+
+    ASSERT_EQ(fired.size(), static_cast<size_t>(COUNT));
+    EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+}
+
+// Test 6: Timers sharing a deadline keep their creation order
+TEST_F(TimerTest, SameDeadlineFiresInCreationOrder) {
+    std::vector<int> executionOrder;
+
+    for (int i = 0; i < 5; ++i) {
+        loop.runAfter(std::chrono::milliseconds(70),
+            [&executionOrder, i]() { executionOrder.push_back(i); }).value();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (executionOrder.size() < 5 &&
+           std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500)) {
+        loop.runOnce(10).value();
+    }
+
+    EXPECT_EQ(executionOrder, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+// Test 7: Cancelling from a callback, including the running timer itself
+TEST_F(TimerTest, CancelFromCallback) {
+    int periodicCount = 0;
+    bool victimFired = false;
+    TimerId periodic = 0;
+    TimerId victim = 0;
+
+    periodic = loop.runEvery(std::chrono::milliseconds(20), [&]() {
+        periodicCount++;
+        EXPECT_TRUE(loop.cancelTimer(periodic).has_value());
+    }).value();
+
+    // Same deadline, created later: cancelled before it gets to run
+    loop.runAfter(std::chrono::milliseconds(20), [&]() {
+        EXPECT_TRUE(loop.cancelTimer(victim).has_value());
+    }).value();
+    victim = loop.runAfter(std::chrono::milliseconds(20), [&]() {
+        victimFired = true;
+    }).value();
+
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100)) {
+        loop.runOnce(10).value();
+    }
+
+    EXPECT_EQ(periodicCount, 1);
+    EXPECT_FALSE(victimFired);
+
+    // Both ids are stale now
+    EXPECT_FALSE(loop.cancelTimer(periodic).has_value());
+    EXPECT_FALSE(loop.cancelTimer(victim).has_value());
+}
+
+// Test 8: A timer beyond the first level cascades down and fires on time
+TEST_F(TimerTest, FarTimerCascadesAndCancels) {
+    bool farFired = false;
+    TimerId far = loop.runAfter(std::chrono::hours(24), [&]() { farFired = true; }).value();
+
+    std::chrono::steady_clock::duration elapsed{};
+    auto start = std::chrono::steady_clock::now();
+    bool fired = false;
+    loop.runAfter(std::chrono::milliseconds(200), [&]() {
+        elapsed = std::chrono::steady_clock::now() - start;
+        fired = true;
+    }).value();
+
+    while (!fired &&
+           std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000)) {
+        loop.runOnce(50).value();
+    }
+
+    ASSERT_TRUE(fired);
+    EXPECT_GE(elapsed, std::chrono::milliseconds(200));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(300));
+
+    EXPECT_TRUE(loop.cancelTimer(far).has_value());
+    EXPECT_FALSE(farFired);
+}
+
+// Nanosecond timers are not rounded up to the 1ms wheel tick
+TEST_F(TimerTest, PreciseTimerFiresBetweenTicks) {
+    std::chrono::steady_clock::duration elapsed{};
+    bool fired = false;
+    auto start = std::chrono::steady_clock::now();
+
+    ASSERT_TRUE(loop.runAfterPrecise(300us, [&]() {
+        elapsed = std::chrono::steady_clock::now() - start;
+        fired = true;
+    }, 100us).has_value());
+
+    while (!fired && std::chrono::steady_clock::now() - start < 100ms) {
+        loop.runOnce(10).value();
+    }
+
+    ASSERT_TRUE(fired);
+    EXPECT_GE(elapsed, 300us);
+    EXPECT_LT(elapsed, 1ms);
+}
+
+TEST_F(TimerTest, PreciseAndWheelTimersInterleave) {
+    std::vector<int> order;
+    auto now = std::chrono::steady_clock::now();
+
+    loop.runAfter(2ms, [&]() { order.push_back(3); }).value();
+    loop.runAt(now + 500us, [&]() { order.push_back(1); }).value();
+    loop.runAt(now + 1500us, [&]() { order.push_back(2); }).value();
+    TimerId cancelled = loop.runAt(now + 700us, [&]() { order.push_back(99); }).value();
+    EXPECT_TRUE(loop.cancelTimer(cancelled).has_value());
+    EXPECT_FALSE(loop.cancelTimer(cancelled).has_value());
+
+    while (order.size() < 3 && std::chrono::steady_clock::now() - now < 100ms) {
+        loop.runOnce(10).value();
+    }
+
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(TimerTest, PrecisePeriodicTimerDoesNotDrift) {
+    int fireCount = 0;
+    TimerId id = 0;
+    id = loop.runEveryPrecise(250us, [&]() {
+        if (++fireCount == 8) {
+            EXPECT_TRUE(loop.cancelTimer(id).has_value());
+        }
+    }).value();
+
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < 20ms) {
+        loop.runOnce(1).value();
+    }
+
+    EXPECT_EQ(fireCount, 8);
+    EXPECT_FALSE(loop.runEveryPrecise(0ns, []() {}).has_value());
+}
+
+// The spin lead puts each reschedule's wake time in the past, yet it only
+// runs on the next iteration
+TEST_F(TimerTest, SelfReschedulingPreciseTimerDoesNotLivelock) {
+    int fireCount = 0;
+    std::function<void()> again = [&]() {
+        fireCount++;
+        loop.runAfterPrecise(0ns, again, 100us).value();
+    };
+    loop.runAfterPrecise(0ns, again, 100us).value();
+
+    for (int i = 1; i <= 5; ++i) {
+        loop.runOnce(10).value();
+        EXPECT_LE(fireCount, i);
+    }
+    EXPECT_GE(fireCount, 1);
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+// The wheel is internal: it is built into this test directly, so that
+// time can be driven far beyond what a real EventLoop could wait for
+#include "TimerWheel.h"
+
+using namespace atu_reactor;
+using namespace std::chrono_literals;
+
+namespace {
+
+// 2^36 ms: the span of the six-level wheel
+constexpr Duration BLOCK{1LL << 36};
+
+// Advances from wakeup to wakeup until fn says stop, like EventLoop does
+template <typename Fn>
+int runUntil(detail::TimerWheel& wheel, Fn done) {
+    int steps = 0;
+    Timestamp when;
+    while (!done() && steps < 1000 && wheel.nextWakeup(when)) {
+        wheel.advance(when);
+        steps++;
+    }
+    return steps;
+}
+
+} // namespace
+
+class TimerWheelTest : public ::testing::Test {
+protected:
+    Timestamp epoch = Clock::now();
+    detail::TimerWheel wheel{epoch};
+};
+
+TEST_F(TimerWheelTest, MultiYearTimerFiresOnTime) {
+    const Timestamp deadline = epoch + std::chrono::hours(24 * 365 * 3);
+    Timestamp when;
+    Timestamp firedAt{};
+    wheel.add(deadline, Duration(0), [&]() { firedAt = when; });
+
+    ASSERT_TRUE(wheel.nextWakeup(when));
+    EXPECT_LT(when, deadline);
+
+    // Only cascades in between: no wakeup runs past the deadline
+    while (firedAt == Timestamp{} && wheel.nextWakeup(when)) {
+        ASSERT_LE(when, deadline);
+        wheel.advance(when);
+    }
+    EXPECT_EQ(firedAt, deadline);
+    EXPECT_FALSE(wheel.nextWakeup(when));
+}
+
+TEST_F(TimerWheelTest, MultiYearTimerCancels) {
+    TimerId id = wheel.add(epoch + std::chrono::hours(24 * 365 * 5), Duration(0), []() { FAIL(); });
+
+    EXPECT_TRUE(wheel.cancel(id));
+    EXPECT_FALSE(wheel.cancel(id));
+
+    Timestamp when;
+    EXPECT_FALSE(wheel.nextWakeup(when));
+}
+
+// A short timer armed just before the wheel wraps into its next block
+TEST_F(TimerWheelTest, TimerCrossingBlockBoundaryFires) {
+    bool primed = false;
+    wheel.add(epoch + BLOCK - 2ms, Duration(0), [&]() { primed = true; });
+    runUntil(wheel, [&]() { return primed; });
+    ASSERT_TRUE(primed);
+
+    std::vector<int> order;
+    wheel.add(epoch + BLOCK + 8ms, Duration(0), [&]() { order.push_back(2); });
+    wheel.add(epoch + BLOCK - 1ms, Duration(0), [&]() { order.push_back(1); });
+    wheel.add(epoch + 2 * BLOCK + 3ms, Duration(0), [&]() { order.push_back(3); });
+
+    runUntil(wheel, [&]() { return order.size() == 3; });
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(TimerWheelTest, PeriodicTimerKeepsFiringAcrossBlocks) {
+    int fireCount = 0;
+    TimerId id = 0;
+    id = wheel.add(epoch + BLOCK - 1ms, std::chrono::hours(24 * 30), [&]() {
+        if (++fireCount == 30) wheel.cancel(id);
+    });
+
+    runUntil(wheel, [&]() { return fireCount == 30; });
+    EXPECT_EQ(fireCount, 30);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
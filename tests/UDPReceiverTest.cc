@@ -17,16 +17,26 @@
 
 #include <gtest/gtest.h>
 #include <atu_reactor/UDPReceiver.h>
+#include <atu_reactor/UDPSender.h>
 #include <atu_reactor/EventLoop.h>
+#include <atu_reactor/PacketMetadata.h>
+#include <atu_reactor/SubscribeOptions.h>
 
+#include <stdexcept>
 #include <thread>
 #include <vector>
 #include <string>
 #include <cstring>
 #include <arpa/inet.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/udp.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include "LoopbackSender.h"
+
 using namespace atu_reactor;
 
 // --- Mock Handler for Verification ---
@@ -64,39 +74,6 @@ protected:
     EventLoop loop;
     MockPacketHandler handler;
     const uint16_t TEST_PORT = 12345;
-
-    // Helper to send raw UDP packets
-    void sendUdpPacket(const std::vector<uint8_t>& data, uint16_t port) {
-        int sock = socket(AF_INET, SOCK_DGRAM, 0);
-        ASSERT_GE(sock, 0);
-
-        struct sockaddr_in destAddr{};
-        destAddr.sin_family = AF_INET;
-        destAddr.sin_port = htons(port);
-        inet_pton(AF_INET, "127.0.0.1", &destAddr.sin_addr);
-
-        sendto(sock, data.data(), data.size(), 0,
-               (struct sockaddr*)&destAddr, sizeof(destAddr));
-        close(sock);
-    }
-
-    // Helper to send raw IPv6 UDP packets
-    void sendUdp6Packet(const std::vector<uint8_t>& data, uint16_t port) {
-        int sock = socket(AF_INET6, SOCK_DGRAM, 0);
-        if (sock < 0) {
-            if (errno == EAFNOSUPPORT) return; // Skip if IPv6 not supported on host
-            ASSERT_GE(sock, 0);
-        }
-
-        struct sockaddr_in6 destAddr{};
-        destAddr.sin6_family = AF_INET6;
-        destAddr.sin6_port = htons(port);
-        inet_pton(AF_INET6, "::1", &destAddr.sin6_addr);
-
-        sendto(sock, data.data(), data.size(), 0,
-                (struct sockaddr*)&destAddr, sizeof(destAddr));
-        close(sock);
-    }
 };
 
 // --- Test Cases ---
@@ -112,7 +89,7 @@ TEST_F(UDPReceiverTest, ReceivesLargePacketCorrectly) {
     std::string largePayload(1000, 'A'); // 1000 bytes of 'A'
     std::vector<uint8_t> packetData(largePayload.begin(), largePayload.end());
 
-    sendUdpPacket(packetData, TEST_PORT);
+    sendLoopback(TEST_PORT, packetData);
 
     // Run loop briefly to process the packet
     loop.runOnce(100);
@@ -133,7 +110,7 @@ TEST_F(UDPReceiverTest, HandlesBurstOfPackets) {
     int packetCount = 5;
     for(int i=0; i < packetCount; ++i) {
         std::string msg = "Packet " + std::to_string(i);
-        sendUdpPacket({msg.begin(), msg.end()}, TEST_PORT);
+        sendLoopback(TEST_PORT, {msg.begin(), msg.end()});
     }
 
     // Allow time for OS to buffer and loop to read
@@ -197,7 +174,7 @@ TEST_F(UDPReceiverTest, ReceivesIPv6Packet) {
     ASSERT_TRUE(result.has_value());
 
     std::vector<uint8_t> packetData = {0xDE, 0xAD, 0xBE, 0xEF};
-    sendUdp6Packet(packetData, TEST_PORT);
+    sendLoopback(TEST_PORT, packetData, AF_INET6);
 
     loop.runOnce(100);
 
@@ -211,8 +188,8 @@ TEST_F(UDPReceiverTest, HandlesMixedIPv4AndIPv6Traffic) {
     auto result = receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket);
     ASSERT_TRUE(result.has_value());
 
-    sendUdpPacket({0x04}, TEST_PORT); // Send v4
-    sendUdp6Packet({0x06}, TEST_PORT); // Send v6
+    sendLoopback(TEST_PORT, {0x04}); // Send v4
+    sendLoopback(TEST_PORT, {0x06}, AF_INET6); // Send v6
 
     loop.runOnce(100);
 
@@ -231,7 +208,7 @@ TEST_F(UDPReceiverTest, IPv6DynamicPortResolution) {
     EXPECT_GT(assignedPort, 0);
 
     // Verify we can actually receive on that assigned port via IPv6
-    sendUdp6Packet({0xAA}, assignedPort);
+    sendLoopback(assignedPort, {0xAA}, AF_INET6);
     loop.runOnce(100);
 
     ASSERT_EQ(handler.receivedPackets.size(), 1);
@@ -252,7 +229,7 @@ TEST_F(UDPReceiverTest, DetectsTruncatedPackets) {
 
     // Send 150 bytes into a 100-byte buffer
     std::vector<uint8_t> largePacket(150, 'X');
-    sendUdpPacket(largePacket, TEST_PORT);
+    sendLoopback(TEST_PORT, largePacket);
 
     loop.runOnce(100);
 
@@ -273,7 +250,7 @@ TEST_F(UDPReceiverTest, NormalPacketsHaveOkStatus) {
     auto result = receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket);
     ASSERT_TRUE(result.has_value());
 
-    sendUdpPacket({0x01, 0x02, 0x03}, TEST_PORT);
+    sendLoopback(TEST_PORT, {0x01, 0x02, 0x03});
     loop.runOnce(100);
 
     ASSERT_EQ(handler.receivedPackets.size(), 1);
@@ -289,7 +266,7 @@ TEST_F(UDPReceiverTest, ProvidesKernelTimestamps) {
     ASSERT_TRUE(result.has_value());
 
     std::string payload = "timestamp_test";
-    sendUdpPacket(std::vector<uint8_t>(payload.begin(), payload.end()), TEST_PORT);
+    sendLoopback(TEST_PORT, std::vector<uint8_t>(payload.begin(), payload.end()));
 
     loop.runOnce(100); // Poll the reactor
 
@@ -304,3 +281,624 @@ TEST_F(UDPReceiverTest, ProvidesKernelTimestamps) {
     clock_gettime(CLOCK_REALTIME, &now);
     EXPECT_LT(now.tv_sec - ts.tv_sec, 10);
 }
+
+// With timestamps disabled no stamp is reported
+TEST_F(UDPReceiverTest, TimestampsCanBeDisabled) {
+    ReceiverConfig config;
+    config.timestamps = TimestampSource::NONE;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    sendLoopback(TEST_PORT, {1, 2, 3});
+    loop.runOnce(100);
+
+    ASSERT_EQ(handler.receivedPackets.size(), 1u);
+    EXPECT_EQ(handler.receivedPackets[0].ts.tv_sec, 0);
+    EXPECT_EQ(handler.receivedPackets[0].ts.tv_nsec, 0);
+}
+
+// SO_TIMESTAMPING still reports the software stamp where the NIC (here
+// loopback) has no hardware clock
+TEST_F(UDPReceiverTest, HardwareModeFallsBackToSoftwareStamp) {
+    ReceiverConfig config;
+    config.timestamps = TimestampSource::HARDWARE;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    // The kernel enables RX stamping lazily, so a cold first datagram may
+    // carry no stamp at all: warm up until one does
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        sendLoopback(TEST_PORT, {1, 2, 3});
+        loop.runOnce(100);
+        if (!handler.receivedPackets.empty() && handler.receivedPackets.back().ts.tv_sec > 0) break;
+    }
+
+    ASSERT_FALSE(handler.receivedPackets.empty());
+    for (const auto& packet : handler.receivedPackets) {
+        EXPECT_EQ(packet.status & PacketStatus::HW_TIMESTAMP, 0u);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    ASSERT_GT(handler.receivedPackets.back().ts.tv_sec, 0);
+    EXPECT_LT(now.tv_sec - handler.receivedPackets.back().ts.tv_sec, 10);
+}
+
+// --- Batch API Test Cases ---
+
+struct BatchCollector {
+    int calls = 0;
+    std::vector<std::string> payloads;
+    std::vector<uint16_t> ports;
+    std::vector<uint32_t> statuses;
+    bool contiguous = true;
+
+    static void onBatch(void* context, int count, const PacketMetadata* packets,
+                        const uint8_t* base, size_t stride) {
+        auto* self = static_cast<BatchCollector*>(context);
+        self->calls++;
+        for (int i = 0; i < count; ++i) {
+            self->payloads.emplace_back(reinterpret_cast<const char*>(packets[i].data), packets[i].len);
+            self->ports.push_back(packets[i].destPort);
+            self->statuses.push_back(packets[i].status);
+            if (packets[i].data != base + i * stride) self->contiguous = false;
+        }
+    }
+};
+
+/**
+ * @brief Verify that a burst is delivered in a single batch callback.
+ */
+TEST_F(UDPReceiverTest, BatchHandlerReceivesWholeBurst) {
+    UDPReceiver receiver(loop);
+    BatchCollector collector;
+
+    auto result = receiver.subscribeBatch(TEST_PORT, &collector, &BatchCollector::onBatch);
+    ASSERT_TRUE(result.has_value()) << "Subscribe failed: " << result.error().message();
+
+    for (int i = 0; i < 5; ++i) {
+        std::string msg = "Batch " + std::to_string(i);
+        sendLoopback(TEST_PORT, {msg.begin(), msg.end()});
+    }
+
+    loop.runOnce(100);
+
+    EXPECT_EQ(collector.calls, 1);
+    ASSERT_EQ(collector.payloads.size(), 5u);
+    EXPECT_EQ(collector.payloads[0], "Batch 0");
+    EXPECT_EQ(collector.payloads[4], "Batch 4");
+    EXPECT_EQ(collector.ports[0], TEST_PORT);
+    EXPECT_TRUE(collector.contiguous) << "Payloads do not follow base + i * stride";
+}
+
+TEST_F(UDPReceiverTest, BatchSubscribeSharesPortBookkeeping) {
+    UDPReceiver receiver(loop);
+    BatchCollector collector;
+
+    ASSERT_TRUE(receiver.subscribeBatch(TEST_PORT, &collector, &BatchCollector::onBatch).has_value());
+
+    auto dup = receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket);
+    ASSERT_FALSE(dup.has_value());
+    EXPECT_EQ(dup.error().value(), EADDRINUSE);
+
+    EXPECT_TRUE(receiver.unsubscribe(TEST_PORT).has_value());
+}
+
+// --- GRO Test Cases ---
+
+/**
+ * @brief A GSO burst coalesced by the kernel is split back into datagrams.
+ */
+TEST_F(UDPReceiverTest, GroSplitsCoalescedDatagrams) {
+    ReceiverConfig config;
+    config.enableGro = true;
+    UDPReceiver receiver(loop, config);
+
+    BatchCollector collector;
+    auto result = receiver.subscribeBatch(0, &collector, &BatchCollector::onBatch);
+    ASSERT_TRUE(result.has_value()) << "Subscribe failed: " << result.error().message();
+    uint16_t port = static_cast<uint16_t>(result.value());
+
+    SenderConfig senderConfig;
+    senderConfig.enableGso = true;
+    UDPSender sender(loop, senderConfig);
+
+    struct sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+
+    for (int i = 0; i < 40; ++i) {
+        std::string msg = "segment " + std::to_string(100 + i); // 11 bytes each
+        ASSERT_TRUE(sender.send(reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest),
+                    reinterpret_cast<const uint8_t*>(msg.data()), msg.size()).has_value());
+    }
+
+    for (int i = 0; i < 10 && collector.payloads.size() < 40; ++i) {
+        loop.runOnce(10);
+    }
+
+    ASSERT_EQ(collector.payloads.size(), 40u);
+    EXPECT_EQ(collector.payloads[0], "segment 100");
+    EXPECT_EQ(collector.payloads[39], "segment 139");
+    EXPECT_EQ(collector.ports[39], port);
+}
+
+/**
+ * @brief The kernel may coalesce more segments than the metadata array holds
+ * (here 128 into one batch of 1): the remainder comes unsplit, flagged TRUNCATED.
+ */
+TEST_F(UDPReceiverTest, GroOverflowKeepsRemainderWhole) {
+    constexpr int SEGMENTS = 128;
+    constexpr int SEGMENT_SIZE = 11;
+
+    ReceiverConfig config;
+    config.enableGro = true;
+    config.batchSize = 1;
+    UDPReceiver receiver(loop, config);
+
+    BatchCollector collector;
+    auto result = receiver.subscribeBatch(0, &collector, &BatchCollector::onBatch);
+    ASSERT_TRUE(result.has_value()) << "Subscribe failed: " << result.error().message();
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sock, 0);
+    int gsoSize = SEGMENT_SIZE;
+    if (setsockopt(sock, SOL_UDP, UDP_SEGMENT, &gsoSize, sizeof(gsoSize)) < 0) {
+        close(sock);
+        GTEST_SKIP() << "No UDP_SEGMENT on this kernel";
+    }
+
+    std::string burst;
+    for (int i = 0; i < SEGMENTS; ++i) burst += "segment " + std::to_string(100 + i);
+    struct sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(static_cast<uint16_t>(result.value()));
+    inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+    const ssize_t sent = sendto(sock, burst.data(), burst.size(), 0,
+            reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest));
+    close(sock);
+    if (sent < 0) GTEST_SKIP() << "128-segment GSO send refused";
+
+    std::string received;
+    for (int i = 0; i < 20 && received.size() < burst.size(); ++i) {
+        loop.runOnce(10);
+        received.clear();
+        for (const auto& p : collector.payloads) received += p;
+    }
+
+    // Every byte arrives once, in order; whole segments unless flagged
+    EXPECT_EQ(received, burst);
+    for (size_t i = 0; i < collector.payloads.size(); ++i) {
+        if (!(collector.statuses[i] & PacketStatus::TRUNCATED)) {
+            EXPECT_EQ(collector.payloads[i].size(), static_cast<size_t>(SEGMENT_SIZE)) << "entry " << i;
+        }
+    }
+}
+
+// Spin mode returns as soon as the packet is there and accounts its polling
+TEST_F(UDPReceiverTest, SpinPolicyDeliversAndCounts) {
+    PollPolicy policy;
+    policy.mode = PollMode::SPIN;
+    ASSERT_TRUE(loop.setPollPolicy(policy).has_value());
+
+    UDPReceiver receiver(loop);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, MockPacketHandler::onPacket).has_value());
+
+    // Nothing to read: the spin is bounded by the timeout
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.runOnce(20).has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_GT(loop.stats().emptyPolls, 0u);
+    EXPECT_EQ(loop.stats().blockingWaits, 0u);
+
+    sendLoopback(TEST_PORT, {1, 2, 3});
+    loop.resetStats();
+    ASSERT_TRUE(loop.runOnce(1000).has_value());
+
+    ASSERT_EQ(handler.receivedPackets.size(), 1u);
+    EXPECT_EQ(loop.stats().iterations, 1u);
+    EXPECT_EQ(loop.stats().events, 1u);
+    EXPECT_GT(loop.stats().busyNs, 0u);
+}
+
+// Hybrid mode blocks once its spin budget is spent
+TEST_F(UDPReceiverTest, HybridPolicyFallsBackToBlocking) {
+    PollPolicy policy;
+    policy.mode = PollMode::HYBRID;
+    policy.spinBudget = std::chrono::microseconds(200);
+    ASSERT_TRUE(loop.setPollPolicy(policy).has_value());
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(loop.runOnce(20).has_value());
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(loop.stats().blockingWaits, 1u);
+    EXPECT_LT(loop.stats().spinNs, 20'000'000u);
+}
+
+// Busy-poll socket options are applied at subscribe time
+TEST_F(UDPReceiverTest, BusyPollSocketOptions) {
+    ReceiverConfig config;
+    config.busyPollUs = 50;
+    config.preferBusyPoll = true;
+    UDPReceiver receiver(loop, config);
+
+    auto result = receiver.subscribe(TEST_PORT, &handler, MockPacketHandler::onPacket);
+    if (!result && result.error().value() == EPERM) {
+        GTEST_SKIP() << "SO_BUSY_POLL needs CAP_NET_ADMIN";
+    }
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+
+    int usecs = 0;
+    socklen_t len = sizeof(usecs);
+    ASSERT_EQ(getsockopt(receiver.getFd(TEST_PORT), SOL_SOCKET, SO_BUSY_POLL, &usecs, &len), 0);
+    EXPECT_EQ(usecs, 50);
+
+    sendLoopback(TEST_PORT, {9});
+    loop.runOnce(100);
+    EXPECT_EQ(handler.receivedPackets.size(), 1u);
+}
+
+// --- SubscribeOptions Test Cases ---
+
+// The classic BPF filter runs in the kernel: only payloads starting with 0x42 pass
+TEST_F(UDPReceiverTest, KernelFilterDropsUnwantedDatagrams) {
+    SubscribeOptions options;
+    options.filter = {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 8),              // First payload byte
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x42, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xFFFF),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+
+    UDPReceiver receiver(loop);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, options, &handler, &MockPacketHandler::onPacket).has_value());
+
+    sendLoopback(TEST_PORT, {0x10, 1});
+    sendLoopback(TEST_PORT, {0x42, 2});
+    sendLoopback(TEST_PORT, {0x11, 3});
+
+    for (int i = 0; i < 5; ++i) loop.runOnce(10);
+
+    ASSERT_EQ(handler.receivedPackets.size(), 1u);
+    EXPECT_EQ(handler.receivedPackets[0].data, (std::vector<uint8_t>{0x42, 2}));
+}
+
+// Binding to 127.0.0.1 keeps IPv6 loopback traffic out
+TEST_F(UDPReceiverTest, BindAddressRestrictsTraffic) {
+    SubscribeOptions options;
+    options.bindAddress = "127.0.0.1";
+    options.rcvbuf = 1 << 20;
+
+    UDPReceiver receiver(loop);
+    auto result = receiver.subscribe(TEST_PORT, options, &handler, &MockPacketHandler::onPacket);
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+
+    int size = 0;
+    socklen_t len = sizeof(size);
+    ASSERT_EQ(getsockopt(receiver.getFd(TEST_PORT), SOL_SOCKET, SO_RCVBUF, &size, &len), 0);
+    EXPECT_GT(size, 0);
+
+    sendLoopback(TEST_PORT, {6}, AF_INET6);
+    sendLoopback(TEST_PORT, {4});
+    for (int i = 0; i < 5; ++i) loop.runOnce(10);
+
+    ASSERT_EQ(handler.receivedPackets.size(), 1u);
+    EXPECT_EQ(handler.receivedPackets[0].data[0], 4);
+
+    SubscribeOptions bad;
+    bad.bindAddress = "not an address";
+    auto rejected = receiver.subscribe(TEST_PORT + 1, bad, &handler, &MockPacketHandler::onPacket);
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().value(), EINVAL);
+}
+
+// Any-source and source-specific joins on loopback
+TEST_F(UDPReceiverTest, JoinsMulticastGroups) {
+    SubscribeOptions options;
+    options.joins = {{"239.1.2.3", ""}, {"232.1.2.3", "127.0.0.1"}};
+
+    UDPReceiver receiver(loop);
+    auto result = receiver.subscribe(TEST_PORT, options, &handler, &MockPacketHandler::onPacket);
+    if (!result && (result.error().value() == ENODEV || result.error().value() == EADDRNOTAVAIL)) {
+        GTEST_SKIP() << "No multicast capable interface: " << result.error().message();
+    }
+    ASSERT_TRUE(result.has_value()) << result.error().message();
+
+    SubscribeOptions malformed;
+    malformed.joins = {{"239.1.2.3", "::1"}};
+    auto rejected = receiver.subscribe(TEST_PORT + 1, malformed, &handler, &MockPacketHandler::onPacket);
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error().value(), EINVAL);
+}
+
+// --- Statistics Test Cases ---
+
+TEST_F(UDPReceiverTest, StatsAreOffByDefault) {
+    UDPReceiver receiver(loop);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    sendLoopback(TEST_PORT, {1, 2, 3});
+    loop.runOnce(100);
+
+    EXPECT_EQ(handler.receivedPackets.size(), 1u);
+    EXPECT_EQ(receiver.portStats(TEST_PORT), nullptr);
+    EXPECT_EQ(receiver.stats().packets.load(), 0u);
+}
+
+TEST_F(UDPReceiverTest, StatsCountPacketsBytesAndLatency) {
+    ReceiverConfig config;
+    config.enableStats = true;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    auto portStats = receiver.portStats(TEST_PORT);
+    ASSERT_NE(portStats, nullptr);
+
+    for (int i = 0; i < 3; ++i) sendLoopback(TEST_PORT, {1, 2, 3, 4});
+    loop.runOnce(100);
+
+    ASSERT_EQ(handler.receivedPackets.size(), 3u);
+
+    // Counters are readable from any thread
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    std::thread reader([&] {
+        packets = portStats->packets.load();
+        bytes = portStats->bytes.load();
+    });
+    reader.join();
+
+    EXPECT_EQ(packets, 3u);
+    EXPECT_EQ(bytes, 12u);
+    EXPECT_EQ(portStats->truncated.load(), 0u);
+    EXPECT_EQ(portStats->kernelDrops.load(), 0u);
+
+    const ReceiverStats& stats = receiver.stats();
+    EXPECT_EQ(stats.packets.load(), 3u);
+    EXPECT_EQ(stats.batches.load(), 1u);
+    EXPECT_EQ(stats.batchFill[static_cast<size_t>(ReceiverStats::fillBucket(3))].load(), 1u);
+    EXPECT_EQ(stats.latency.count(), 3u);
+
+    // The caller's reference outlives the subscription
+    EXPECT_TRUE(receiver.unsubscribe(TEST_PORT).has_value());
+    EXPECT_EQ(receiver.portStats(TEST_PORT), nullptr);
+    EXPECT_EQ(portStats->packets.load(), 3u);
+}
+
+TEST(LatencyHistogramTest, BucketsAreLogLinear) {
+    for (uint64_t v : {0ULL, 7ULL, 8ULL, 100ULL, 12345ULL, 1ULL << 40, ~0ULL}) {
+        int b = LatencyHistogram::bucketOf(v);
+        ASSERT_LT(b, LatencyHistogram::BUCKETS);
+        EXPECT_LE(LatencyHistogram::lowerBound(b), v);
+        if (b + 1 < LatencyHistogram::BUCKETS) {
+            EXPECT_GT(LatencyHistogram::lowerBound(b + 1), v);
+        }
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 100; ++v) histogram.record(v * 1000);
+    EXPECT_EQ(histogram.count(), 100u);
+
+    uint64_t median = histogram.quantile(0.5);
+    EXPECT_GE(median, 50000u * 7 / 8);
+    EXPECT_LE(median, 50000u);
+}
+
+TEST_F(UDPReceiverTest, LevelTriggeredReadsOneBatchPerWakeup) {
+    ReceiverConfig config;
+    config.batchSize = 8;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    for (int i = 0; i < 100; ++i) sendLoopback(TEST_PORT, {static_cast<uint8_t>(i)});
+    loop.runOnce(100);
+    EXPECT_EQ(handler.receivedPackets.size(), 8u);
+}
+
+TEST_F(UDPReceiverTest, EdgeTriggeredDrainsTheQueue) {
+    ReceiverConfig config;
+    config.batchSize = 8;
+    config.edgeTriggered = true;
+    config.readBudget = 0;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    for (int i = 0; i < 100; ++i) sendLoopback(TEST_PORT, {static_cast<uint8_t>(i)});
+    loop.runOnce(100);
+    ASSERT_EQ(handler.receivedPackets.size(), 100u);
+    EXPECT_EQ(handler.receivedPackets[99].data[0], 99);
+
+    // A new datagram is a new edge
+    sendLoopback(TEST_PORT, {7});
+    loop.runOnce(100);
+    EXPECT_EQ(handler.receivedPackets.size(), 101u);
+}
+
+TEST_F(UDPReceiverTest, ReadBudgetYieldsAndRearms) {
+    ReceiverConfig config;
+    config.batchSize = 8;
+    config.edgeTriggered = true;
+    config.readBudget = 32;
+    UDPReceiver receiver(loop, config);
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+
+    for (int i = 0; i < 100; ++i) sendLoopback(TEST_PORT, {static_cast<uint8_t>(i)});
+    loop.runOnce(100);
+    EXPECT_EQ(handler.receivedPackets.size(), 32u);
+
+    // Nothing new arrives: the re-armed socket is reported again regardless
+    loop.runOnce(0);
+    EXPECT_EQ(handler.receivedPackets.size(), 64u);
+    loop.runOnce(0);
+    loop.runOnce(0);
+    EXPECT_EQ(handler.receivedPackets.size(), 100u);
+}
+
+namespace {
+
+struct EventSink {
+    int fd;
+    int calls = 0;
+    uint32_t events = 0;
+
+    static void onReady(void* context, uint32_t events) {
+        auto* self = static_cast<EventSink*>(context);
+        uint64_t value;
+        ASSERT_EQ(read(self->fd, &value, sizeof(value)), static_cast<ssize_t>(sizeof(value)));
+        self->calls++;
+        self->events = events;
+    }
+};
+
+} // namespace
+
+TEST(EventLoopSourceTest, UserCallbackSource) {
+    EventLoop loop;
+    ScopedFd efd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    ASSERT_GE(efd, 0);
+
+    EventSink sink{efd};
+    EXPECT_FALSE(loop.addSource(efd, EPOLLIN, nullptr, &sink).has_value());
+    ASSERT_TRUE(loop.addSource(efd, EPOLLIN, &EventSink::onReady, &sink).has_value());
+
+    loop.runOnce(0);
+    EXPECT_EQ(sink.calls, 0);
+
+    const uint64_t one = 1;
+    ASSERT_EQ(write(efd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+    loop.runOnce(100);
+    EXPECT_EQ(sink.calls, 1);
+    EXPECT_TRUE(sink.events & EPOLLIN);
+
+    EXPECT_TRUE(loop.removeSource(efd).has_value());
+}
+
+TEST_F(UDPReceiverTest, WeightAllowsMoreReadsPerWakeup) {
+    ReceiverConfig config;
+    config.batchSize = 8;
+    UDPReceiver receiver(loop, config);
+
+    SubscribeOptions options;
+    options.weight = 0;
+    EXPECT_FALSE(receiver.subscribe(TEST_PORT, options, &handler, &MockPacketHandler::onPacket).has_value());
+
+    options.weight = 3;
+    ASSERT_TRUE(receiver.subscribe(TEST_PORT, options, &handler, &MockPacketHandler::onPacket).has_value());
+
+    for (int i = 0; i < 100; ++i) sendLoopback(TEST_PORT, {static_cast<uint8_t>(i)});
+    loop.runOnce(100);
+    EXPECT_EQ(handler.receivedPackets.size(), 24u);
+}
+
+namespace {
+
+struct OrderedSink {
+    int fd;
+    int id;
+    std::vector<int>* order;
+
+    static void onReady(void* context, uint32_t) {
+        auto* self = static_cast<OrderedSink*>(context);
+        uint64_t value;
+        ASSERT_EQ(read(self->fd, &value, sizeof(value)), static_cast<ssize_t>(sizeof(value)));
+        self->order->push_back(self->id);
+    }
+};
+
+void notify(int fd) {
+    const uint64_t one = 1;
+    ASSERT_EQ(write(fd, &one, sizeof(one)), static_cast<ssize_t>(sizeof(one)));
+}
+
+} // namespace
+
+TEST(EventLoopSourceTest, HigherClassesAreDispatchedFirst) {
+    EventLoop loop;
+    ScopedFd low(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    ScopedFd normal(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    ScopedFd high(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    ASSERT_GE(low, 0);
+    ASSERT_GE(normal, 0);
+    ASSERT_GE(high, 0);
+
+    std::vector<int> order;
+    OrderedSink lowSink{low, 2, &order};
+    OrderedSink normalSink{normal, 1, &order};
+    OrderedSink highSink{high, 0, &order};
+    ASSERT_TRUE(loop.addSource(low, EPOLLIN, &OrderedSink::onReady, &lowSink, Priority::LOW).has_value());
+    ASSERT_TRUE(loop.addSource(normal, EPOLLIN, &OrderedSink::onReady, &normalSink).has_value());
+    ASSERT_TRUE(loop.addSource(high, EPOLLIN, &OrderedSink::onReady, &highSink).has_value());
+    ASSERT_TRUE(loop.setSourcePriority(high, Priority::HIGH).has_value());
+    EXPECT_FALSE(loop.setSourcePriority(12345, Priority::HIGH).has_value());
+
+    // Ready in the opposite order of their classes
+    notify(low);
+    notify(normal);
+    notify(high);
+    loop.runOnce(100);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+
+    const LoopStats& stats = loop.stats();
+    for (int c = 0; c < PRIORITY_CLASSES; ++c) {
+        EXPECT_EQ(stats.classEvents[static_cast<size_t>(c)].load(), 1u);
+        EXPECT_EQ(stats.classDelay[static_cast<size_t>(c)].count(), 1u);
+    }
+}
+
+TEST(EventLoopSourceTest, TaskClassesRunAroundDispatch) {
+    EventLoop loop;
+    ScopedFd efd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC));
+    ASSERT_GE(efd, 0);
+
+    std::vector<int> order;
+    OrderedSink sink{efd, 1, &order};
+    ASSERT_TRUE(loop.addSource(efd, EPOLLIN, &OrderedSink::onReady, &sink).has_value());
+
+    loop.runInLoop(Priority::LOW, [&order] { order.push_back(3); });
+    loop.runInLoop([&order] { order.push_back(2); });
+    loop.runInLoop(Priority::HIGH, [&order] { order.push_back(0); });
+    notify(efd);
+    loop.runOnce(100);
+
+    // HIGH before any I/O, LOW after the NORMAL tasks
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST_F(UDPReceiverTest, NumaPlacementPinsAndPrefaults) {
+    cpu_set_t saved;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(saved), &saved), 0);
+
+    ReceiverConfig config;
+    config.numaNode = 0;
+    config.pinToNode = true;
+    config.prefault = true;
+    config.poolSlots = 128;
+    {
+        UDPReceiver receiver(loop, config);
+        EXPECT_EQ(receiver.numaNode(), 0);
+
+        cpu_set_t pinned;
+        ASSERT_EQ(sched_getaffinity(0, sizeof(pinned), &pinned), 0);
+        EXPECT_GT(CPU_COUNT(&pinned), 0);
+
+        ASSERT_TRUE(receiver.subscribe(TEST_PORT, &handler, &MockPacketHandler::onPacket).has_value());
+        sendLoopback(TEST_PORT, {1, 2, 3});
+        loop.runOnce(100);
+        EXPECT_EQ(handler.receivedPackets.size(), 1u);
+    }
+    ASSERT_EQ(sched_setaffinity(0, sizeof(saved), &saved), 0);
+}
+
+TEST_F(UDPReceiverTest, NumaNodeFromInterface) {
+    // Virtual devices have no PCI parent: placement is left to first touch
+    ReceiverConfig config;
+    config.numaInterface = "lo";
+    UDPReceiver receiver(loop, config);
+    EXPECT_EQ(receiver.numaNode(), -1);
+
+    config.numaInterface.clear();
+    config.numaNode = 1000;
+    EXPECT_THROW(UDPReceiver(loop, config), std::runtime_error);
+}
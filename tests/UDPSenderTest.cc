@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/UDPSender.h>
+#include <atu_reactor/UDPReceiver.h>
+#include <atu_reactor/EventLoop.h>
+
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+using namespace atu_reactor;
+
+namespace {
+
+struct Collector {
+    std::vector<std::string> payloads;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t, struct timespec) {
+        static_cast<Collector*>(context)->payloads.emplace_back(reinterpret_cast<const char*>(data), len);
+    }
+};
+
+} // namespace
+
+class UDPSenderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto res = receiver.subscribe(0, &collector, &Collector::onPacket);
+        ASSERT_TRUE(res.has_value()) << res.error().message();
+
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(static_cast<uint16_t>(res.value()));
+        inet_pton(AF_INET, "127.0.0.1", &dest.sin_addr);
+    }
+
+    Result<void> send(UDPSender& sender, const std::string& payload) {
+        return sender.send(reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest),
+                reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+    }
+
+    void pump(size_t count) {
+        for (int i = 0; i < 50 && collector.payloads.size() < count; ++i) {
+            loop.runOnce(10);
+        }
+    }
+
+    EventLoop loop;
+    UDPReceiver receiver{loop};
+    Collector collector;
+    struct sockaddr_in dest{};
+};
+
+// Datagrams queued outside the loop leave on the next runOnce
+TEST_F(UDPSenderTest, FlushesQueueOnRunOnce) {
+    UDPSender sender(loop);
+
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_TRUE(send(sender, "msg " + std::to_string(i)).has_value());
+    }
+    EXPECT_EQ(sender.pending(), 20u);
+
+    pump(20);
+
+    EXPECT_EQ(sender.pending(), 0u);
+    ASSERT_EQ(collector.payloads.size(), 20u);
+    EXPECT_EQ(collector.payloads[0], "msg 0");
+    EXPECT_EQ(collector.payloads[19], "msg 19");
+}
+
+// A same-destination burst goes out as UDP_SEGMENT super-datagrams
+TEST_F(UDPSenderTest, GsoBurstArrivesAsSeparateDatagrams) {
+    SenderConfig config;
+    config.enableGso = true;
+    UDPSender sender(loop, config);
+
+    for (int i = 0; i < 100; ++i) {
+        std::string payload(100, static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(send(sender, payload).has_value());
+    }
+    ASSERT_TRUE(send(sender, "tail").has_value()); // Shorter last segment
+
+    pump(101);
+
+    ASSERT_EQ(collector.payloads.size(), 101u);
+    EXPECT_EQ(collector.payloads[0], std::string(100, 'a'));
+    EXPECT_EQ(collector.payloads[99], std::string(100, static_cast<char>('a' + 99 % 26)));
+    EXPECT_EQ(collector.payloads[100], "tail");
+    EXPECT_EQ(sender.errors(), 0u);
+}
+
+TEST_F(UDPSenderTest, ReportsFullRing) {
+    SenderConfig config;
+    config.ringSize = 4;
+    UDPSender sender(loop, config);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(send(sender, "x").has_value());
+    }
+
+    auto res = send(sender, "overflow");
+    ASSERT_FALSE(res.has_value());
+    EXPECT_EQ(res.error().value(), ENOBUFS);
+
+    // Explicit flush frees the ring immediately
+    EXPECT_TRUE(sender.flush().has_value());
+    EXPECT_EQ(sender.pending(), 0u);
+    EXPECT_TRUE(send(sender, "again").has_value());
+}
+
+TEST_F(UDPSenderTest, RejectsOversizedDatagram) {
+    SenderConfig config;
+    config.bufferSize = 64;
+    UDPSender sender(loop, config);
+
+    auto res = send(sender, std::string(65, 'X'));
+    ASSERT_FALSE(res.has_value());
+    EXPECT_EQ(res.error().value(), EMSGSIZE);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4
+
+// Launch times are honoured by fq/ETF; without SO_TXTIME they are ignored
+TEST_F(UDPSenderTest, SendsWithLaunchTime) {
+    SenderConfig config;
+    config.enableTxTime = true;
+    UDPSender sender(loop, config);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t launch = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL
+        + static_cast<uint64_t>(now.tv_nsec) + 1000000;
+
+    const std::string payload = "launch";
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(sender.send(reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest),
+                reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), launch).has_value());
+    }
+    EXPECT_TRUE(sender.flush().has_value());
+
+    pump(3);
+    ASSERT_EQ(collector.payloads.size(), 3u);
+    EXPECT_EQ(collector.payloads[0], payload);
+    EXPECT_EQ(sender.errors(), 0u);
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Alfredo Tupone
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atu_reactor/EventLoop.h>
+#include <atu_reactor/XDPReceiver.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "LoopbackSender.h"
+
+using namespace atu_reactor;
+
+namespace {
+
+constexpr uint16_t XDP_PORT = 13100;
+constexpr uint16_t STACK_PORT = 13101;
+
+struct Collector {
+    std::vector<std::string> payloads;
+    std::vector<uint32_t> statuses;
+
+    static void onPacket(void* context, const uint8_t* data, size_t len, uint32_t status, struct timespec) {
+        auto* self = static_cast<Collector*>(context);
+        self->payloads.emplace_back(reinterpret_cast<const char*>(data), len);
+        self->statuses.push_back(status);
+    }
+};
+
+// Missing privileges or kernel support, rather than a receiver bug
+bool unsupported(const std::error_code& ec) {
+    switch (ec.value()) {
+    case EPERM:
+    case EACCES:
+    case EAFNOSUPPORT:
+    case EOPNOTSUPP:
+    case ENOSYS:
+        return true;
+    default:
+        return false;
+    }
+}
+
+XDPConfig genericConfig() {
+    XDPConfig config;
+    config.genericXdp = true;
+    config.bindMode = XDPBindMode::COPY;
+    config.frameCount = 512;
+    config.ringSize = 256;
+    return config;
+}
+
+} // namespace
+
+// --- Bookkeeping (no privileges needed) ---
+
+TEST(XDPReceiverTest, SubscribeBookkeeping) {
+    EventLoop loop;
+    XDPReceiver receiver(loop, genericConfig());
+    Collector collector;
+
+    // Ports can be subscribed before open(): they are loaded with the program
+    auto res = receiver.subscribe(XDP_PORT, &collector, &Collector::onPacket);
+    ASSERT_TRUE(res.has_value()) << res.error().message();
+    EXPECT_EQ(res.value(), XDP_PORT);
+
+    EXPECT_EQ(receiver.subscribe(XDP_PORT, &collector, &Collector::onPacket).error().value(), EADDRINUSE);
+    EXPECT_EQ(receiver.subscribe(0, &collector, &Collector::onPacket).error().value(), EINVAL);
+    EXPECT_EQ(receiver.subscribe(STACK_PORT, &collector, nullptr).error().value(), EINVAL);
+
+    EXPECT_TRUE(receiver.unsubscribe(XDP_PORT).has_value());
+    EXPECT_EQ(receiver.unsubscribe(XDP_PORT).error().value(), ENOENT);
+    EXPECT_EQ(receiver.unsubscribe(STACK_PORT).error().value(), ENOENT);
+
+    // Free again after unsubscribe
+    EXPECT_TRUE(receiver.subscribe(XDP_PORT, &collector, &Collector::onPacket).has_value());
+}
+
+TEST(XDPReceiverTest, OpenRejectsBadConfig) {
+    EventLoop loop;
+
+    XDPConfig badRing = genericConfig();
+    badRing.ringSize = 300;
+    XDPReceiver receiver(loop, badRing);
+    EXPECT_EQ(receiver.open("lo").error().value(), EINVAL);
+
+    XDPConfig fewFrames = genericConfig();
+    fewFrames.frameCount = fewFrames.ringSize / 2;
+    XDPReceiver small(loop, fewFrames);
+    EXPECT_EQ(small.open("lo").error().value(), EINVAL);
+
+    XDPReceiver noInterface(loop, genericConfig());
+    EXPECT_FALSE(noInterface.open("atu-no-such-if").has_value());
+}
+
+// --- Traffic (generic XDP on loopback, needs CAP_NET_ADMIN/CAP_BPF) ---
+
+class XDPReceiverTrafficTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            auto res = receiver.subscribe(XDP_PORT, &collector, &Collector::onPacket);
+            ASSERT_TRUE(res.has_value()) << res.error().message();
+
+            // The kernel releases the queue of the previous test's socket asynchronously
+            auto opened = receiver.open("lo", 0);
+            for (int i = 0; i < 100 && !opened && opened.error().value() == EBUSY; ++i) {
+                ::usleep(10000);
+                opened = receiver.open("lo", 0);
+            }
+            if (!opened && unsupported(opened.error())) {
+                GTEST_SKIP() << "AF_XDP on lo unavailable: " << opened.error().message();
+            }
+            ASSERT_TRUE(opened.has_value()) << opened.error().message();
+        }
+
+        void pump(size_t expected) {
+            for (int i = 0; i < 50 && collector.payloads.size() < expected; ++i) {
+                ASSERT_TRUE(loop.runOnce(10).has_value());
+            }
+        }
+
+        EventLoop loop;
+        XDPReceiver receiver{loop, genericConfig()};
+        Collector collector;
+};
+
+TEST_F(XDPReceiverTrafficTest, DeliversSubscribedPort) {
+    const std::string large(1200, 'x');
+    sendLoopback(XDP_PORT, "first");
+    sendLoopback(XDP_PORT, large);
+    sendLoopback(XDP_PORT, "");
+    pump(3);
+
+    ASSERT_EQ(collector.payloads.size(), 3u);
+    EXPECT_EQ(collector.payloads[0], "first");
+    EXPECT_EQ(collector.payloads[1], large);
+    EXPECT_TRUE(collector.payloads[2].empty());
+    for (uint32_t status : collector.statuses) {
+        EXPECT_EQ(status, PacketStatus::OK);
+    }
+}
+
+TEST_F(XDPReceiverTrafficTest, OtherPortsReachTheStack) {
+    int sock = ::socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(sock, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(STACK_PORT);
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(::bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)), 0);
+
+    sendLoopback(STACK_PORT, "stack");
+    sendLoopback(XDP_PORT, "xdp");
+    pump(1);
+
+    char buf[16];
+    ssize_t n = ::recv(sock, buf, sizeof(buf), MSG_DONTWAIT);
+    ::close(sock);
+    EXPECT_EQ(std::string(buf, n > 0 ? static_cast<size_t>(n) : 0), "stack");
+    EXPECT_EQ(collector.payloads, std::vector<std::string>{"xdp"});
+}
+
+TEST_F(XDPReceiverTrafficTest, UnsubscribedPortIsNoLongerRedirected) {
+    sendLoopback(XDP_PORT, "before");
+    pump(1);
+    ASSERT_EQ(collector.payloads.size(), 1u);
+
+    ASSERT_TRUE(receiver.unsubscribe(XDP_PORT).has_value());
+    sendLoopback(XDP_PORT, "after");
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(loop.runOnce(10).has_value());
+    }
+    EXPECT_EQ(collector.payloads.size(), 1u);
+}
+
+
+// Local Variables: ***
+// mode: C++ ***
+// tab-width: 4 ***
+// c-basic-offset: 4 ***
+// indent-tabs-mode: nil ***
+// End: ***
+// ex: shiftwidth=4 tabstop=4